@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include "core/chord_diagnostics.h"
+#include <array>
+#include <vector>
+
+using namespace kelly;
+
+namespace {
+
+const std::vector<std::vector<uint8_t>>& voicings() {
+    static const std::vector<std::vector<uint8_t>> chords = {
+        {60, 64, 67}, {57, 60, 64}, {64, 67, 72}, {59, 62, 65, 69},
+        {60, 64, 67, 70}, {60, 61, 62}, {48, 55, 64, 71}, {62, 65, 69, 72},
+    };
+    return chords;
+}
+
+} // namespace
+
+static void BM_CalculateDissonance(benchmark::State& state) {
+    const ChordDiagnostics diagnostics;
+    std::vector<Chord> chords;
+    for (const auto& notes : voicings()) {
+        chords.push_back(Chord{notes, "", 0.0f});
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(diagnostics.calculateDissonance(chords[i]));
+        i = (i + 1) % chords.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CalculateDissonance);
+
+static void BM_IdentifyChord(benchmark::State& state) {
+    const ChordDiagnostics diagnostics;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(diagnostics.identifyChord(voicings()[i]));
+        i = (i + 1) % voicings().size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IdentifyChord);
+
+static void BM_AnalyzeChord(benchmark::State& state) {
+    const ChordDiagnostics diagnostics;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(diagnostics.analyzeChord(voicings()[i]));
+        i = (i + 1) % voicings().size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AnalyzeChord);
+
+static void BM_AnalyzeBatch(benchmark::State& state) {
+    const ChordDiagnostics diagnostics;
+    const auto count = static_cast<size_t>(state.range(0));
+    VoicingBuffer buffer(count);
+    for (size_t i = 0; i < count; ++i) {
+        buffer.add(voicings()[i % voicings().size()]);
+    }
+    std::vector<float> dissonance(count);
+    std::vector<ChordId> ids(count);
+    for (auto _ : state) {
+        diagnostics.analyzeBatch(buffer, dissonance, ids);
+        benchmark::DoNotOptimize(dissonance.data());
+        benchmark::DoNotOptimize(ids.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AnalyzeBatch)->Arg(4096);
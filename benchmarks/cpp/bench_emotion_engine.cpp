@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include "core/emotion_engine.h"
+#include "core/emotion_catalog.h"
+#include "core/emotion_model.h"
+#include "core/emotion_trajectory.h"
+#include <memory>
+
+using namespace kelly;
+
+namespace {
+
+const EmotionEngine& engine() {
+    static const EmotionEngine instance;
+    return instance;
+}
+
+} // namespace
+
+static void BM_GetNearbyEmotions(benchmark::State& state) {
+    const float threshold = static_cast<float>(state.range(0)) / 100.0f;
+    int id = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine().getNearbyEmotions(id, threshold));
+        id = (id + 1) % static_cast<int>(EmotionEngine::kEmotionCount);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetNearbyEmotions)->Arg(30)->Arg(60);
+
+static void BM_NearbyEmotionIds(benchmark::State& state) {
+    int id = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine().nearbyEmotionIds(id, 0.3f));
+        id = (id + 1) % static_cast<int>(EmotionEngine::kEmotionCount);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NearbyEmotionIds);
+
+static void BM_FindEmotionByName(benchmark::State& state) {
+    const std::string_view names[] = {"grief", "rage_mid", "serenity_low", "impatience", "unknown"};
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine().findEmotionByName(names[i]));
+        i = (i + 1) % std::size(names);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindEmotionByName);
+
+static void BM_NearestEmotion(benchmark::State& state) {
+    float valence = -1.0f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine().nearestEmotion(valence, 0.5f, 0.6f));
+        valence = valence >= 1.0f ? -1.0f : valence + 0.01f;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NearestEmotion);
+
+static void BM_BuildPathTable(benchmark::State& state) {
+    for (auto _ : state) {
+        auto paths = std::make_unique<EmotionPathTable>(engine());
+        benchmark::DoNotOptimize(paths.get());
+    }
+}
+BENCHMARK(BM_BuildPathTable)->Unit(benchmark::kMillisecond);
+
+// Per-block automation read, as processBlock does it
+static void BM_TrajectoryFrame(benchmark::State& state) {
+    static const EmotionModel model;
+    EmotionTrajectory trajectory;
+    trajectory.build(model.getEngine(), model.getPaths(), emotionIdFromName("grief"), emotionIdFromName("acceptance"));
+    float progress = 0.0f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(trajectory.frameAt(progress));
+        progress = progress >= 1.0f ? 0.0f : progress + 0.001f;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TrajectoryFrame);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "core/intent_processor.h"
+#include <string>
+#include <vector>
+
+using namespace kelly;
+
+namespace {
+
+std::vector<Wound> makeWounds(size_t count) {
+    const char* descriptions[] = {
+        "grief and loss after the funeral",
+        "quiet rage at being ignored again",
+        "a fear that will not leave",
+        "nothing in particular, just tired",
+        "hopeful anticipation of spring",
+    };
+    std::vector<Wound> wounds;
+    wounds.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        wounds.push_back(Wound{descriptions[i % std::size(descriptions)],
+                               static_cast<float>(i % 10) / 10.0f, "benchmark"});
+    }
+    return wounds;
+}
+
+} // namespace
+
+static void BM_ProcessIntent(benchmark::State& state) {
+    IntentProcessor processor;
+    const std::vector<Wound> wounds = makeWounds(64);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(processor.processIntent(wounds[i]));
+        i = (i + 1) % wounds.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProcessIntent);
+
+static void BM_ClassifyWound(benchmark::State& state) {
+    const IntentProcessor processor;
+    const std::vector<Wound> wounds = makeWounds(64);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(processor.classifyWound(wounds[i]));
+        i = (i + 1) % wounds.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ClassifyWound);
+
+// End to end: the CLI's 10k-wound batch
+static void BM_ProcessIntentsBatch(benchmark::State& state) {
+    IntentProcessor processor;
+    const std::vector<Wound> wounds = makeWounds(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(processor.processIntents(wounds));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProcessIntentsBatch)->Arg(10000)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include "core/midi_pipeline.h"
+#include "core/midi_file.h"
+#include <vector>
+
+using namespace kelly;
+
+namespace {
+
+std::vector<MidiNote> makeNotes(size_t count) {
+    std::vector<MidiNote> notes;
+    notes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        notes.push_back(MidiNote{static_cast<uint8_t>(48 + i % 24), static_cast<uint8_t>(60 + i % 60),
+                                 static_cast<uint32_t>(i * 120), 110});
+    }
+    return notes;
+}
+
+} // namespace
+
+static void BM_AddNote(benchmark::State& state) {
+    const std::vector<MidiNote> notes = makeNotes(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        MidiPipeline pipeline;
+        for (const MidiNote& note : notes) {
+            pipeline.addNote(note);
+        }
+        benchmark::DoNotOptimize(pipeline.getNotes().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+// End to end: a 1M-note pipeline build
+BENCHMARK(BM_AddNote)->Arg(1024)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+static void BM_AddNotesBulk(benchmark::State& state) {
+    const std::vector<MidiNote> notes = makeNotes(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        MidiPipeline pipeline;
+        pipeline.addNotes(notes);
+        benchmark::DoNotOptimize(pipeline.getNotes().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AddNotesBulk)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+static void BM_NotesInRange(benchmark::State& state) {
+    MidiPipeline pipeline;
+    pipeline.addNotes(makeNotes(1 << 16));
+    uint32_t tick = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pipeline.notesInRange(tick, tick + 1920));
+        tick = (tick + 1920) % (120u << 16);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NotesInRange);
+
+static void BM_WriteMidiFile(benchmark::State& state) {
+    const std::vector<MidiNote> notes = makeNotes(static_cast<size_t>(state.range(0)));
+    MidiFileWriter writer;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(writer.write(notes, 120).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WriteMidiFile)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include "core/note_columns.h"
+#include <algorithm>
+#include <vector>
+
+using namespace kelly;
+
+namespace {
+
+std::vector<MidiNote> makeNotes(size_t count) {
+    std::vector<MidiNote> notes;
+    notes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        notes.push_back(MidiNote{static_cast<uint8_t>(36 + i % 48), static_cast<uint8_t>(30 + i % 90),
+                                 static_cast<uint32_t>(i * 60), 55});
+    }
+    return notes;
+}
+
+constexpr int64_t kNoteCount = 1 << 20;
+
+} // namespace
+
+// Baseline: the same transpose over the 12-byte struct
+static void BM_TransposeNotes(benchmark::State& state) {
+    std::vector<MidiNote> notes = makeNotes(kNoteCount);
+    int shift = 1;
+    for (auto _ : state) {
+        for (MidiNote& note : notes) {
+            note.note = static_cast<uint8_t>(std::clamp(note.note + shift, 0, 127));
+        }
+        shift = -shift;
+        benchmark::DoNotOptimize(notes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kNoteCount);
+}
+BENCHMARK(BM_TransposeNotes)->Unit(benchmark::kMicrosecond);
+
+static void BM_TransposeColumns(benchmark::State& state) {
+    NoteColumns columns;
+    columns.assign(makeNotes(kNoteCount));
+    int shift = 1;
+    for (auto _ : state) {
+        columns.transpose(shift);
+        shift = -shift;
+        benchmark::DoNotOptimize(columns.pitches().data());
+    }
+    state.SetItemsProcessed(state.iterations() * kNoteCount);
+}
+BENCHMARK(BM_TransposeColumns)->Unit(benchmark::kMicrosecond);
+
+static void BM_VelocityCurveColumns(benchmark::State& state) {
+    NoteColumns columns;
+    columns.assign(makeNotes(kNoteCount));
+    const VelocityCurve curve = makeVelocityCurve(0.7f, 20, 120);
+    for (auto _ : state) {
+        columns.applyVelocityCurve(curve);
+        benchmark::DoNotOptimize(columns.velocities().data());
+    }
+    state.SetItemsProcessed(state.iterations() * kNoteCount);
+}
+BENCHMARK(BM_VelocityCurveColumns)->Unit(benchmark::kMicrosecond);
+
+static void BM_ShiftTimeColumns(benchmark::State& state) {
+    NoteColumns columns;
+    columns.assign(makeNotes(kNoteCount));
+    int64_t shift = 7;
+    for (auto _ : state) {
+        columns.shiftTime(shift);
+        shift = -shift;
+        benchmark::DoNotOptimize(columns.times().data());
+    }
+    state.SetItemsProcessed(state.iterations() * kNoteCount);
+}
+BENCHMARK(BM_ShiftTimeColumns)->Unit(benchmark::kMicrosecond);
+
+static void BM_ColumnsRoundTrip(benchmark::State& state) {
+    const std::vector<MidiNote> notes = makeNotes(kNoteCount);
+    std::vector<MidiNote> out(notes.size());
+    NoteColumns columns;
+    for (auto _ : state) {
+        columns.assign(notes);
+        columns.copyTo(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kNoteCount);
+}
+BENCHMARK(BM_ColumnsRoundTrip)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,22 @@
+#include <benchmark/benchmark.h>
+#include "core/realtime_generator.h"
+#include "core/intent_processor.h"
+#include "core/emotion_catalog.h"
+
+using namespace kelly;
+
+// Simulated processBlock: one generator call per block at 48 kHz, 140 bpm
+static void BM_ProcessBlock(benchmark::State& state) {
+    const int blockSize = static_cast<int>(state.range(0));
+    const IntentProcessor processor;
+    RealtimeGenerator generator(processor);
+    generator.prepare(48000.0, blockSize);
+    generator.setEmotion(emotionIdFromName("rage"));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(generator.process(blockSize, 140.0).data());
+    }
+    state.SetItemsProcessed(state.iterations() * blockSize);
+    state.counters["blockBudgetNs"] = 1e9 * blockSize / 48000.0;
+}
+BENCHMARK(BM_ProcessBlock)->Arg(64)->Arg(128)->Arg(512);
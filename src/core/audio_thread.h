@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+
+namespace kelly {
+
+// Marks the calling thread as the audio thread for the scope's lifetime.
+// Allocation hooks and lock sites report to it through noteAllocation() and
+// noteLock(); with no hooks installed the allocation count stays at zero.
+// Scopes may nest, and each one counts from its own entry.
+class AudioThreadScope {
+public:
+    AudioThreadScope() noexcept
+        : wasActive_(state().active) {
+        State& s = state();
+        if (!wasActive_) {
+            s = State{};
+            s.active = true;
+        }
+        allocationBase_ = s.allocations;
+        lockBase_ = s.locks;
+    }
+    ~AudioThreadScope() { state().active = wasActive_; }
+
+    AudioThreadScope(const AudioThreadScope&) = delete;
+    AudioThreadScope& operator=(const AudioThreadScope&) = delete;
+
+    // Calls on this thread since the scope was entered
+    uint32_t allocationCount() const noexcept { return state().allocations - allocationBase_; }
+    uint32_t lockCount() const noexcept { return state().locks - lockBase_; }
+
+    // AudioSection active at the outermost scope's first allocation or lock,
+    // "processBlock" when none was, or nullptr if nothing was recorded
+    const char* firstAllocationSite() const noexcept { return state().allocationSite; }
+    const char* firstLockSite() const noexcept { return state().lockSite; }
+
+    // Reporting hooks; must not allocate or lock
+    static void noteAllocation() noexcept {
+        State& s = state();
+        if (s.active) {
+            ++s.allocations;
+            if (s.allocationSite == nullptr) {
+                s.allocationSite = currentSite();
+            }
+        }
+    }
+    static void noteLock() noexcept {
+        State& s = state();
+        if (s.active) {
+            ++s.locks;
+            if (s.lockSite == nullptr) {
+                s.lockSite = currentSite();
+            }
+        }
+    }
+    static bool isActive() noexcept { return state().active; }
+
+private:
+    friend class AudioSection;
+
+    struct State {
+        bool active = false;
+        uint32_t allocations = 0;
+        uint32_t locks = 0;
+        const char* site = nullptr;
+        const char* allocationSite = nullptr;
+        const char* lockSite = nullptr;
+    };
+
+    static State& state() noexcept {
+        thread_local State threadState;
+        return threadState;
+    }
+    static const char* currentSite() noexcept {
+        return state().site != nullptr ? state().site : "processBlock";
+    }
+
+    bool wasActive_;
+    uint32_t allocationBase_ = 0;
+    uint32_t lockBase_ = 0;
+};
+
+// Names the audio-thread code path for violation reports; name must outlive
+// the report, e.g. a string literal
+class AudioSection {
+public:
+    explicit AudioSection(const char* name) noexcept
+        : previous_(AudioThreadScope::state().site) {
+        AudioThreadScope::state().site = name;
+    }
+    ~AudioSection() { AudioThreadScope::state().site = previous_; }
+
+    AudioSection(const AudioSection&) = delete;
+    AudioSection& operator=(const AudioSection&) = delete;
+
+private:
+    const char* previous_;
+};
+
+} // namespace kelly
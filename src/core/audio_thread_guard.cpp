@@ -0,0 +1,81 @@
+#include "audio_thread_guard.h"
+#include <algorithm>
+#include <cmath>
+
+namespace kelly {
+
+std::string describeViolation(const AudioViolation& violation) {
+    std::string text = "block " + std::to_string(violation.block) + ": ";
+    switch (violation.type) {
+        case AudioViolationType::Allocation:
+            text += std::to_string(violation.count) + (violation.count == 1 ? " allocation" : " allocations");
+            break;
+        case AudioViolationType::Lock:
+            text += std::to_string(violation.count) + (violation.count == 1 ? " lock" : " locks");
+            break;
+        case AudioViolationType::Deadline:
+            text += std::to_string(std::lround(violation.load * 100.0f)) + "% of deadline";
+            break;
+    }
+    if (violation.site != nullptr) {
+        text += " in ";
+        text += violation.site;
+    }
+    return text;
+}
+
+AudioThreadGuard::Block::Block(AudioThreadGuard& guard, int numSamples) noexcept
+    : guard_(guard),
+      enabled_(guard.isEnabled()),
+      numSamples_(numSamples),
+      start_(enabled_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {
+}
+
+AudioThreadGuard::Block::~Block() {
+    const uint64_t block = guard_.blockCount_.load(std::memory_order_relaxed);
+    guard_.blockCount_.store(block + 1, std::memory_order_relaxed);
+    if (!enabled_) {
+        return;
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    const double budget = numSamples_ / guard_.sampleRate_;
+    const float load = budget > 0.0 ? static_cast<float>(elapsed / budget) : 0.0f;
+
+    if (const uint32_t allocations = thread_.allocationCount(); allocations > 0) {
+        guard_.report(AudioViolation{AudioViolationType::Allocation, allocations, block, load,
+                                     thread_.firstAllocationSite()});
+    }
+    if (const uint32_t locks = thread_.lockCount(); locks > 0) {
+        guard_.report(AudioViolation{AudioViolationType::Lock, locks, block, load, thread_.firstLockSite()});
+    }
+    if (budget > 0.0 && load > guard_.getDeadlineFraction()) {
+        guard_.report(AudioViolation{AudioViolationType::Deadline, 0, block, load, nullptr});
+    }
+}
+
+void AudioThreadGuard::prepare(double sampleRate) {
+    sampleRate_ = sampleRate > 0.0 ? sampleRate : 44100.0;
+    blockCount_.store(0, std::memory_order_relaxed);
+}
+
+void AudioThreadGuard::setDeadlineFraction(float fraction) {
+    deadlineFraction_.store(std::clamp(fraction, 0.0f, 1.0f), std::memory_order_relaxed);
+}
+
+void AudioThreadGuard::report(const AudioViolation& violation) noexcept {
+    violationCount_.fetch_add(1, std::memory_order_relaxed);
+    if (!violations_.tryPush(violation)) {
+        droppedCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t AudioThreadGuard::drain(std::span<AudioViolation> out) {
+    size_t count = 0;
+    while (count < out.size() && violations_.tryPop(out[count])) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace kelly
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include "audio_thread.h"
+#include "spsc_ring.h"
+
+namespace kelly {
+
+enum class AudioViolationType : uint8_t {
+    Allocation,
+    Lock,
+    Deadline
+};
+
+struct AudioViolation {
+    AudioViolationType type = AudioViolationType::Deadline;
+    uint32_t count = 0;           // allocations or locks in the block, 0 for deadlines
+    uint64_t block = 0;           // blocks since prepare()
+    float load = 0.0f;            // block time / (samples / sampleRate)
+    const char* site = nullptr;   // AudioSection of the first offending call; null for deadlines
+};
+
+// e.g. "block 812: 3 allocations in generate", "block 90: 104% of deadline"
+std::string describeViolation(const AudioViolation& violation);
+
+// Watches processBlock for heap allocations, lock acquisitions and
+// overruns of deadlineFraction × the block's duration. Each offending block
+// pushes its violations onto a wait-free SPSC ring that the message thread
+// drains. When the ring is full, new violations are counted and
+// dropped. Allocations are only seen when the host binary installs the
+// global allocation hooks; locks only at sites that call
+// AudioThreadScope::noteLock().
+class AudioThreadGuard {
+public:
+    static constexpr size_t kViolationCapacity = 256;
+    static constexpr float kDefaultDeadlineFraction = 0.75f;
+
+    // One processBlock call; construct it first so it spans the whole callback
+    class Block {
+    public:
+        ~Block();
+
+        Block(const Block&) = delete;
+        Block& operator=(const Block&) = delete;
+
+    private:
+        friend class AudioThreadGuard;
+        Block(AudioThreadGuard& guard, int numSamples) noexcept;
+
+        AudioThreadGuard& guard_;
+        AudioThreadScope thread_;
+        bool enabled_;
+        int numSamples_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    AudioThreadGuard() = default;
+
+    // Resets block numbering; call from prepareToPlay
+    void prepare(double sampleRate);
+
+    // Any thread; take effect from the next block
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void setDeadlineFraction(float fraction);
+    float getDeadlineFraction() const { return deadlineFraction_.load(std::memory_order_relaxed); }
+
+    // Audio thread
+    [[nodiscard]] Block monitorBlock(int numSamples) noexcept { return Block(*this, numSamples); }
+
+    // Message thread: pops up to out.size() violations, oldest first
+    size_t drain(std::span<AudioViolation> out);
+
+    uint64_t getBlockCount() const { return blockCount_.load(std::memory_order_relaxed); }
+    uint64_t getViolationCount() const { return violationCount_.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return droppedCount_.load(std::memory_order_relaxed); }
+
+private:
+    void report(const AudioViolation& violation) noexcept;
+
+    std::atomic<bool> enabled_{true};
+    std::atomic<float> deadlineFraction_{kDefaultDeadlineFraction};
+    double sampleRate_ = 44100.0;
+
+    std::atomic<uint64_t> blockCount_{0};
+    std::atomic<uint64_t> violationCount_{0};
+    std::atomic<uint64_t> droppedCount_{0};
+    SpscRing<AudioViolation, kViolationCapacity> violations_;
+};
+
+} // namespace kelly
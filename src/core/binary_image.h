@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace kelly {
+
+// Helpers shared by the read-in-place binary formats (.kemg, .kmdc).
+// Sections are 4-byte aligned so a mapped image can be read without copies.
+
+constexpr uint32_t alignImageOffset(uint32_t offset) {
+    return (offset + 3u) & ~3u;
+}
+
+// [offset, offset + count * elementSize) is aligned and lies inside the image
+constexpr bool imageSectionFits(uint32_t offset, uint64_t count, uint64_t elementSize, uint64_t imageSize) {
+    return offset % 4 == 0 && offset + count * elementSize <= imageSize;
+}
+
+template <typename T>
+const T* imageSection(std::span<const std::byte> image, uint32_t offset) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return reinterpret_cast<const T*>(image.data() + offset);
+}
+
+// Lays out a header followed by aligned sections
+template <typename Header>
+class BinaryImageWriter {
+public:
+    static_assert(std::is_trivially_copyable_v<Header>);
+
+    BinaryImageWriter() : image_(alignImageOffset(sizeof(Header))) {}
+
+    // Returns the section's offset
+    template <typename T>
+    uint32_t append(std::span<const T> items) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto offset = static_cast<uint32_t>(image_.size());
+        image_.resize(alignImageOffset(static_cast<uint32_t>(offset + items.size_bytes())));
+        if (!items.empty()) {
+            std::memcpy(image_.data() + offset, items.data(), items.size_bytes());
+        }
+        return offset;
+    }
+
+    uint32_t size() const { return static_cast<uint32_t>(image_.size()); }
+
+    std::vector<std::byte> finish(const Header& header) {
+        std::memcpy(image_.data(), &header, sizeof(Header));
+        return std::move(image_);
+    }
+
+private:
+    std::vector<std::byte> image_;
+};
+
+} // namespace kelly
@@ -1,82 +1,336 @@
 #include "chord_diagnostics.h"
+#include "profiling.h"
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 
 namespace kelly {
 
+namespace {
+
+// Simplified dissonance ratings for intervals (semitones mod 12)
+constexpr std::array<float, 12> kIntervalDissonance = {
+    0.0f,  // unison
+    0.8f,  // minor 2nd
+    0.4f,  // major 2nd
+    0.5f,  // minor 3rd
+    0.3f,  // major 3rd
+    0.2f,  // perfect 4th
+    0.9f,  // tritone
+    0.1f,  // perfect 5th
+    0.4f,  // minor 6th
+    0.3f,  // major 6th
+    0.5f,  // minor 7th
+    0.4f   // major 7th
+};
+
+constexpr PitchClassSet kAllPitchClasses = 0xFFF;
+constexpr size_t kPitchClassSetCount = 4096;
+
+// Rotates the set so pitch class n lands on bit 0
+constexpr PitchClassSet rotateDown(PitchClassSet set, int n) {
+    n %= 12;
+    return static_cast<PitchClassSet>(((set >> n) | (set << (12 - n))) & kAllPitchClasses);
+}
+
+constexpr PitchClassSet rotateUp(PitchClassSet set, int n) {
+    return rotateDown(set, 12 - n % 12);
+}
+
+template <typename... Intervals>
+constexpr PitchClassSet bits(Intervals... intervals) {
+    return static_cast<PitchClassSet>(((1u << intervals) | ...));
+}
+
+struct ChordTemplate {
+    ChordQuality quality;
+    PitchClassSet intervals;  // relative to the root
+};
+
+// Earlier entries win when one set has several readings
+constexpr std::array<ChordTemplate, 12> kChordTemplates = {{
+    {ChordQuality::Major, bits(0, 4, 7)},
+    {ChordQuality::Minor, bits(0, 3, 7)},
+    {ChordQuality::Dominant7, bits(0, 4, 7, 10)},
+    {ChordQuality::Major7, bits(0, 4, 7, 11)},
+    {ChordQuality::Minor7, bits(0, 3, 7, 10)},
+    {ChordQuality::HalfDiminished7, bits(0, 3, 6, 10)},
+    {ChordQuality::Diminished7, bits(0, 3, 6, 9)},
+    {ChordQuality::MinorMajor7, bits(0, 3, 7, 11)},
+    {ChordQuality::Diminished, bits(0, 3, 6)},
+    {ChordQuality::Augmented, bits(0, 4, 8)},
+    {ChordQuality::Sus4, bits(0, 5, 7)},
+    {ChordQuality::Sus2, bits(0, 2, 7)},
+}};
+
+struct ChordEntry {
+    ChordQuality quality = ChordQuality::Unknown;
+    uint8_t root = 0;
+};
+
+// Every transposition of every template, indexed by pitch-class set
+constexpr auto kChordTable = [] {
+    std::array<ChordEntry, kPitchClassSetCount> table{};
+    for (const auto& tmpl : kChordTemplates) {
+        for (int root = 0; root < 12; ++root) {
+            ChordEntry& entry = table[rotateUp(tmpl.intervals, root)];
+            if (entry.quality == ChordQuality::Unknown) {
+                entry = ChordEntry{tmpl.quality, static_cast<uint8_t>(root)};
+            }
+        }
+    }
+    return table;
+}();
+
+// Templates only, indexed by the set rotated to a candidate root
+constexpr auto kRootPositionTable = [] {
+    std::array<ChordQuality, kPitchClassSetCount> table{};
+    for (const auto& tmpl : kChordTemplates) {
+        if (table[tmpl.intervals] == ChordQuality::Unknown) {
+            table[tmpl.intervals] = tmpl.quality;
+        }
+    }
+    return table;
+}();
+
+// Interval classes fold an interval with its inversion (e.g. 5ths with 4ths)
+constexpr float intervalClassDissonance(int intervalClass) {
+    return intervalClass == 6
+        ? kIntervalDissonance[6]
+        : (kIntervalDissonance[intervalClass] + kIntervalDissonance[12 - intervalClass]) * 0.5f;
+}
+
+// Mean interval-class dissonance per set, from its interval vector:
+// popcount(set & rotate(set, k)) counts the pairs k semitones apart.
+constexpr auto kDissonanceTable = [] {
+    std::array<float, kPitchClassSetCount> table{};
+    for (size_t s = 0; s < kPitchClassSetCount; ++s) {
+        const auto set = static_cast<PitchClassSet>(s);
+        const int size = std::popcount(set);
+        const int pairs = size * (size - 1) / 2;
+        if (pairs == 0) continue;
+
+        float total = 0.0f;
+        for (int k = 1; k <= 6; ++k) {
+            int count = std::popcount(static_cast<PitchClassSet>(set & rotateUp(set, k)));
+            if (k == 6) count /= 2;  // a tritone pair is found in both directions
+            total += static_cast<float>(count) * intervalClassDissonance(k);
+        }
+        table[s] = total / static_cast<float>(pairs);
+    }
+    return table;
+}();
+
+constexpr std::array<std::string_view, 12> kPitchClassNames = {
+    "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+};
+
+constexpr std::array<std::string_view, static_cast<size_t>(ChordQuality::Count)> kQualityNames = {
+    "unknown", "major", "minor", "diminished", "augmented", "sus2", "sus4",
+    "major7", "minor7", "dominant7", "half-diminished7", "diminished7", "minor-major7"
+};
+
+} // namespace
+
 float ChordDiagnostics::intervalDissonance(int interval) const {
-    // Simplified dissonance ratings for intervals (semitones mod 12)
-    static const float dissonanceMap[12] = {
-        0.0f,  // unison
-        0.8f,  // minor 2nd
-        0.4f,  // major 2nd
-        0.5f,  // minor 3rd
-        0.3f,  // major 3rd
-        0.2f,  // perfect 4th
-        0.9f,  // tritone
-        0.1f,  // perfect 5th
-        0.4f,  // minor 6th
-        0.3f,  // major 6th
-        0.5f,  // minor 7th
-        0.4f   // major 7th
-    };
-    
     int normInterval = std::abs(interval) % 12;
-    return dissonanceMap[normInterval];
+    return kIntervalDissonance[normInterval];
+}
+
+PitchClassSet ChordDiagnostics::toPitchClassSet(std::span<const uint8_t> notes) {
+    PitchClassSet set = 0;
+    for (uint8_t note : notes) {
+        set |= static_cast<PitchClassSet>(1u << (note % 12));
+    }
+    return set;
+}
+
+float ChordDiagnostics::pitchClassDissonance(PitchClassSet pitchClasses) {
+    return kDissonanceTable[pitchClasses & kAllPitchClasses];
+}
+
+std::string_view ChordDiagnostics::qualityName(ChordQuality quality) {
+    const auto index = static_cast<size_t>(quality);
+    return index < kQualityNames.size() ? kQualityNames[index] : kQualityNames[0];
+}
+
+std::string_view ChordDiagnostics::pitchClassName(uint8_t pitchClass) {
+    return kPitchClassNames[pitchClass % 12];
 }
 
 float ChordDiagnostics::calculateDissonance(const Chord& chord) const {
-    if (chord.notes.size() < 2) {
+    KELLY_ZONE();
+    return pitchClassDissonance(toPitchClassSet(chord.notes));
+}
+
+float ChordDiagnostics::voicingDissonance(std::span<const uint8_t> notes) const {
+    KELLY_ZONE();
+    if (notes.size() < 2) {
         return 0.0f;
     }
-    
+
     float totalDissonance = 0.0f;
     int pairCount = 0;
-    
-    for (size_t i = 0; i < chord.notes.size(); ++i) {
-        for (size_t j = i + 1; j < chord.notes.size(); ++j) {
-            int interval = chord.notes[j] - chord.notes[i];
+
+    for (size_t i = 0; i < notes.size(); ++i) {
+        for (size_t j = i + 1; j < notes.size(); ++j) {
+            int interval = notes[j] - notes[i];
             totalDissonance += intervalDissonance(interval);
             pairCount++;
         }
     }
-    
+
     return pairCount > 0 ? totalDissonance / pairCount : 0.0f;
 }
 
-std::string ChordDiagnostics::identifyChord(const std::vector<uint8_t>& notes) const {
+ChordInfo ChordDiagnostics::analyzePitchClasses(PitchClassSet pitchClasses, uint8_t bass) {
+    ChordInfo info;
+    info.pitchClasses = pitchClasses & kAllPitchClasses;
+    info.bass = bass % 12;
+
+    // Prefer the reading rooted on the bass, then fall back to an inversion
+    if (ChordQuality rooted = kRootPositionTable[rotateDown(info.pitchClasses, info.bass)];
+        rooted != ChordQuality::Unknown) {
+        info.quality = rooted;
+        info.root = info.bass;
+        return info;
+    }
+
+    const ChordEntry& entry = kChordTable[info.pitchClasses];
+    if (entry.quality == ChordQuality::Unknown) {
+        return info;
+    }
+
+    info.quality = entry.quality;
+    info.root = entry.root;
+    const int bassInterval = (info.bass - info.root + 12) % 12;
+    const auto belowBass = static_cast<PitchClassSet>((1u << bassInterval) - 1);
+    info.inversion = static_cast<uint8_t>(std::popcount(
+        static_cast<PitchClassSet>(rotateDown(info.pitchClasses, info.root) & belowBass)));
+    return info;
+}
+
+ChordInfo ChordDiagnostics::analyzeChord(std::span<const uint8_t> notes) const {
+    KELLY_ZONE();
+    if (notes.empty()) {
+        return {};
+    }
+    return analyzePitchClasses(toPitchClassSet(notes), *std::min_element(notes.begin(), notes.end()));
+}
+
+std::string ChordDiagnostics::chordName(const ChordInfo& info) const {
+    if (info.quality == ChordQuality::Unknown) {
+        return std::string(qualityName(info.quality));
+    }
+
+    std::string name;
+    name += pitchClassName(info.root);
+    name += ' ';
+    name += qualityName(info.quality);
+    if (info.inversion > 0) {
+        name += '/';
+        name += pitchClassName(info.bass);
+    }
+    return name;
+}
+
+std::string ChordDiagnostics::identifyChord(std::span<const uint8_t> notes) const {
+    KELLY_ZONE();
     if (notes.size() < 3) {
         return "incomplete";
     }
-    
-    // Simple chord identification (would be more sophisticated in full implementation)
-    std::vector<uint8_t> sortedNotes = notes;
-    std::sort(sortedNotes.begin(), sortedNotes.end());
-    
-    int root = sortedNotes[0] % 12;
-    std::vector<int> intervals;
-    for (size_t i = 1; i < sortedNotes.size(); ++i) {
-        intervals.push_back((sortedNotes[i] - sortedNotes[0]) % 12);
-    }
-    
-    // Check for common triads
-    if (intervals.size() >= 2) {
-        if (intervals[0] == 4 && intervals[1] == 7) {
-            return "major";
-        } else if (intervals[0] == 3 && intervals[1] == 7) {
-            return "minor";
-        } else if (intervals[0] == 3 && intervals[1] == 6) {
-            return "diminished";
-        } else if (intervals[0] == 4 && intervals[1] == 8) {
-            return "augmented";
-        }
-    }
-    
-    return "unknown";
+    return std::string(qualityName(analyzeChord(notes).quality));
 }
 
 bool ChordDiagnostics::isConsonant(const Chord& chord, float threshold) const {
     return calculateDissonance(chord) < threshold;
 }
 
+void VoicingBuffer::reserve(size_t capacity) {
+    if (capacity <= capacity_) {
+        return;
+    }
+
+    // Rows are capacity-strided, so growing re-lays every voice row
+    std::vector<uint8_t> notes(kMaxVoices * capacity);
+    for (size_t v = 0; v < kMaxVoices; ++v) {
+        std::copy_n(voice(v), size_, notes.data() + v * capacity);
+    }
+    notes_ = std::move(notes);
+    counts_.resize(capacity);
+    capacity_ = capacity;
+}
+
+void VoicingBuffer::add(std::span<const uint8_t> notes) {
+    if (size_ == capacity_) {
+        reserve(std::max<size_t>(capacity_ * 2, 64));
+    }
+
+    const size_t count = std::min(notes.size(), kMaxVoices);
+    const uint8_t lowest = count ? *std::min_element(notes.begin(), notes.begin() + count) : 0;
+    for (size_t v = 0; v < kMaxVoices; ++v) {
+        notes_[v * capacity_ + size_] = v < count ? notes[v] : lowest;
+    }
+    counts_[size_] = static_cast<uint8_t>(count);
+    ++size_;
+}
+
+namespace {
+
+// Voicings processed per chunk. The per-voice inner loops run across this many
+// lanes with no branches, which compilers turn into SSE/AVX2/NEON code; the
+// final table lookups stay scalar (a gather from 16 KB of L1-resident tables).
+constexpr size_t kBatchLanes = 32;
+
+template <typename Emit>
+void forEachVoicingSet(const VoicingBuffer& voicings, Emit&& emit) {
+    std::array<PitchClassSet, kBatchLanes> sets;
+    std::array<uint8_t, kBatchLanes> bass;
+
+    for (size_t base = 0; base < voicings.size(); base += kBatchLanes) {
+        const size_t lanes = std::min(kBatchLanes, voicings.size() - base);
+        sets.fill(0);
+        bass.fill(127);
+
+        for (size_t v = 0; v < VoicingBuffer::kMaxVoices; ++v) {
+            const uint8_t* row = voicings.voice(v) + base;
+            for (size_t i = 0; i < lanes; ++i) {
+                const uint8_t note = row[i];
+                sets[i] = static_cast<PitchClassSet>(sets[i] | (1u << (note % 12)));
+                bass[i] = std::min(bass[i], note);
+            }
+        }
+
+        for (size_t i = 0; i < lanes; ++i) {
+            const bool empty = voicings.voiceCount(base + i) == 0;
+            emit(base + i, empty ? PitchClassSet{0} : sets[i], bass[i]);
+        }
+    }
+}
+
+} // namespace
+
+void ChordDiagnostics::analyzeBatch(const VoicingBuffer& voicings, std::span<float> dissonance,
+                                    std::span<ChordId> chordIds) const {
+    KELLY_ZONE();
+    const size_t count = std::min({voicings.size(), dissonance.size(), chordIds.size()});
+    forEachVoicingSet(voicings, [&](size_t i, PitchClassSet set, uint8_t bass) {
+        if (i >= count) return;
+        dissonance[i] = kDissonanceTable[set];
+        const ChordInfo info = analyzePitchClasses(set, bass);
+        chordIds[i] = makeChordId(info.quality, info.root);
+    });
+}
+
+void ChordDiagnostics::consonantMask(const VoicingBuffer& voicings, float threshold,
+                                     std::span<uint8_t> mask) const {
+    KELLY_ZONE();
+    const size_t count = std::min(voicings.size(), mask.size());
+    forEachVoicingSet(voicings, [&](size_t i, PitchClassSet set, uint8_t) {
+        if (i >= count) return;
+        mask[i] = kDissonanceTable[set] < threshold ? 1 : 0;
+    });
+}
+
 } // namespace kelly
@@ -2,10 +2,85 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <span>
 #include <cstdint>
 
 namespace kelly {
 
+// 12-bit mask, bit n set when pitch class n (C = 0) is present
+using PitchClassSet = uint16_t;
+
+enum class ChordQuality : uint8_t {
+    Unknown,
+    Major,
+    Minor,
+    Diminished,
+    Augmented,
+    Sus2,
+    Sus4,
+    Major7,
+    Minor7,
+    Dominant7,
+    HalfDiminished7,
+    Diminished7,
+    MinorMajor7,
+    Count
+};
+
+struct ChordInfo {
+    ChordQuality quality = ChordQuality::Unknown;
+    uint8_t root = 0;       // pitch class
+    uint8_t bass = 0;       // pitch class of the lowest note
+    uint8_t inversion = 0;  // 0 = root position, 1 = first, ...
+    PitchClassSet pitchClasses = 0;
+};
+
+// Compact (quality, root) handle: 0 = unknown, else 1 + (quality - 1) * 12 + root
+using ChordId = uint8_t;
+
+constexpr ChordId makeChordId(ChordQuality quality, uint8_t root) {
+    return quality == ChordQuality::Unknown
+        ? 0
+        : static_cast<ChordId>(1 + (static_cast<int>(quality) - 1) * 12 + root % 12);
+}
+
+constexpr ChordQuality chordIdQuality(ChordId id) {
+    return id == 0 ? ChordQuality::Unknown : static_cast<ChordQuality>(1 + (id - 1) / 12);
+}
+
+constexpr uint8_t chordIdRoot(ChordId id) {
+    return id == 0 ? 0 : static_cast<uint8_t>((id - 1) % 12);
+}
+
+// Packed struct-of-arrays store for many voicings of up to kMaxVoices notes.
+// Voice v of voicing i lives at voice(v)[i]. Unused voices repeat the
+// voicing's lowest note, which leaves its pitch-class set and bass unchanged,
+// so batch kernels run without per-lane voice-count checks.
+class VoicingBuffer {
+public:
+    static constexpr size_t kMaxVoices = 8;
+
+    VoicingBuffer() = default;
+    explicit VoicingBuffer(size_t capacity) { reserve(capacity); }
+
+    void reserve(size_t capacity);
+    // Voices past kMaxVoices are dropped
+    void add(std::span<const uint8_t> notes);
+    void clear() { size_ = 0; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    uint8_t voiceCount(size_t i) const { return counts_[i]; }
+    const uint8_t* voice(size_t v) const { return notes_.data() + v * capacity_; }
+
+private:
+    std::vector<uint8_t> notes_;  // kMaxVoices rows of capacity_ notes
+    std::vector<uint8_t> counts_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
 struct Chord {
     std::vector<uint8_t> notes;
     std::string name;
@@ -17,10 +92,33 @@ public:
     ChordDiagnostics() = default;
     ~ChordDiagnostics() = default;
 
+    // Interval-class dissonance of the chord's pitch-class set, 0.0 to 1.0
     float calculateDissonance(const Chord& chord) const;
-    std::string identifyChord(const std::vector<uint8_t>& notes) const;
+    std::string identifyChord(std::span<const uint8_t> notes) const;
     bool isConsonant(const Chord& chord, float threshold = 0.3f) const;
 
+    // Table-driven analysis: one pass to build the set, then constant-time lookups
+    ChordInfo analyzeChord(std::span<const uint8_t> notes) const;
+    std::string chordName(const ChordInfo& info) const;  // e.g. "C major", "C major/E"
+
+    // Pairwise dissonance of the actual voicing, octave placement included
+    float voicingDissonance(std::span<const uint8_t> notes) const;
+
+    // Batch variants over a VoicingBuffer; outputs must hold voicings.size() entries.
+    // Scores match calculateDissonance and IDs match analyzeChord per voicing.
+    void analyzeBatch(const VoicingBuffer& voicings, std::span<float> dissonance,
+                      std::span<ChordId> chordIds) const;
+    // mask[i] = 1 when voicing i would pass isConsonant(threshold), else 0
+    void consonantMask(const VoicingBuffer& voicings, float threshold, std::span<uint8_t> mask) const;
+
+    // Constant time: classifies a pitch-class set given the bass pitch class
+    static ChordInfo analyzePitchClasses(PitchClassSet pitchClasses, uint8_t bass);
+
+    static PitchClassSet toPitchClassSet(std::span<const uint8_t> notes);
+    static float pitchClassDissonance(PitchClassSet pitchClasses);
+    static std::string_view qualityName(ChordQuality quality);
+    static std::string_view pitchClassName(uint8_t pitchClass);
+
 private:
     float intervalDissonance(int interval) const;
 };
@@ -0,0 +1,108 @@
+#include "chord_tracker.h"
+#include <bit>
+#include <limits>
+
+namespace kelly {
+
+namespace {
+
+// Snapshot packing: [0,12) pitch classes, [12,19) bass, [19,27) chord ID, [32,48) dissonance
+constexpr uint64_t pack(PitchClassSet set, int bass, ChordId id, float dissonance) {
+    const auto quantized = static_cast<uint64_t>(dissonance * 65535.0f + 0.5f);
+    return static_cast<uint64_t>(set) |
+           (static_cast<uint64_t>(bass & 0x7F) << 12) |
+           (static_cast<uint64_t>(id) << 19) |
+           (quantized << 32);
+}
+
+} // namespace
+
+void ChordTracker::noteOn(uint8_t note) {
+    note &= 0x7F;
+    uint16_t& count = noteCounts_[note];
+    if (count > 0) {
+        if (count < std::numeric_limits<uint16_t>::max()) {
+            ++count;
+        }
+        return;  // already sounding; the set and bass are unchanged
+    }
+    count = 1;
+
+    heldMask_[note >> 6] |= uint64_t{1} << (note & 63);
+    ++heldCount_;
+    if (pitchClassCounts_[note % 12]++ == 0) {
+        pitchClasses_ = static_cast<PitchClassSet>(pitchClasses_ | (1u << (note % 12)));
+    }
+    update();
+}
+
+void ChordTracker::noteOff(uint8_t note) {
+    note &= 0x7F;
+    if (noteCounts_[note] == 0 || --noteCounts_[note] > 0) {
+        return;
+    }
+
+    heldMask_[note >> 6] &= ~(uint64_t{1} << (note & 63));
+    --heldCount_;
+    if (--pitchClassCounts_[note % 12] == 0) {
+        pitchClasses_ = static_cast<PitchClassSet>(pitchClasses_ & ~(1u << (note % 12)));
+    }
+    update();
+}
+
+void ChordTracker::reset() {
+    noteCounts_.fill(0);
+    pitchClassCounts_.fill(0);
+    heldMask_.fill(0);
+    pitchClasses_ = 0;
+    heldCount_ = 0;
+    update();
+}
+
+void ChordTracker::handleMidiMessage(std::span<const uint8_t> bytes) {
+    if (bytes.empty()) {
+        return;
+    }
+
+    const uint8_t status = bytes[0] & 0xF0;
+    if (status == 0x90 && bytes.size() >= 3) {
+        bytes[2] > 0 ? noteOn(bytes[1]) : noteOff(bytes[1]);
+    } else if (status == 0x80 && bytes.size() >= 2) {
+        noteOff(bytes[1]);
+    } else if (status == 0xB0 && bytes.size() >= 2 && (bytes[1] == 120 || bytes[1] == 123)) {
+        reset();
+    }
+}
+
+int ChordTracker::lowestHeldNote() const {
+    if (heldMask_[0] != 0) {
+        return std::countr_zero(heldMask_[0]);
+    }
+    if (heldMask_[1] != 0) {
+        return 64 + std::countr_zero(heldMask_[1]);
+    }
+    return -1;
+}
+
+void ChordTracker::update() {
+    bass_ = lowestHeldNote();
+    chord_ = bass_ >= 0 ? ChordDiagnostics::analyzePitchClasses(pitchClasses_, static_cast<uint8_t>(bass_))
+                        : ChordInfo{};
+    dissonance_ = ChordDiagnostics::pitchClassDissonance(pitchClasses_);
+
+    published_.store(pack(pitchClasses_, bass_ >= 0 ? bass_ : 0, makeChordId(chord_.quality, chord_.root),
+                          dissonance_),
+                     std::memory_order_release);
+}
+
+ChordSnapshot ChordTracker::snapshot() const {
+    const uint64_t packed = published_.load(std::memory_order_acquire);
+    ChordSnapshot snap;
+    snap.pitchClasses = static_cast<PitchClassSet>(packed & 0xFFF);
+    snap.bassNote = static_cast<uint8_t>((packed >> 12) & 0x7F);
+    snap.chordId = static_cast<ChordId>((packed >> 19) & 0xFF);
+    snap.dissonance = static_cast<float>((packed >> 32) & 0xFFFF) / 65535.0f;
+    return snap;
+}
+
+} // namespace kelly
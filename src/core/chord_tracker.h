@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include "chord_diagnostics.h"
+
+namespace kelly {
+
+struct ChordSnapshot {
+    ChordId chordId = 0;
+    PitchClassSet pitchClasses = 0;
+    uint8_t bassNote = 0;     // lowest held MIDI note, valid when pitchClasses != 0
+    float dissonance = 0.0f;  // quantized to 1/65535
+};
+
+// Streaming chord recognizer for live note-on/off input.
+// Keeps per-note and per-pitch-class hold counts plus a 128-bit held-note
+// mask, so each event is O(1): the bass is a count-trailing-zeros and the
+// chord is a ChordDiagnostics table lookup. No allocation, no locks.
+// Events must come from one thread; snapshot() may be read from any thread.
+class ChordTracker {
+public:
+    ChordTracker() = default;
+    ~ChordTracker() = default;
+
+    void noteOn(uint8_t note);
+    void noteOff(uint8_t note);
+    void reset();
+
+    // Raw MIDI bytes: note-on, note-off and all-notes-off/all-sound-off are handled
+    void handleMidiMessage(std::span<const uint8_t> bytes);
+
+    // Audio-thread view, always current
+    const ChordInfo& getChord() const { return chord_; }
+    float getDissonance() const { return dissonance_; }
+    PitchClassSet getPitchClasses() const { return pitchClasses_; }
+    int getHeldNoteCount() const { return heldCount_; }
+
+    // Lock-free copy published after each change
+    ChordSnapshot snapshot() const;
+
+private:
+    void update();
+    int lowestHeldNote() const;
+
+    std::array<uint16_t, 128> noteCounts_{};  // saturating: a stream of unmatched note-ons never wraps
+    std::array<uint16_t, 12> pitchClassCounts_{};
+    std::array<uint64_t, 2> heldMask_{};
+    PitchClassSet pitchClasses_ = 0;
+    int heldCount_ = 0;
+    int bass_ = -1;
+
+    ChordInfo chord_;
+    float dissonance_ = 0.0f;
+
+    std::atomic<uint64_t> published_{0};
+};
+
+} // namespace kelly
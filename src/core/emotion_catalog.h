@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <cstddef>
+
+namespace kelly {
+
+// Compile-time source of truth for the 216-node emotion model.
+// Node IDs are laid out as category × variant × intensity level, in the
+// order below, so any name can be resolved to its ID at compile time.
+
+struct EmotionVariant {
+    std::string_view name;
+    float valence;
+    float arousal;
+};
+
+inline constexpr size_t kEmotionCategoryCount = 8;
+inline constexpr size_t kVariantsPerCategory = 9;
+inline constexpr size_t kIntensityLevelCount = 3;
+
+inline constexpr std::array<float, kIntensityLevelCount> kIntensityLevels = {1.0f, 0.6f, 0.3f};
+inline constexpr std::array<std::string_view, kIntensityLevelCount> kIntensitySuffixes = {"", "_mid", "_low"};
+
+// Rows follow the EmotionCategory enum order
+inline constexpr std::array<std::array<EmotionVariant, kVariantsPerCategory>, kEmotionCategoryCount> kEmotionVariants = {{
+    {{  // Joy
+        {"euphoria", 1.0f, 1.0f}, {"ecstasy", 0.95f, 0.95f}, {"elation", 0.85f, 0.9f},
+        {"delight", 0.8f, 0.7f}, {"happiness", 0.7f, 0.6f}, {"contentment", 0.7f, 0.3f},
+        {"serenity", 0.6f, 0.2f}, {"satisfaction", 0.5f, 0.4f}, {"cheerfulness", 0.6f, 0.5f}
+    }},
+    {{  // Sadness
+        {"grief", -0.9f, 0.7f}, {"despair", -0.95f, 0.6f}, {"sorrow", -0.8f, 0.5f},
+        {"melancholy", -0.6f, 0.3f}, {"gloom", -0.5f, 0.4f}, {"disappointment", -0.4f, 0.3f},
+        {"loneliness", -0.6f, 0.2f}, {"nostalgia", -0.3f, 0.2f}, {"wistfulness", -0.2f, 0.15f}
+    }},
+    {{  // Anger
+        {"rage", -0.8f, 1.0f}, {"fury", -0.85f, 0.95f}, {"wrath", -0.75f, 0.9f},
+        {"hostility", -0.6f, 0.7f}, {"resentment", -0.5f, 0.5f}, {"annoyance", -0.4f, 0.5f},
+        {"irritation", -0.35f, 0.45f}, {"frustration", -0.45f, 0.55f}, {"bitterness", -0.5f, 0.4f}
+    }},
+    {{  // Fear
+        {"terror", -0.9f, 1.0f}, {"panic", -0.85f, 0.95f}, {"horror", -0.8f, 0.9f},
+        {"dread", -0.7f, 0.7f}, {"anxiety", -0.5f, 0.8f}, {"worry", -0.4f, 0.6f},
+        {"unease", -0.3f, 0.5f}, {"apprehension", -0.35f, 0.55f}, {"nervousness", -0.3f, 0.65f}
+    }},
+    {{  // Surprise
+        {"amazement", 0.6f, 0.95f}, {"astonishment", 0.5f, 0.9f}, {"awe", 0.4f, 0.7f},
+        {"wonder", 0.5f, 0.6f}, {"shock", -0.1f, 0.9f}, {"startle", 0.0f, 0.85f},
+        {"bewilderment", -0.1f, 0.6f}, {"confusion", -0.2f, 0.5f}, {"curiosity", 0.3f, 0.5f}
+    }},
+    {{  // Disgust
+        {"revulsion", -0.9f, 0.8f}, {"loathing", -0.85f, 0.7f}, {"abhorrence", -0.8f, 0.75f},
+        {"contempt", -0.6f, 0.5f}, {"aversion", -0.5f, 0.45f}, {"distaste", -0.4f, 0.35f},
+        {"dislike", -0.3f, 0.3f}, {"disapproval", -0.35f, 0.4f}, {"repugnance", -0.7f, 0.6f}
+    }},
+    {{  // Trust
+        {"admiration", 0.8f, 0.5f}, {"adoration", 0.85f, 0.6f}, {"devotion", 0.75f, 0.55f},
+        {"faith", 0.7f, 0.4f}, {"confidence", 0.6f, 0.5f}, {"reliance", 0.5f, 0.35f},
+        {"acceptance", 0.4f, 0.3f}, {"respect", 0.55f, 0.4f}, {"appreciation", 0.5f, 0.45f}
+    }},
+    {{  // Anticipation
+        {"eagerness", 0.7f, 0.85f}, {"excitement", 0.75f, 0.9f}, {"hope", 0.6f, 0.6f},
+        {"expectation", 0.4f, 0.55f}, {"vigilance", 0.1f, 0.7f}, {"interest", 0.35f, 0.5f},
+        {"optimism", 0.65f, 0.55f}, {"yearning", 0.2f, 0.6f}, {"impatience", -0.1f, 0.7f}
+    }}
+}};
+
+// Resolves a node name (e.g. "grief", "rage_mid") to its ID, or -1.
+constexpr int emotionIdFromName(std::string_view name) {
+    size_t level = 0;
+    for (size_t l = 1; l < kIntensityLevelCount; ++l) {
+        const std::string_view suffix = kIntensitySuffixes[l];
+        if (name.size() > suffix.size() && name.substr(name.size() - suffix.size()) == suffix) {
+            name.remove_suffix(suffix.size());
+            level = l;
+            break;
+        }
+    }
+
+    for (size_t c = 0; c < kEmotionCategoryCount; ++c) {
+        for (size_t v = 0; v < kVariantsPerCategory; ++v) {
+            if (kEmotionVariants[c][v].name == name) {
+                return static_cast<int>((c * kVariantsPerCategory + v) * kIntensityLevelCount + level);
+            }
+        }
+    }
+    return -1;
+}
+
+} // namespace kelly
@@ -1,122 +1,175 @@
 #include "emotion_engine.h"
+#include "profiling.h"
+#include "emotion_catalog.h"
 #include <cmath>
 #include <algorithm>
 #include <array>
+#include <cstdint>
 
 namespace kelly {
 
-EmotionEngine::EmotionEngine() {
+namespace {
+
+// FNV-1a; only needs to spread 216 short ASCII names over kNameIndexSize slots
+constexpr uint32_t hashName(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
+EmotionEngine::EmotionEngine()
+    : EmotionEngine(EmotionGraph::installed()) {}
+
+EmotionEngine::EmotionEngine(const EmotionGraph& graph)
+    : graph_(graph.getNodeCount() == kEmotionCount ? &graph : &EmotionGraph::builtin()) {
     initializeEmotions();
 }
 
+static_assert(kEmotionCategoryCount * kVariantsPerCategory * kIntensityLevelCount == EmotionEngine::kEmotionCount);
+
 void EmotionEngine::initializeEmotions() {
-    // 8 categories × 9 variants × 3 intensity levels = 216 nodes
-    // Variants: (name, valence, arousal)
-    struct Variant { const char* name; float valence; float arousal; };
-
-    std::array<std::pair<EmotionCategory, std::array<Variant, 9>>, 8> categoryVariants = {{
-        {EmotionCategory::Joy, {{
-            {"euphoria", 1.0f, 1.0f}, {"ecstasy", 0.95f, 0.95f}, {"elation", 0.85f, 0.9f},
-            {"delight", 0.8f, 0.7f}, {"happiness", 0.7f, 0.6f}, {"contentment", 0.7f, 0.3f},
-            {"serenity", 0.6f, 0.2f}, {"satisfaction", 0.5f, 0.4f}, {"cheerfulness", 0.6f, 0.5f}
-        }}},
-        {EmotionCategory::Sadness, {{
-            {"grief", -0.9f, 0.7f}, {"despair", -0.95f, 0.6f}, {"sorrow", -0.8f, 0.5f},
-            {"melancholy", -0.6f, 0.3f}, {"gloom", -0.5f, 0.4f}, {"disappointment", -0.4f, 0.3f},
-            {"loneliness", -0.6f, 0.2f}, {"nostalgia", -0.3f, 0.2f}, {"wistfulness", -0.2f, 0.15f}
-        }}},
-        {EmotionCategory::Anger, {{
-            {"rage", -0.8f, 1.0f}, {"fury", -0.85f, 0.95f}, {"wrath", -0.75f, 0.9f},
-            {"hostility", -0.6f, 0.7f}, {"resentment", -0.5f, 0.5f}, {"annoyance", -0.4f, 0.5f},
-            {"irritation", -0.35f, 0.45f}, {"frustration", -0.45f, 0.55f}, {"bitterness", -0.5f, 0.4f}
-        }}},
-        {EmotionCategory::Fear, {{
-            {"terror", -0.9f, 1.0f}, {"panic", -0.85f, 0.95f}, {"horror", -0.8f, 0.9f},
-            {"dread", -0.7f, 0.7f}, {"anxiety", -0.5f, 0.8f}, {"worry", -0.4f, 0.6f},
-            {"unease", -0.3f, 0.5f}, {"apprehension", -0.35f, 0.55f}, {"nervousness", -0.3f, 0.65f}
-        }}},
-        {EmotionCategory::Surprise, {{
-            {"amazement", 0.6f, 0.95f}, {"astonishment", 0.5f, 0.9f}, {"awe", 0.4f, 0.7f},
-            {"wonder", 0.5f, 0.6f}, {"shock", -0.1f, 0.9f}, {"startle", 0.0f, 0.85f},
-            {"bewilderment", -0.1f, 0.6f}, {"confusion", -0.2f, 0.5f}, {"curiosity", 0.3f, 0.5f}
-        }}},
-        {EmotionCategory::Disgust, {{
-            {"revulsion", -0.9f, 0.8f}, {"loathing", -0.85f, 0.7f}, {"abhorrence", -0.8f, 0.75f},
-            {"contempt", -0.6f, 0.5f}, {"aversion", -0.5f, 0.45f}, {"distaste", -0.4f, 0.35f},
-            {"dislike", -0.3f, 0.3f}, {"disapproval", -0.35f, 0.4f}, {"repugnance", -0.7f, 0.6f}
-        }}},
-        {EmotionCategory::Trust, {{
-            {"admiration", 0.8f, 0.5f}, {"adoration", 0.85f, 0.6f}, {"devotion", 0.75f, 0.55f},
-            {"faith", 0.7f, 0.4f}, {"confidence", 0.6f, 0.5f}, {"reliance", 0.5f, 0.35f},
-            {"acceptance", 0.4f, 0.3f}, {"respect", 0.55f, 0.4f}, {"appreciation", 0.5f, 0.45f}
-        }}},
-        {EmotionCategory::Anticipation, {{
-            {"eagerness", 0.7f, 0.85f}, {"excitement", 0.75f, 0.9f}, {"hope", 0.6f, 0.6f},
-            {"expectation", 0.4f, 0.55f}, {"vigilance", 0.1f, 0.7f}, {"interest", 0.35f, 0.5f},
-            {"optimism", 0.65f, 0.55f}, {"yearning", 0.2f, 0.6f}, {"impatience", -0.1f, 0.7f}
-        }}}
-    }};
-
-    constexpr float intensityLevels[3] = {1.0f, 0.6f, 0.3f};
-    int nodeId = 0;
-
-    for (const auto& [category, variants] : categoryVariants) {
-        for (const auto& v : variants) {
-            for (float intensity : intensityLevels) {
-                std::string suffix = (intensity == 1.0f) ? "" : (intensity == 0.6f ? "_mid" : "_low");
-                nodes_[nodeId] = EmotionNode{
-                    nodeId,
-                    std::string(v.name) + suffix,
-                    category,
-                    intensity,
-                    v.valence * intensity,
-                    v.arousal * intensity,
-                    {},
-                    {1.0f + (v.arousal * intensity - 0.5f) * 0.5f, v.valence > 0 ? "major" : "minor", intensity}
-                };
-                ++nodeId;
-            }
+    // 8 categories × 9 variants × 3 intensity levels = 216 nodes, laid out
+    // in emotion_catalog.h order by the graph generator
+    for (size_t nodeId = 0; nodeId < kEmotionCount; ++nodeId) {
+        const int id = static_cast<int>(nodeId);
+        const EmotionGraphNodeRecord& record = graph_->node(id);
+        const auto category = static_cast<EmotionCategory>(record.category);
+
+        nodes_[nodeId] = EmotionNode{
+            id,
+            graph_->name(id),
+            category,
+            record.intensity,
+            record.valence,
+            record.arousal,
+            {},
+            {1.0f + (record.arousal - 0.5f) * 0.5f, record.valence > 0 ? "major" : "minor", record.intensity}
+        };
+
+        valence_[nodeId] = record.valence;
+        arousal_[nodeId] = record.arousal;
+        intensity_[nodeId] = record.intensity;
+        category_[nodeId] = category;
+    }
+
+    buildNameIndex();
+    buildNeighborTable();
+}
+
+void EmotionEngine::buildNameIndex() {
+    // Open addressing with linear probing; the table is kept under half full
+    nameIndex_.fill(-1);
+    for (const auto& node : nodes_) {
+        uint32_t slot = hashName(node.name) & (kNameIndexSize - 1);
+        while (nameIndex_[slot] >= 0) {
+            slot = (slot + 1) & (kNameIndexSize - 1);
+        }
+        nameIndex_[slot] = static_cast<int16_t>(node.id);
+    }
+}
+
+void EmotionEngine::buildNeighborTable() {
+    std::array<float, kEmotionCount> distSq{};
+    std::array<uint8_t, kEmotionCount> order{};
+
+    for (size_t source = 0; source < kEmotionCount; ++source) {
+        squaredDistances(valence_[source], arousal_[source], intensity_[source], distSq);
+
+        for (size_t i = 0; i < kEmotionCount; ++i) {
+            order[i] = static_cast<uint8_t>(i);
+        }
+        std::sort(order.begin(), order.end(), [&](uint8_t a, uint8_t b) {
+            return distSq[a] != distSq[b] ? distSq[a] < distSq[b] : a < b;
+        });
+
+        size_t column = 0;
+        for (uint8_t id : order) {
+            if (id == source) continue;
+            neighborIds_[source][column] = id;
+            neighborDistSq_[source][column] = distSq[id];
+            ++column;
         }
     }
 }
 
 const EmotionNode* EmotionEngine::getEmotion(int emotionId) const {
-    auto it = nodes_.find(emotionId);
-    return (it != nodes_.end()) ? &it->second : nullptr;
+    if (emotionId < 0 || static_cast<size_t>(emotionId) >= nodes_.size()) {
+        return nullptr;
+    }
+    return &nodes_[static_cast<size_t>(emotionId)];
 }
 
-const EmotionNode* EmotionEngine::findEmotionByName(const std::string& name) const {
-    for (const auto& [id, node] : nodes_) {
+const EmotionNode* EmotionEngine::findEmotionByName(std::string_view name) const {
+    KELLY_ZONE();
+    uint32_t slot = hashName(name) & (kNameIndexSize - 1);
+    while (nameIndex_[slot] >= 0) {
+        const EmotionNode& node = nodes_[nameIndex_[slot]];
         if (node.name == name) {
             return &node;
         }
+        slot = (slot + 1) & (kNameIndexSize - 1);
     }
     return nullptr;
 }
 
-float EmotionEngine::calculateDistance(const EmotionNode& a, const EmotionNode& b) const {
-    float dv = a.valence - b.valence;
-    float da = a.arousal - b.arousal;
-    float di = a.intensity - b.intensity;
-    return std::sqrt(dv * dv + da * da + di * di);
+void EmotionEngine::squaredDistances(float valence, float arousal, float intensity,
+                                     std::span<float, kEmotionCount> out) const {
+    KELLY_ZONE();
+    // Branch-free pass over the SoA arrays; compilers vectorize this loop
+    const float* v = valence_.data();
+    const float* a = arousal_.data();
+    const float* in = intensity_.data();
+    float* d = out.data();
+    for (size_t n = 0; n < kEmotionCount; ++n) {
+        float dv = v[n] - valence;
+        float da = a[n] - arousal;
+        float di = in[n] - intensity;
+        d[n] = dv * dv + da * da + di * di;
+    }
 }
 
-std::vector<const EmotionNode*> EmotionEngine::getNearbyEmotions(int emotionId, float threshold) const {
-    const EmotionNode* source = getEmotion(emotionId);
-    if (!source) {
+int EmotionEngine::nearestEmotion(float valence, float arousal, float intensity) const {
+    KELLY_ZONE();
+    std::array<float, kEmotionCount> distSq;
+    squaredDistances(valence, arousal, intensity, distSq);
+    return static_cast<int>(std::min_element(distSq.begin(), distSq.end()) - distSq.begin());
+}
+
+std::span<const uint8_t> EmotionEngine::nearbyEmotionIds(int emotionId, float threshold) const {
+    KELLY_ZONE();
+    if (!getEmotion(emotionId) || threshold <= 0.0f) {
+        return {};
+    }
+
+    const auto& distances = neighborDistSq_[emotionId];
+    auto end = std::lower_bound(distances.begin(), distances.end(), threshold * threshold);
+    return std::span<const uint8_t>(neighborIds_[emotionId]).first(
+        static_cast<size_t>(end - distances.begin()));
+}
+
+std::span<const uint8_t> EmotionEngine::nearestEmotionIds(int emotionId, size_t k) const {
+    KELLY_ZONE();
+    if (!getEmotion(emotionId)) {
         return {};
     }
-    
+    return std::span<const uint8_t>(neighborIds_[emotionId]).first(std::min(k, kNeighborCount));
+}
+
+std::vector<const EmotionNode*> EmotionEngine::getNearbyEmotions(int emotionId, float threshold) const {
+    KELLY_ZONE();
+    std::span<const uint8_t> ids = nearbyEmotionIds(emotionId, threshold);
+
     std::vector<const EmotionNode*> nearby;
-    for (const auto& [id, node] : nodes_) {
-        if (id == emotionId) continue;
-        
-        float distance = calculateDistance(*source, node);
-        if (distance < threshold) {
-            nearby.push_back(&node);
-        }
+    nearby.reserve(ids.size());
+    for (uint8_t id : ids) {
+        nearby.push_back(&nodes_[id]);
     }
-    
+
     return nearby;
 }
 
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include <array>
+#include <span>
 #include <memory>
+#include <cstdint>
+#include "emotion_graph.h"
 
 namespace kelly {
 
@@ -26,7 +30,7 @@ struct MusicalAttributes {
 
 struct EmotionNode {
     int id;
-    std::string name;
+    std::string_view name;  // points into the emotion graph's string pool
     EmotionCategory category;
     float intensity;  // 0.0 to 1.0
     float valence;    // -1.0 to 1.0
@@ -37,20 +41,65 @@ struct EmotionNode {
 
 class EmotionEngine {
 public:
+    // 8 categories × 9 variants × 3 intensity levels
+    static constexpr size_t kEmotionCount = 216;
+
+    // Uses EmotionGraph::installed()
     EmotionEngine();
+    // The graph must outlive the engine; one without kEmotionCount nodes
+    // is ignored in favour of the builtin graph
+    explicit EmotionEngine(const EmotionGraph& graph);
     ~EmotionEngine() = default;
 
+    // Tens of KB of tables, shared read-only through EmotionModel; never copied
+    EmotionEngine(const EmotionEngine&) = delete;
+    EmotionEngine& operator=(const EmotionEngine&) = delete;
+
     const EmotionNode* getEmotion(int emotionId) const;
-    const EmotionNode* findEmotionByName(const std::string& name) const;
+    const EmotionNode* findEmotionByName(std::string_view name) const;
+    // Nearby emotions are returned nearest first
     std::vector<const EmotionNode*> getNearbyEmotions(int emotionId, float threshold = 0.3f) const;
-    
+
+    // Non-allocating views into the precomputed neighbor table
+    std::span<const uint8_t> nearbyEmotionIds(int emotionId, float threshold = 0.3f) const;
+    std::span<const uint8_t> nearestEmotionIds(int emotionId, size_t k) const;
+
+    // Queries for arbitrary points in (valence, arousal, intensity) space
+    void squaredDistances(float valence, float arousal, float intensity,
+                          std::span<float, kEmotionCount> out) const;
+    int nearestEmotion(float valence, float arousal, float intensity) const;
+
     size_t getEmotionCount() const { return nodes_.size(); }
 
+    // Hot per-node coordinates, indexed by emotion ID (struct-of-arrays)
+    std::span<const float, kEmotionCount> valences() const { return valence_; }
+    std::span<const float, kEmotionCount> arousals() const { return arousal_; }
+    std::span<const float, kEmotionCount> intensities() const { return intensity_; }
+    std::span<const EmotionCategory, kEmotionCount> categories() const { return category_; }
+
 private:
     void initializeEmotions();
-    float calculateDistance(const EmotionNode& a, const EmotionNode& b) const;
+    void buildNameIndex();
+    void buildNeighborTable();
+
+    // Cold data: full nodes, names viewing the graph, kept apart from the hot arrays
+    const EmotionGraph* graph_;
+    std::array<EmotionNode, kEmotionCount> nodes_;
+
+    alignas(64) std::array<float, kEmotionCount> valence_{};
+    alignas(64) std::array<float, kEmotionCount> arousal_{};
+    alignas(64) std::array<float, kEmotionCount> intensity_{};
+    std::array<EmotionCategory, kEmotionCount> category_{};
+
+    // Hashed name → ID table, power of two and at most half full
+    static constexpr uint32_t kNameIndexSize = 512;
+    std::array<int16_t, kNameIndexSize> nameIndex_{};
 
-    std::map<int, EmotionNode> nodes_;
+    // Per node, every other node sorted by squared distance (then ID)
+    static_assert(kEmotionCount <= 256, "neighbor IDs are stored as uint8_t");
+    static constexpr size_t kNeighborCount = kEmotionCount - 1;
+    std::array<std::array<uint8_t, kNeighborCount>, kEmotionCount> neighborIds_{};
+    std::array<std::array<float, kNeighborCount>, kEmotionCount> neighborDistSq_{};
 };
 
 } // namespace kelly
@@ -0,0 +1,214 @@
+#include "emotion_graph.h"
+#include "emotion_catalog.h"
+#include "binary_image.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+// Set by the build to where the generated image is installed
+#ifndef KELLY_EMOTION_GRAPH_PATH
+#define KELLY_EMOTION_GRAPH_PATH ""
+#endif
+
+namespace kelly {
+
+std::vector<std::byte> EmotionGraph::buildImage() {
+    std::vector<EmotionGraphNodeRecord> nodes;
+    std::string strings;
+    std::map<std::string, uint32_t, std::less<>> interned;
+
+    for (size_t c = 0; c < kEmotionCategoryCount; ++c) {
+        for (const auto& v : kEmotionVariants[c]) {
+            for (size_t level = 0; level < kIntensityLevelCount; ++level) {
+                std::string name = std::string(v.name) + std::string(kIntensitySuffixes[level]);
+                auto [it, inserted] = interned.try_emplace(name, static_cast<uint32_t>(strings.size()));
+                if (inserted) {
+                    strings += name;
+                }
+
+                const float intensity = kIntensityLevels[level];
+                nodes.push_back(EmotionGraphNodeRecord{
+                    it->second,
+                    static_cast<uint16_t>(name.size()),
+                    static_cast<uint8_t>(c),
+                    static_cast<uint8_t>(level),
+                    v.valence * intensity,
+                    v.arousal * intensity,
+                    intensity
+                });
+            }
+        }
+    }
+
+    const size_t nodeCount = nodes.size();
+    const float maxDistSq = kRelatedDistance * kRelatedDistance;
+
+    std::vector<uint32_t> edgeOffsets;
+    std::vector<uint16_t> edges;
+    std::vector<std::pair<float, uint16_t>> candidates;
+    edgeOffsets.reserve(nodeCount + 1);
+    for (size_t source = 0; source < nodeCount; ++source) {
+        edgeOffsets.push_back(static_cast<uint32_t>(edges.size()));
+        candidates.clear();
+        for (size_t target = 0; target < nodeCount; ++target) {
+            if (target == source) continue;
+            const float dv = nodes[target].valence - nodes[source].valence;
+            const float da = nodes[target].arousal - nodes[source].arousal;
+            const float di = nodes[target].intensity - nodes[source].intensity;
+            const float distSq = dv * dv + da * da + di * di;
+            if (distSq < maxDistSq) {
+                candidates.emplace_back(distSq, static_cast<uint16_t>(target));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        for (const auto& [distSq, target] : candidates) {
+            edges.push_back(target);
+        }
+    }
+    edgeOffsets.push_back(static_cast<uint32_t>(edges.size()));
+
+    std::vector<uint16_t> nameIndex(nodeCount);
+    for (size_t i = 0; i < nodeCount; ++i) {
+        nameIndex[i] = static_cast<uint16_t>(i);
+    }
+    auto nodeName = [&](uint16_t id) {
+        return std::string_view(strings).substr(nodes[id].nameOffset, nodes[id].nameLength);
+    };
+    std::sort(nameIndex.begin(), nameIndex.end(),
+              [&](uint16_t a, uint16_t b) { return nodeName(a) < nodeName(b); });
+
+    BinaryImageWriter<EmotionGraphHeader> writer;
+    EmotionGraphHeader header{};
+    std::memcpy(header.magic, kEmotionGraphMagic, sizeof(header.magic));
+    header.version = kEmotionGraphVersion;
+    header.headerSize = sizeof(EmotionGraphHeader);
+    header.nodeCount = static_cast<uint32_t>(nodeCount);
+    header.edgeCount = static_cast<uint32_t>(edges.size());
+    header.stringPoolSize = static_cast<uint32_t>(strings.size());
+    header.nodesOffset = writer.append(std::span<const EmotionGraphNodeRecord>(nodes));
+    header.edgeOffsetsOffset = writer.append(std::span<const uint32_t>(edgeOffsets));
+    header.edgesOffset = writer.append(std::span<const uint16_t>(edges));
+    header.nameIndexOffset = writer.append(std::span<const uint16_t>(nameIndex));
+    header.stringsOffset = writer.append(std::span<const char>(strings));
+    header.totalSize = writer.size();
+    return writer.finish(header);
+}
+
+bool EmotionGraph::writeImage(const std::string& path) {
+    const std::vector<std::byte> image = buildImage();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    return static_cast<bool>(out);
+}
+
+std::unique_ptr<EmotionGraph> EmotionGraph::open(const std::string& path) {
+    std::unique_ptr<EmotionGraph> graph(new EmotionGraph());
+    if (!graph->file_.open(path) || !graph->bind(graph->file_.bytes())) {
+        return nullptr;
+    }
+    return graph;
+}
+
+std::unique_ptr<EmotionGraph> EmotionGraph::fromImage(std::vector<std::byte> image) {
+    std::unique_ptr<EmotionGraph> graph(new EmotionGraph());
+    graph->image_ = std::move(image);
+    if (!graph->bind(graph->image_)) {
+        return nullptr;
+    }
+    return graph;
+}
+
+const EmotionGraph& EmotionGraph::builtin() {
+    static const std::unique_ptr<EmotionGraph> graph = fromImage(buildImage());
+    return *graph;
+}
+
+std::string EmotionGraph::installedPath() {
+    if (const char* path = std::getenv("KELLY_EMOTION_GRAPH"); path != nullptr && *path != '\0') {
+        return path;
+    }
+    return KELLY_EMOTION_GRAPH_PATH;
+}
+
+const EmotionGraph& EmotionGraph::installed() {
+    static const std::unique_ptr<EmotionGraph> graph = [] {
+        const std::string path = installedPath();
+        auto mapped = path.empty() ? nullptr : open(path);
+        constexpr size_t nodeCount = kEmotionCategoryCount * kVariantsPerCategory * kIntensityLevelCount;
+        return mapped && mapped->getNodeCount() == nodeCount ? std::move(mapped) : nullptr;
+    }();
+    return graph ? *graph : builtin();
+}
+
+bool EmotionGraph::bind(std::span<const std::byte> bytes) {
+    if constexpr (std::endian::native != std::endian::little) {
+        return false;
+    }
+    if (bytes.size() < sizeof(EmotionGraphHeader)
+        || reinterpret_cast<uintptr_t>(bytes.data()) % alignof(uint32_t) != 0) {
+        return false;
+    }
+
+    const auto* header = imageSection<EmotionGraphHeader>(bytes, 0);
+    const uint64_t totalSize = header->totalSize;
+    const uint64_t nodeCount = header->nodeCount;
+    if (std::memcmp(header->magic, kEmotionGraphMagic, sizeof(header->magic)) != 0
+        || header->version != kEmotionGraphVersion
+        || header->headerSize != sizeof(EmotionGraphHeader)
+        || totalSize > bytes.size()
+        || nodeCount == 0 || nodeCount > 0xFFFF
+        || !imageSectionFits(header->nodesOffset, nodeCount, sizeof(EmotionGraphNodeRecord), totalSize)
+        || !imageSectionFits(header->edgeOffsetsOffset, nodeCount + 1, sizeof(uint32_t), totalSize)
+        || !imageSectionFits(header->edgesOffset, header->edgeCount, sizeof(uint16_t), totalSize)
+        || !imageSectionFits(header->nameIndexOffset, nodeCount, sizeof(uint16_t), totalSize)
+        || header->stringsOffset + uint64_t{header->stringPoolSize} > totalSize) {
+        return false;
+    }
+
+    const auto* nodes = imageSection<EmotionGraphNodeRecord>(bytes, header->nodesOffset);
+    const auto* edgeOffsets = imageSection<uint32_t>(bytes, header->edgeOffsetsOffset);
+    const auto* edges = imageSection<uint16_t>(bytes, header->edgesOffset);
+    const auto* nameIndex = imageSection<uint16_t>(bytes, header->nameIndexOffset);
+
+    // Bounds only, so later reads never need checks; nothing is copied
+    for (uint64_t i = 0; i < nodeCount; ++i) {
+        const EmotionGraphNodeRecord& node = nodes[i];
+        if (node.nameOffset + uint64_t{node.nameLength} > header->stringPoolSize
+            || node.category >= kEmotionCategoryCount
+            || node.intensityLevel >= kIntensityLevelCount
+            || edgeOffsets[i] > edgeOffsets[i + 1]
+            || nameIndex[i] >= nodeCount) {
+            return false;
+        }
+    }
+    if (edgeOffsets[0] != 0 || edgeOffsets[nodeCount] != header->edgeCount) {
+        return false;
+    }
+    for (uint64_t e = 0; e < header->edgeCount; ++e) {
+        if (edges[e] >= nodeCount) {
+            return false;
+        }
+    }
+
+    bytes_ = bytes.first(static_cast<size_t>(totalSize));
+    header_ = header;
+    nodes_ = nodes;
+    edgeOffsets_ = edgeOffsets;
+    edges_ = edges;
+    nameIndex_ = nameIndex;
+    strings_ = imageSection<char>(bytes, header->stringsOffset);
+    return true;
+}
+
+int EmotionGraph::findByName(std::string_view name) const {
+    const uint16_t* first = nameIndex_;
+    const uint16_t* last = nameIndex_ + header_->nodeCount;
+    const uint16_t* it = std::lower_bound(first, last, name,
+                                          [&](uint16_t id, std::string_view key) { return this->name(id) < key; });
+    return (it != last && this->name(*it) == name) ? *it : -1;
+}
+
+} // namespace kelly
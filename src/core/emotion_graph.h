@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mapped_file.h"
+
+namespace kelly {
+
+// On-disk layout of the emotion graph (".kemg"), little-endian, every
+// section 4-byte aligned so it can be read in place:
+//
+//   EmotionGraphHeader
+//   EmotionGraphNodeRecord[nodeCount]
+//   uint32_t edgeOffsets[nodeCount + 1]   CSR row starts into edges
+//   uint16_t edges[edgeCount]             related node IDs, nearest first
+//   uint16_t nameIndex[nodeCount]         node IDs sorted by name
+//   char     strings[stringPoolSize]      interned names, not terminated
+//
+// Bump kEmotionGraphVersion whenever the layout or the generated content
+// changes; readers reject any other version.
+inline constexpr char kEmotionGraphMagic[4] = {'K', 'E', 'M', 'G'};
+inline constexpr uint16_t kEmotionGraphVersion = 1;
+
+struct EmotionGraphHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t nodeCount;
+    uint32_t edgeCount;
+    uint32_t stringPoolSize;
+    uint32_t nodesOffset;
+    uint32_t edgeOffsetsOffset;
+    uint32_t edgesOffset;
+    uint32_t nameIndexOffset;
+    uint32_t stringsOffset;
+    uint32_t totalSize;
+};
+
+struct EmotionGraphNodeRecord {
+    uint32_t nameOffset;
+    uint16_t nameLength;
+    uint8_t category;        // EmotionCategory
+    uint8_t intensityLevel;  // index into kIntensityLevels
+    float valence;
+    float arousal;
+    float intensity;
+};
+
+static_assert(sizeof(EmotionGraphHeader) == 44);
+static_assert(sizeof(EmotionGraphNodeRecord) == 20);
+
+// Read-only view of an emotion graph image, either memory-mapped from a
+// file generated offline (KellyEmotionGraph tool) or built in-process from
+// emotion_catalog.h. Opening only validates bounds; all accessors read the
+// image directly.
+class EmotionGraph {
+public:
+    // Emotions closer than this in (valence, arousal, intensity) are related
+    static constexpr float kRelatedDistance = 0.3f;
+
+    ~EmotionGraph() = default;
+
+    EmotionGraph(const EmotionGraph&) = delete;
+    EmotionGraph& operator=(const EmotionGraph&) = delete;
+
+    // nullptr if the file is missing, malformed or from another version
+    static std::unique_ptr<EmotionGraph> open(const std::string& path);
+    static std::unique_ptr<EmotionGraph> fromImage(std::vector<std::byte> image);
+
+    // Built once per process from the compiled-in catalog and shared by every user
+    static const EmotionGraph& builtin();
+    // The image generated at build time and installed with the binaries,
+    // mapped once per process: $KELLY_EMOTION_GRAPH if set, else the
+    // configured install path. builtin() if neither holds a valid image of
+    // the catalog's size. This is what the shared model uses.
+    static const EmotionGraph& installed();
+    static std::string installedPath();
+
+    // The generator used for both builtin() and the offline tool
+    static std::vector<std::byte> buildImage();
+    static bool writeImage(const std::string& path);
+
+    size_t getNodeCount() const { return header_->nodeCount; }
+    size_t getEdgeCount() const { return header_->edgeCount; }
+    bool isMapped() const { return file_.isOpen(); }
+    std::span<const std::byte> bytes() const { return bytes_; }
+
+    // Accessors take IDs in [0, getNodeCount())
+    const EmotionGraphNodeRecord& node(int id) const { return nodes_[id]; }
+    std::string_view name(int id) const {
+        return {strings_ + nodes_[id].nameOffset, nodes_[id].nameLength};
+    }
+    std::span<const uint16_t> related(int id) const {
+        return {edges_ + edgeOffsets_[id], edges_ + edgeOffsets_[id + 1]};
+    }
+
+    // Binary search over the name index; -1 if absent
+    int findByName(std::string_view name) const;
+
+private:
+    EmotionGraph() = default;
+
+    bool bind(std::span<const std::byte> bytes);
+
+    MappedFile file_;
+    std::vector<std::byte> image_;
+    std::span<const std::byte> bytes_;
+
+    const EmotionGraphHeader* header_ = nullptr;
+    const EmotionGraphNodeRecord* nodes_ = nullptr;
+    const uint32_t* edgeOffsets_ = nullptr;
+    const uint16_t* edges_ = nullptr;
+    const uint16_t* nameIndex_ = nullptr;
+    const char* strings_ = nullptr;
+};
+
+} // namespace kelly
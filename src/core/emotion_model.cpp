@@ -0,0 +1,84 @@
+#include "emotion_model.h"
+#include "emotion_catalog.h"
+#include "audio_thread.h"
+#include <mutex>
+
+namespace kelly {
+
+namespace {
+
+constexpr int kGriefId = emotionIdFromName("grief");
+constexpr int kRageId = emotionIdFromName("rage");
+constexpr int kAnxietyId = emotionIdFromName("anxiety");
+static_assert(kGriefId >= 0 && kRageId >= 0 && kAnxietyId >= 0);
+
+struct WoundKeyword {
+    std::string_view keyword;
+    int emotionId;
+};
+
+// Registered ahead of the node names, so on equal scores these win in the
+// order listed (the original loss/grief > anger/rage > fear/anxiety priority).
+constexpr WoundKeyword kWoundKeywords[] = {
+    {"loss", kGriefId},
+    {"grief", kGriefId},
+    {"anger", kRageId},
+    {"rage", kRageId},
+    {"fear", kAnxietyId},
+    {"anxiety", kAnxietyId},
+    {"mourning", kGriefId},
+    {"heartbreak", kGriefId},
+    {"angry", kRageId},
+    {"furious", emotionIdFromName("fury")},
+    {"afraid", kAnxietyId},
+    {"scared", emotionIdFromName("worry")},
+    {"lonely", emotionIdFromName("loneliness")},
+    {"sad", emotionIdFromName("sorrow")},
+    {"happy", emotionIdFromName("happiness")},
+    {"hopeful", emotionIdFromName("hope")},
+};
+
+} // namespace
+
+EmotionModel::EmotionModel(const EmotionGraph& graph)
+    : engine_(graph) {
+    buildWoundMatcher();
+}
+
+EmotionModelHandle EmotionModel::shared() {
+    static std::mutex mutex;
+    static std::weak_ptr<const EmotionModel> current;
+
+    AudioThreadScope::noteLock();
+    std::lock_guard<std::mutex> lock(mutex);
+    EmotionModelHandle model = current.lock();
+    if (!model) {
+        model = std::make_shared<const EmotionModel>(EmotionGraph::installed());
+        current = model;
+    }
+    return model;
+}
+
+const EmotionPathTable& EmotionModel::getPaths() const {
+    std::call_once(pathsBuilt_, [this] { paths_ = std::make_unique<const EmotionPathTable>(engine_); });
+    return *paths_;
+}
+
+void EmotionModel::buildWoundMatcher() {
+    for (const auto& [keyword, emotionId] : kWoundKeywords) {
+        woundMatcher_.addKeyword(keyword, emotionId);
+    }
+
+    // Every base emotion name maps to its full-intensity node. Whole words
+    // only: as prefixes they would catch derived words of the opposite
+    // meaning ("hope" in "hopeless"), which the curated stems above avoid.
+    for (size_t c = 0; c < kEmotionCategoryCount; ++c) {
+        for (const auto& variant : kEmotionVariants[c]) {
+            woundMatcher_.addKeyword(variant.name, emotionIdFromName(variant.name), 1.0f, true);
+        }
+    }
+
+    woundMatcher_.build();
+}
+
+} // namespace kelly
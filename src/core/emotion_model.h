@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include "emotion_engine.h"
+#include "emotion_graph.h"
+#include "emotion_trajectory.h"
+#include "keyword_matcher.h"
+#include "rule_breaks.h"
+
+namespace kelly {
+
+class EmotionModel;
+using EmotionModelHandle = std::shared_ptr<const EmotionModel>;
+
+// Everything immutable that wound processing needs: the 216-node engine,
+// the compiled wound-keyword matcher and the per-node rule break cache. Built once and shared read-only by
+// every IntentProcessor, RealtimeGenerator and plugin instance in the
+// process. All access is const. The only synchronization after
+// construction is the once-per-node build of a CompiledEmotion.
+class EmotionModel {
+public:
+    explicit EmotionModel(const EmotionGraph& graph = EmotionGraph::installed());
+    ~EmotionModel() = default;
+
+    EmotionModel(const EmotionModel&) = delete;
+    EmotionModel& operator=(const EmotionModel&) = delete;
+
+    // Process-wide model, built on first request (thread-safe). The process
+    // holds it only while a handle exists, so closing the last plugin
+    // instance releases it.
+    static EmotionModelHandle shared();
+
+    const EmotionEngine& getEngine() const { return engine_; }
+    const KeywordMatcher& getWoundMatcher() const { return woundMatcher_; }
+    // Built on first use per node; null for unknown IDs. Not for the audio thread.
+    const CompiledEmotion* getCompiled(int emotionId) const { return compiled_.get(emotionId); }
+    // All-pairs trajectory paths, built on first use (thread-safe). Not for the audio thread.
+    const EmotionPathTable& getPaths() const;
+
+private:
+    void buildWoundMatcher();
+
+    EmotionEngine engine_;
+    KeywordMatcher woundMatcher_;
+    CompiledEmotionCache compiled_{engine_};
+    mutable std::once_flag pathsBuilt_;
+    mutable std::unique_ptr<const EmotionPathTable> paths_;
+};
+
+} // namespace kelly
@@ -2,18 +2,39 @@
 
 namespace kelly {
 
-EmotionThesaurus::EmotionThesaurus() {
+EmotionThesaurus::EmotionThesaurus()
+    : EmotionThesaurus(EmotionGraph::installed()) {}
+
+EmotionThesaurus::EmotionThesaurus(const EmotionGraph& graph)
+    : graph_(graph.getNodeCount() == kNodeCount ? &graph : &EmotionGraph::builtin()) {
     initializeThesaurus();
 }
 
 void EmotionThesaurus::initializeThesaurus() {
-    // Initialize 216-node emotion network
-    // Simplified for initial implementation
+    for (size_t i = 0; i < kNodeCount; ++i) {
+        const int id = static_cast<int>(i);
+        const EmotionGraphNodeRecord& record = graph_->node(id);
+        nodes_[i] = EmotionThesaurusNode{
+            id,
+            graph_->name(id),
+            static_cast<EmotionCategory>(record.category),
+            record.valence,
+            record.arousal,
+            record.intensity,
+            graph_->related(id)
+        };
+    }
 }
 
 const EmotionThesaurusNode* EmotionThesaurus::getNode(int id) const {
-    // Implementation would return node by ID
-    return nullptr;
+    if (id < 0 || static_cast<size_t>(id) >= nodes_.size()) {
+        return nullptr;
+    }
+    return &nodes_[static_cast<size_t>(id)];
+}
+
+const EmotionThesaurusNode* EmotionThesaurus::findNode(std::string_view name) const {
+    return getNode(graph_->findByName(name));
 }
 
 } // namespace kelly
@@ -1,27 +1,47 @@
 #pragma once
 
 #include <array>
-#include <string>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include "emotion_engine.h"
+#include "emotion_graph.h"
 
 namespace kelly {
 
 struct EmotionThesaurusNode {
     int id;
-    std::string name;
-    // Additional fields would be here
+    std::string_view name;  // points into the graph's string pool
+    EmotionCategory category;
+    float valence;
+    float arousal;
+    float intensity;
+    std::span<const uint16_t> relatedEmotions;  // nearest first
 };
 
+// 216-node emotion network read straight out of an EmotionGraph image;
+// nodes are views, so instances share the graph's memory.
 class EmotionThesaurus {
 public:
+    static constexpr size_t kNodeCount = EmotionEngine::kEmotionCount;
+
+    // Uses EmotionGraph::installed()
     EmotionThesaurus();
+    // The graph must outlive the thesaurus; one without kNodeCount nodes
+    // is ignored in favour of the builtin graph
+    explicit EmotionThesaurus(const EmotionGraph& graph);
     ~EmotionThesaurus() = default;
 
     const EmotionThesaurusNode* getNode(int id) const;
-    // Additional methods for the 216-node thesaurus
+    const EmotionThesaurusNode* findNode(std::string_view name) const;
+    size_t getNodeCount() const { return nodes_.size(); }
+    const EmotionGraph& getGraph() const { return *graph_; }
 
 private:
     void initializeThesaurus();
-    std::array<EmotionThesaurusNode, 216> nodes_;
+
+    const EmotionGraph* graph_;
+    std::array<EmotionThesaurusNode, kNodeCount> nodes_;
 };
 
 } // namespace kelly
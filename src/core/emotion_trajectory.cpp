@@ -0,0 +1,228 @@
+#include "emotion_trajectory.h"
+#include "profiling.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace kelly {
+
+namespace {
+
+float distanceSquared(const EmotionNode& a, const EmotionNode& b) {
+    const float dv = a.valence - b.valence;
+    const float da = a.arousal - b.arousal;
+    const float di = a.intensity - b.intensity;
+    return dv * dv + da * da + di * di;
+}
+
+MorphFrame frameOf(const EmotionNode& node) {
+    MorphFrame frame;
+    frame.tempoModifier = node.musicalAttributes.tempoModifier;
+    frame.dynamics = node.musicalAttributes.dynamics;
+    frame.majorWeight = musicalModeFromName(node.musicalAttributes.mode) == MusicalMode::Major ? 1.0f : 0.0f;
+    frame.emotionId = static_cast<int16_t>(node.id);
+    return frame;
+}
+
+bool isNodeId(int id) {
+    return id >= 0 && static_cast<size_t>(id) < EmotionEngine::kEmotionCount;
+}
+
+bool isWellFormed(const MorphFrame& frame) {
+    return std::isfinite(frame.tempoModifier) && frame.tempoModifier > 0.0f &&
+           frame.dynamics >= 0.0f && frame.dynamics <= 1.0f &&
+           frame.majorWeight >= 0.0f && frame.majorWeight <= 1.0f && isNodeId(frame.emotionId);
+}
+
+MorphFrame lerp(const MorphFrame& a, const MorphFrame& b, float t) {
+    MorphFrame frame;
+    frame.tempoModifier = a.tempoModifier + (b.tempoModifier - a.tempoModifier) * t;
+    frame.dynamics = a.dynamics + (b.dynamics - a.dynamics) * t;
+    frame.majorWeight = a.majorWeight + (b.majorWeight - a.majorWeight) * t;
+    frame.emotionId = t < 0.5f ? a.emotionId : b.emotionId;
+    return frame;
+}
+
+} // namespace
+
+EmotionPathTable::EmotionPathTable(const EmotionEngine& engine)
+    : nodeCount_(std::min(engine.getEmotionCount(), kNodeCount)) {
+    KELLY_ZONE();
+    static_assert(kNodeCount <= 256, "next hops are stored as uint8_t");
+    const size_t n = nodeCount_;
+    for (size_t i = 0; i < n; ++i) {
+        const EmotionNode& a = *engine.getEmotion(static_cast<int>(i));
+        for (size_t j = 0; j < n; ++j) {
+            cost_[i][j] = i == j ? 0.0f : distanceSquared(a, *engine.getEmotion(static_cast<int>(j))) + kHopPenalty;
+            next_[i][j] = static_cast<uint8_t>(j);
+        }
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+        const auto& viaK = cost_[k];
+        for (size_t i = 0; i < n; ++i) {
+            const float toK = cost_[i][k];
+            auto& fromI = cost_[i];
+            auto& hopI = next_[i];
+            const uint8_t firstHop = next_[i][k];
+            for (size_t j = 0; j < n; ++j) {
+                const float through = toK + viaK[j];
+                if (through < fromI[j]) {
+                    fromI[j] = through;
+                    hopI[j] = firstHop;
+                }
+            }
+        }
+    }
+}
+
+std::vector<int> EmotionPathTable::path(int from, int to) const {
+    std::vector<int> nodes;
+    if (from < 0 || to < 0 || static_cast<size_t>(from) >= nodeCount_ || static_cast<size_t>(to) >= nodeCount_) {
+        return nodes;
+    }
+    nodes.push_back(from);
+    for (int node = from; node != to && nodes.size() <= nodeCount_;) {
+        node = next_[static_cast<size_t>(node)][static_cast<size_t>(to)];
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+float EmotionPathTable::cost(int from, int to) const {
+    if (from < 0 || to < 0 || static_cast<size_t>(from) >= nodeCount_ || static_cast<size_t>(to) >= nodeCount_) {
+        return -1.0f;
+    }
+    return cost_[static_cast<size_t>(from)][static_cast<size_t>(to)];
+}
+
+int EmotionPathTable::nextHop(int from, int to) const {
+    if (from < 0 || to < 0 || static_cast<size_t>(from) >= nodeCount_ || static_cast<size_t>(to) >= nodeCount_) {
+        return -1;
+    }
+    return next_[static_cast<size_t>(from)][static_cast<size_t>(to)];
+}
+
+bool EmotionTrajectory::build(const EmotionEngine& engine, const EmotionPathTable& paths, int from, int to) {
+    KELLY_ZONE();
+    const std::vector<int> nodes = paths.path(from, to);
+    if (nodes.empty()) {
+        return false;
+    }
+
+    // Arc length at each node, so the table advances at constant speed through the space
+    std::vector<float> distance(nodes.size(), 0.0f);
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        distance[i] = distance[i - 1] + std::sqrt(distanceSquared(*engine.getEmotion(nodes[i - 1]),
+                                                                  *engine.getEmotion(nodes[i])));
+    }
+    const float total = distance.back();
+
+    size_t hop = 0;
+    for (size_t s = 0; s < kTableSize; ++s) {
+        if (total <= 0.0f) {
+            table_[s] = frameOf(*engine.getEmotion(nodes.back()));
+            continue;
+        }
+        const float at = total * static_cast<float>(s) / static_cast<float>(kTableSize - 1);
+        while (hop + 2 < nodes.size() && distance[hop + 1] < at) {
+            ++hop;
+        }
+        const float span = distance[hop + 1] - distance[hop];
+        const float t = span > 0.0f ? std::clamp((at - distance[hop]) / span, 0.0f, 1.0f) : 1.0f;
+        table_[s] = lerp(frameOf(*engine.getEmotion(nodes[hop])), frameOf(*engine.getEmotion(nodes[hop + 1])), t);
+    }
+
+    from_ = static_cast<int16_t>(from);
+    to_ = static_cast<int16_t>(to);
+    valid_ = true;
+    return true;
+}
+
+void EmotionTrajectory::writeImage(std::span<std::byte, kImageSize> out) const {
+    std::memcpy(out.data(), table_.data(), sizeof(table_));
+    std::memcpy(out.data() + sizeof(table_), &from_, sizeof(from_));
+    std::memcpy(out.data() + sizeof(table_) + sizeof(from_), &to_, sizeof(to_));
+}
+
+bool EmotionTrajectory::readImage(std::span<const std::byte, kImageSize> in) {
+    KELLY_ZONE();
+    static_assert(sizeof(table_) == kTableSize * sizeof(MorphFrame));
+    int16_t from = -1;
+    int16_t to = -1;
+    std::memcpy(&from, in.data() + sizeof(table_), sizeof(from));
+    std::memcpy(&to, in.data() + sizeof(table_) + sizeof(from), sizeof(to));
+    if (!isNodeId(from) || !isNodeId(to)) {
+        return false;
+    }
+
+    std::array<MorphFrame, kTableSize> table;
+    std::memcpy(table.data(), in.data(), sizeof(table));
+    if (!std::all_of(table.begin(), table.end(), isWellFormed)) {
+        return false;
+    }
+
+    table_ = table;
+    from_ = from;
+    to_ = to;
+    valid_ = true;
+    return true;
+}
+
+MorphFrame EmotionTrajectory::frameAt(float progress) const noexcept {
+    const float position = std::clamp(progress, 0.0f, 1.0f) * static_cast<float>(kTableSize - 1);
+    const auto index = std::min(static_cast<size_t>(position), kTableSize - 2);
+    return lerp(table_[index], table_[index + 1], position - static_cast<float>(index));
+}
+
+void TrajectoryPlayer::start(const EmotionTrajectory& trajectory, uint64_t lengthTicks, float startProgress) {
+    Automation& automation = automation_.back();
+    automation.trajectory = trajectory;
+    automation.lengthTicks = std::max<uint64_t>(lengthTicks, 1);
+    automation.startOffset =
+        static_cast<uint64_t>(static_cast<double>(std::clamp(startProgress, 0.0f, 1.0f)) * automation.lengthTicks);
+    automation.serial = ++serial_;
+    automation.active = trajectory.isValid();
+    automation_.publish();
+}
+
+void TrajectoryPlayer::stop() {
+    Automation& automation = automation_.back();
+    automation.serial = ++serial_;
+    automation.active = false;
+    automation_.publish();
+}
+
+int TrajectoryPlayer::getCurrentEmotion() const {
+    const uint64_t current = current_.load(std::memory_order_relaxed);
+    if (static_cast<uint32_t>(current >> 32) != serial_) {
+        return -1;
+    }
+    return static_cast<int>(current & 0xffffffffu) - 1;
+}
+
+const MorphFrame* TrajectoryPlayer::advance(uint64_t tick) noexcept {
+    automation_.update();
+    const Automation& automation = automation_.front();
+    if (!automation.active) {
+        current_.store(0, std::memory_order_relaxed);
+        progress_.store(-1.0f, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if (automation.serial != anchoredSerial_) {
+        anchoredSerial_ = automation.serial;
+        startTick_ = tick;
+    }
+    // A seek to before the start holds the first frame
+    const uint64_t elapsed = (tick > startTick_ ? tick - startTick_ : 0) + automation.startOffset;
+    const float progress = std::min(static_cast<float>(static_cast<double>(elapsed) / automation.lengthTicks), 1.0f);
+    frame_ = automation.trajectory.frameAt(progress);
+
+    current_.store(uint64_t{automation.serial} << 32 | static_cast<uint32_t>(frame_.emotionId + 1),
+                   std::memory_order_relaxed);
+    progress_.store(progress, std::memory_order_relaxed);
+    return &frame_;
+}
+
+} // namespace kelly
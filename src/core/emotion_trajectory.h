@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "emotion_engine.h"
+#include "musical_params.h"
+#include "triple_buffer.h"
+
+namespace kelly {
+
+// MusicalAttributes at one point of a trajectory, as plain data for the audio thread
+struct MorphFrame {
+    float tempoModifier = 1.0f;
+    float dynamics = 0.5f;
+    float majorWeight = 0.0f;  // 0 = minor, 1 = major; blends across a mode change
+    int16_t emotionId = -1;    // path node nearest this point
+
+    MusicalMode mode() const { return majorWeight >= 0.5f ? MusicalMode::Major : MusicalMode::Minor; }
+};
+
+// Smoothest paths between every pair of the engine's nodes. The graph is
+// complete: each hop costs its squared (valence, arousal, intensity)
+// distance plus kHopPenalty. Long jumps are replaced by chains of close
+// neighbours, and the penalty stops chains of negligible steps. It is
+// built once with Floyd-Warshall (216³ relaxations), then kept as a
+// next-hop table.
+class EmotionPathTable {
+public:
+    static constexpr float kHopPenalty = 0.02f;
+
+    explicit EmotionPathTable(const EmotionEngine& engine);
+
+    EmotionPathTable(const EmotionPathTable&) = delete;
+    EmotionPathTable& operator=(const EmotionPathTable&) = delete;
+
+    // Node IDs from `from` to `to`, both included; empty for unknown IDs
+    std::vector<int> path(int from, int to) const;
+    // Path cost; negative for unknown IDs
+    float cost(int from, int to) const;
+    // First node after `from` on the way to `to`, or -1
+    int nextHop(int from, int to) const;
+
+private:
+    static constexpr size_t kNodeCount = EmotionEngine::kEmotionCount;
+
+    size_t nodeCount_;
+    std::array<std::array<float, kNodeCount>, kNodeCount> cost_{};
+    std::array<std::array<uint8_t, kNodeCount>, kNodeCount> next_{};
+};
+
+// A path sampled into a fixed table of MorphFrames, evenly spaced by
+// distance travelled. Within each hop the attributes are linear between
+// the two nodes. Built on the message thread. frameAt() is O(1) and
+// allocation-free: two table reads, then a lerp. Trivially copyable, so
+// it can be handed to the audio thread through a TripleBuffer.
+class EmotionTrajectory {
+public:
+    static constexpr size_t kTableSize = 512;
+
+    // False for unknown IDs; the trajectory is left unchanged
+    bool build(const EmotionEngine& engine, const EmotionPathTable& paths, int from, int to);
+
+    bool isValid() const { return valid_; }
+    int getFrom() const { return from_; }
+    int getTo() const { return to_; }
+
+    // progress is clamped to [0, 1]
+    MorphFrame frameAt(float progress) const noexcept;
+
+    // Raw image of a valid trajectory for saved state: the frame table, then
+    // the from and to IDs. Reading rejects, leaving the trajectory unchanged,
+    // images whose IDs are not engine nodes or whose frames are not finite
+    // and in range. Only a successful read marks the trajectory valid.
+    static constexpr size_t kImageSize = kTableSize * sizeof(MorphFrame) + 2 * sizeof(int16_t);
+    void writeImage(std::span<std::byte, kImageSize> out) const;
+    bool readImage(std::span<const std::byte, kImageSize> in);
+
+private:
+    std::array<MorphFrame, kTableSize> table_{};
+    int16_t from_ = -1;
+    int16_t to_ = -1;
+    bool valid_ = false;
+};
+
+// Plays an EmotionTrajectory against the host playhead. The message
+// thread starts or stops it through a TripleBuffer. The audio thread
+// anchors a new trajectory at the playhead of the first block that sees
+// it and reads one frame per block. After the end it holds the last
+// frame until stopped.
+class TrajectoryPlayer {
+public:
+    // Message thread (single producer). startProgress resumes part way
+    // through, e.g. after restoring saved state.
+    void start(const EmotionTrajectory& trajectory, uint64_t lengthTicks, float startProgress = 0.0f);
+    void stop();
+
+    // Message thread: the path node the audio thread last played for the
+    // latest start(), or -1 if stopped or the audio thread hasn't reached it yet
+    int getCurrentEmotion() const;
+    // Any thread: progress of the last block, or -1 with nothing playing
+    float getProgress() const { return progress_.load(std::memory_order_relaxed); }
+
+    // Audio thread: the frame at tick, or null with no trajectory
+    const MorphFrame* advance(uint64_t tick) noexcept;
+
+private:
+    struct Automation {
+        EmotionTrajectory trajectory;
+        uint64_t lengthTicks = 0;
+        uint64_t startOffset = 0;  // ticks already played at the anchor
+        uint32_t serial = 0;
+        bool active = false;
+    };
+
+    TripleBuffer<Automation> automation_;
+    uint32_t serial_ = 0;  // message thread
+
+    // Audio thread
+    uint32_t anchoredSerial_ = 0;
+    uint64_t startTick_ = 0;
+    MorphFrame frame_;
+
+    std::atomic<uint64_t> current_{0};  // serial << 32 | emotion ID + 1
+    std::atomic<float> progress_{-1.0f};
+};
+
+} // namespace kelly
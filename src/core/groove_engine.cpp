@@ -0,0 +1,160 @@
+#include "groove_engine.h"
+#include <algorithm>
+#include <cmath>
+
+namespace kelly {
+
+namespace {
+
+constexpr int32_t kUnityScale = 256;  // Q8 fixed point
+
+int32_t toQ8(float amount) {
+    return static_cast<int32_t>(std::lround(std::clamp(amount, 0.0f, 1.0f) * kUnityScale));
+}
+
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Uniform in [-range, range]
+int32_t jitter(uint32_t& state, uint32_t range) {
+    return range == 0
+        ? 0
+        : static_cast<int32_t>(nextRandom(state) % (2 * range + 1)) - static_cast<int32_t>(range);
+}
+
+} // namespace
+
+GrooveGrid::GrooveGrid(const GrooveTemplate& groove, uint32_t ppq)
+    : ppq_(std::max<uint32_t>(ppq, 1)) {
+    const uint32_t numerator = static_cast<uint32_t>(std::max(groove.numerator, 1));
+    const uint32_t denominator = static_cast<uint32_t>(groove.denominator > 0 ? groove.denominator : 4);
+    ticksPerBeat_ = std::max<uint32_t>(ppq_ * 4 / denominator, 1);
+    ticksPerBar_ = numerator * ticksPerBeat_;
+
+    deltaTicks_.assign(ticksPerBar_, 0);
+    velocityScale_.assign(ticksPerBar_, kUnityScale);
+    if (groove.pattern.empty()) {
+        return;
+    }
+
+    struct Slot {
+        uint32_t tick;
+        int velocity;
+    };
+    std::vector<Slot> slots;
+    slots.reserve(groove.pattern.size());
+    int maxVelocity = 1;
+    for (const auto& [position, velocity] : groove.pattern) {
+        const float wrapped = position - std::floor(position);
+        const auto tick = static_cast<uint32_t>(std::lround(wrapped * static_cast<float>(ticksPerBar_))) % ticksPerBar_;
+        slots.push_back(Slot{swingTick(tick, groove.swing), std::clamp(velocity, 1, 127)});
+        maxVelocity = std::max(maxVelocity, slots.back().velocity);
+    }
+    std::stable_sort(slots.begin(), slots.end(), [](const Slot& a, const Slot& b) { return a.tick < b.tick; });
+    slots.erase(std::unique(slots.begin(), slots.end(),
+                            [](const Slot& a, const Slot& b) { return a.tick == b.tick; }),
+                slots.end());
+
+    slotTicks_.reserve(slots.size());
+    for (const Slot& slot : slots) {
+        slotTicks_.push_back(slot.tick);
+    }
+
+    // One sweep: for every offset, the nearest slot, wrapping into the next bar.
+    // Halfway points go to the earlier slot.
+    size_t next = 0;
+    for (uint32_t offset = 0; offset < ticksPerBar_; ++offset) {
+        while (next < slots.size() && slots[next].tick < offset) {
+            ++next;
+        }
+        const Slot& before = next > 0 ? slots[next - 1] : slots.back();
+        const int64_t beforeTick = next > 0 ? before.tick : static_cast<int64_t>(before.tick) - ticksPerBar_;
+        const Slot& after = next < slots.size() ? slots[next] : slots.front();
+        const int64_t afterTick = next < slots.size() ? after.tick : static_cast<int64_t>(after.tick) + ticksPerBar_;
+
+        const bool takeBefore = (offset - beforeTick) <= (afterTick - offset);
+        const Slot& nearest = takeBefore ? before : after;
+        deltaTicks_[offset] = static_cast<int32_t>((takeBefore ? beforeTick : afterTick) - offset);
+        velocityScale_[offset] = static_cast<uint16_t>(nearest.velocity * kUnityScale / maxVelocity);
+    }
+}
+
+uint32_t GrooveGrid::swingTick(uint32_t tick, float swing) const {
+    if (swing <= 0.0f || swing >= 1.0f) {
+        return tick;
+    }
+
+    // Piecewise-linear warp of each beat: the first half stretches to swing,
+    // the second half compresses into what is left
+    const uint32_t beatStart = tick - tick % ticksPerBeat_;
+    const double within = static_cast<double>(tick - beatStart) / ticksPerBeat_;
+    const double warped = within <= 0.5
+        ? within * 2.0 * swing
+        : swing + (within - 0.5) * 2.0 * (1.0 - swing);
+    return (beatStart + static_cast<uint32_t>(std::lround(warped * ticksPerBeat_))) % ticksPerBar_;
+}
+
+void GrooveGrid::apply(std::span<MidiNote> notes, const GrooveSettings& settings, int bpm) const {
+    const int32_t strength = toQ8(settings.strength);
+    const int32_t velocityAmount = toQ8(settings.velocityAmount);
+    const uint32_t humanizeTicks = bpm > 0 && settings.humanizeMs > 0.0f
+        ? static_cast<uint32_t>(std::lround(settings.humanizeMs * static_cast<float>(ppq_) * bpm / 60000.0f))
+        : 0;
+    const uint32_t humanizeVelocity = settings.humanizeVelocity;
+    uint32_t rng = settings.seed != 0 ? settings.seed : 1;
+
+    const int32_t* delta = deltaTicks_.data();
+    const uint16_t* scale = velocityScale_.data();
+    const uint32_t ticksPerBar = ticksPerBar_;
+
+    for (MidiNote& note : notes) {
+        const uint32_t offset = note.time % ticksPerBar;
+
+        int64_t time = static_cast<int64_t>(note.time) + ((delta[offset] * strength) >> 8);
+        time += jitter(rng, humanizeTicks);
+        note.time = static_cast<uint32_t>(std::max<int64_t>(time, 0));
+
+        const int32_t velocityScale = kUnityScale + (((scale[offset] - kUnityScale) * velocityAmount) >> 8);
+        const int32_t velocity = ((note.velocity * velocityScale) >> 8) + jitter(rng, humanizeVelocity);
+        note.velocity = static_cast<uint8_t>(std::clamp(velocity, 1, 127));
+    }
+}
+
+const GrooveGrid* GrooveEngine::getGrid(const GrooveTemplates& templates, int templateId, uint32_t ppq) {
+    const GrooveTemplate* groove = templates.getTemplate(templateId);
+    if (groove == nullptr) {
+        return nullptr;
+    }
+
+    const uint64_t revision = templates.getRevision(templateId);
+    for (CachedGrid& cached : grids_) {
+        if (cached.templateId != templateId || cached.ppq != ppq) {
+            continue;
+        }
+        if (cached.revision != revision) {
+            // Replaced template: rebuild in place rather than keep the stale grid
+            cached.revision = revision;
+            cached.grid = GrooveGrid(*groove, ppq);
+        }
+        return &cached.grid;
+    }
+    grids_.push_back(CachedGrid{templateId, revision, ppq, GrooveGrid(*groove, ppq)});
+    return &grids_.back().grid;
+}
+
+bool GrooveEngine::apply(MidiPipeline& pipeline, const GrooveTemplates& templates, int templateId,
+                         const GrooveSettings& settings, uint32_t ppq) {
+    const GrooveGrid* grid = getGrid(templates, templateId, ppq);
+    if (grid == nullptr) {
+        return false;
+    }
+    const int bpm = pipeline.getTempo();
+    pipeline.editNotes([&](std::span<MidiNote> notes) { grid->apply(notes, settings, bpm); });
+    return true;
+}
+
+} // namespace kelly
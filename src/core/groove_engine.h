@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+#include "groove_templates.h"
+#include "midi_pipeline.h"
+
+namespace kelly {
+
+struct GrooveSettings {
+    float strength = 1.0f;        // 0 = leave timing alone, 1 = snap to the groove
+    float velocityAmount = 1.0f;  // 0 = keep velocities, 1 = full pattern accents
+    float humanizeMs = 0.0f;      // max random timing offset, either direction
+    uint8_t humanizeVelocity = 0; // max random velocity offset, either direction
+    uint32_t seed = 1;
+};
+
+// A GrooveTemplate compiled for one PPQ into integer tables indexed by the
+// tick offset within a bar: how far to move a note starting there and how
+// to scale its velocity. Applying it is a table lookup per note with no
+// float conversion, so a whole span is grooved in one branch-free pass.
+//
+// Pattern positions are fractions of a bar (as in the Python MidiGenerator).
+// Swing is where the off-beat eighth lands as a fraction of the beat, e.g.
+// 0.66 for a triplet feel; 0 leaves the grid straight.
+class GrooveGrid {
+public:
+    GrooveGrid(const GrooveTemplate& groove, uint32_t ppq = 480);
+    ~GrooveGrid() = default;
+
+    uint32_t getPpq() const { return ppq_; }
+    uint32_t getTicksPerBar() const { return ticksPerBar_; }
+    std::span<const uint32_t> getSlotTicks() const { return slotTicks_; }  // swing applied
+
+    // bpm converts humanizeMs to ticks
+    void apply(std::span<MidiNote> notes, const GrooveSettings& settings = {}, int bpm = 120) const;
+
+private:
+    uint32_t swingTick(uint32_t tick, float swing) const;
+
+    uint32_t ppq_;
+    uint32_t ticksPerBeat_;
+    uint32_t ticksPerBar_;
+    std::vector<uint32_t> slotTicks_;
+    std::vector<int32_t> deltaTicks_;     // per bar offset, to the nearest slot
+    std::vector<uint16_t> velocityScale_;  // per bar offset, 256 = unchanged
+};
+
+// Caches one GrooveGrid per (template ID, revision, PPQ) and applies it to
+// pipelines. Replacing a template with addTemplate bumps its revision, so
+// the stale grid is rebuilt on the next request.
+class GrooveEngine {
+public:
+    GrooveEngine() = default;
+    ~GrooveEngine() = default;
+
+    // nullptr if the ID is unknown. The grid stays valid until a later call
+    // rebuilds it for a replaced template.
+    const GrooveGrid* getGrid(const GrooveTemplates& templates, int templateId, uint32_t ppq = 480);
+
+    // Grooves every note in place, honouring the pipeline tempo; order is kept
+    // sorted. False if the ID is unknown.
+    bool apply(MidiPipeline& pipeline, const GrooveTemplates& templates, int templateId,
+               const GrooveSettings& settings = {}, uint32_t ppq = 480);
+
+    void invalidate() { grids_.clear(); }
+
+private:
+    struct CachedGrid {
+        int templateId;
+        uint64_t revision;
+        uint32_t ppq;
+        GrooveGrid grid;
+    };
+
+    std::deque<CachedGrid> grids_;  // stable references across inserts
+};
+
+} // namespace kelly
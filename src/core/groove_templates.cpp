@@ -1,4 +1,8 @@
 #include "groove_templates.h"
+#include "audio_thread.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 
 namespace kelly {
 
@@ -6,37 +10,93 @@ GrooveTemplates::GrooveTemplates() {
     initializeTemplates();
 }
 
+GrooveTemplatesHandle GrooveTemplates::shared() {
+    static std::mutex mutex;
+    static std::weak_ptr<const GrooveTemplates> current;
+
+    AudioThreadScope::noteLock();
+    std::lock_guard<std::mutex> lock(mutex);
+    GrooveTemplatesHandle templates = current.lock();
+    if (!templates) {
+        templates = std::make_shared<const GrooveTemplates>();
+        current = templates;
+    }
+    return templates;
+}
+
 void GrooveTemplates::initializeTemplates() {
-    templates_["straight"] = GrooveTemplate{
+    addTemplate("straight", GrooveTemplate{
         "Straight", 4, 4,
         {{0.0f, 100}, {0.25f, 80}, {0.5f, 100}, {0.75f, 80}},
         0.0f
-    };
+    });
     
-    templates_["swing"] = GrooveTemplate{
+    // Positions are already swung, so GrooveGrid must not swing them again
+    addTemplate("swing", GrooveTemplate{
         "Swing", 4, 4,
         {{0.0f, 100}, {0.33f, 80}, {0.5f, 100}, {0.83f, 80}},
-        0.66f
-    };
+        0.0f
+    });
     
-    templates_["syncopated"] = GrooveTemplate{
+    addTemplate("syncopated", GrooveTemplate{
         "Syncopated", 4, 4,
         {{0.0f, 100}, {0.125f, 60}, {0.375f, 90}, {0.625f, 85}, {0.875f, 70}},
         0.0f
-    };
+    });
 }
 
-const GrooveTemplate* GrooveTemplates::getTemplate(const std::string& name) const {
-    auto it = templates_.find(name);
-    return (it != templates_.end()) ? &it->second : nullptr;
+int GrooveTemplates::addTemplate(std::string_view key, GrooveTemplate groove) {
+    // Process-wide, so a revision also tells libraries apart
+    static std::atomic<uint64_t> nextRevision{1};
+    const uint64_t revision = nextRevision.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto it = index_.find(key); it != index_.end()) {
+        templates_[it->second] = std::move(groove);
+        revisions_[it->second] = revision;
+        return it->second;
+    }
+
+    const int id = static_cast<int>(templates_.size());
+    templates_.push_back(std::move(groove));
+    revisions_.push_back(revision);
+    const std::string_view storedKey = index_.emplace(std::string(key), id).first->first;
+    keys_.push_back(storedKey);
+    sortedKeys_.insert(std::upper_bound(sortedKeys_.begin(), sortedKeys_.end(), storedKey), storedKey);
+    return id;
 }
 
-std::vector<std::string> GrooveTemplates::getTemplateNames() const {
-    std::vector<std::string> names;
-    for (const auto& [name, _] : templates_) {
-        names.push_back(name);
+int GrooveTemplates::findTemplateId(std::string_view key) const {
+    auto it = index_.find(key);
+    return (it != index_.end()) ? it->second : -1;
+}
+
+const GrooveTemplate* GrooveTemplates::getTemplate(int templateId) const {
+    if (templateId < 0 || static_cast<size_t>(templateId) >= templates_.size()) {
+        return nullptr;
     }
-    return names;
+    return &templates_[static_cast<size_t>(templateId)];
+}
+
+const GrooveTemplate* GrooveTemplates::getTemplate(std::string_view key) const {
+    return getTemplate(findTemplateId(key));
+}
+
+uint64_t GrooveTemplates::getRevision(int templateId) const {
+    if (templateId < 0 || static_cast<size_t>(templateId) >= revisions_.size()) {
+        return 0;
+    }
+    return revisions_[static_cast<size_t>(templateId)];
+}
+
+std::string_view GrooveTemplates::getTemplateKey(int templateId) const {
+    if (templateId < 0 || static_cast<size_t>(templateId) >= keys_.size()) {
+        return {};
+    }
+    return keys_[static_cast<size_t>(templateId)];
+}
+
+std::vector<std::string> GrooveTemplates::getTemplateNames() const {
+    return std::vector<std::string>(sortedKeys_.begin(), sortedKeys_.end());
 }
 
 } // namespace kelly
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include <deque>
+#include <span>
+#include <unordered_map>
+#include <functional>
+#include <memory>
 
 namespace kelly {
 
@@ -14,17 +20,55 @@ struct GrooveTemplate {
     float swing = 0.0f;
 };
 
+class GrooveTemplates;
+using GrooveTemplatesHandle = std::shared_ptr<const GrooveTemplates>;
+
+// Templates are addressed by key ("swing") or by a dense integer ID that
+// stays valid for the lifetime of the library. Resolve a key once with
+// findTemplateId and keep the ID for repeated access.
 class GrooveTemplates {
 public:
     GrooveTemplates();
     ~GrooveTemplates() = default;
 
-    const GrooveTemplate* getTemplate(const std::string& name) const;
+    // Built-in library shared read-only by every plugin instance, built on
+    // first request (thread-safe) and kept while a handle exists
+    static GrooveTemplatesHandle shared();
+
+    // Adds or replaces a template and returns its ID; replacing keeps the ID.
+    // Template addresses stay stable as more are added.
+    int addTemplate(std::string_view key, GrooveTemplate groove);
+
+    // -1 if unknown; no allocation
+    int findTemplateId(std::string_view key) const;
+    const GrooveTemplate* getTemplate(int templateId) const;
+    const GrooveTemplate* getTemplate(std::string_view key) const;
+
+    // Changes whenever addTemplate replaces the template, and is unique
+    // across libraries, so (ID, revision) names one template's contents.
+    // 0 if the ID is unknown.
+    uint64_t getRevision(int templateId) const;
+
+    size_t getTemplateCount() const { return templates_.size(); }
+    std::string_view getTemplateKey(int templateId) const;
+
+    // Keys sorted alphabetically; views stay valid until the library is destroyed
+    std::span<const std::string_view> getTemplateKeys() const { return sortedKeys_; }
     std::vector<std::string> getTemplateNames() const;
 
 private:
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
     void initializeTemplates();
-    std::map<std::string, GrooveTemplate> templates_;
+
+    std::deque<GrooveTemplate> templates_;  // indexed by ID
+    std::vector<uint64_t> revisions_;       // by ID
+    std::unordered_map<std::string, int, KeyHash, std::equal_to<>> index_;
+    std::vector<std::string_view> keys_;  // by ID, viewing index_ keys
+    std::vector<std::string_view> sortedKeys_;
 };
 
 } // namespace kelly
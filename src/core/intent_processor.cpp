@@ -1,102 +1,197 @@
 #include "intent_processor.h"
+#include "profiling.h"
+#include "emotion_catalog.h"
 #include <algorithm>
-#include <cctype>
+#include <cstdint>
+#include <thread>
+#include <utility>
 
 namespace kelly {
 
-IntentProcessor::IntentProcessor() = default;
+namespace {
+
+// Fallback target for wound classification, resolved at compile time
+constexpr int kMelancholyId = emotionIdFromName("melancholy");
+static_assert(kMelancholyId >= 0);
+
+} // namespace
+
+IntentProcessor::IntentProcessor(size_t historyDepth, EmotionModelHandle model)
+    : model_(model ? std::move(model) : EmotionModel::shared()),
+      engine_(model_->getEngine()),
+      matcher_(model_->getWoundMatcher()),
+      woundHistory_(historyDepth),
+      ruleBreaks_(historyDepth * kMaxRuleBreaksPerWound) {}
 
 const EmotionNode* IntentProcessor::processWound(const Wound& wound) {
-    woundHistory_.push_back(wound);
-
-    std::string desc = wound.description;
-    std::transform(desc.begin(), desc.end(), desc.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-
-    if (desc.find("loss") != std::string::npos ||
-        desc.find("grief") != std::string::npos) {
-        return engine_.findEmotionByName("grief");
-    } else if (desc.find("anger") != std::string::npos ||
-               desc.find("rage") != std::string::npos) {
-        return engine_.findEmotionByName("rage");
-    } else if (desc.find("fear") != std::string::npos ||
-               desc.find("anxiety") != std::string::npos) {
-        return engine_.findEmotionByName("anxiety");
+    const EmotionNode* emotion = classifyWound(wound);
+    recordWound(wound, emotion);
+    return emotion;
+}
+
+const EmotionNode* IntentProcessor::classifyWound(const Wound& wound) const {
+    KELLY_ZONE();
+    std::array<float, EmotionEngine::kEmotionCount> scores{};
+    std::array<uint32_t, EmotionEngine::kEmotionCount> firstKeyword;
+    firstKeyword.fill(UINT32_MAX);
+
+    matcher_.forEachMatch(wound.description, [&](const KeywordMatch& match) {
+        scores[match.emotionId] += match.weight;
+        firstKeyword[match.emotionId] = std::min(firstKeyword[match.emotionId], match.keywordIndex);
+    });
+
+    int best = -1;
+    for (int id = 0; id < static_cast<int>(scores.size()); ++id) {
+        if (scores[id] <= 0.0f) continue;
+        if (best < 0 || scores[id] > scores[best] ||
+            (scores[id] == scores[best] && firstKeyword[id] < firstKeyword[best])) {
+            best = id;
+        }
     }
 
-    return engine_.findEmotionByName("melancholy");
+    return engine_.getEmotion(best >= 0 ? best : kMelancholyId);
+}
+
+std::array<float, kEmotionCategoryCount> IntentProcessor::scoreCategories(std::string_view description) const {
+    std::array<float, kEmotionCategoryCount> scores{};
+    const auto categories = engine_.categories();
+    matcher_.forEachMatch(description, [&](const KeywordMatch& match) {
+        scores[static_cast<size_t>(categories[match.emotionId])] += match.weight;
+    });
+    return scores;
 }
 
 std::vector<RuleBreak> IntentProcessor::emotionToRuleBreaks(const EmotionNode& emotion) {
-    std::vector<RuleBreak> breaks;
-
-    // High intensity emotions break more rules
-    if (emotion.intensity > 0.8f) {
-        RuleBreak rb;
-        rb.ruleType = "dynamics";
-        rb.severity = emotion.intensity;
-        rb.description = "Extreme dynamic contrasts";
-        rb.musicalImpact["velocity_min"] = 10;
-        rb.musicalImpact["velocity_max"] = 127;
-        rb.musicalImpact["sudden_changes"] = true;
-        breaks.push_back(rb);
+    std::vector<RuleBreak> breaks = deriveRuleBreaks(emotion);
+    for (const auto& rb : breaks) {
+        recordRuleBreak(rb);
     }
+    return breaks;
+}
 
-    // Negative valence introduces dissonance
-    if (emotion.valence < -0.5f) {
-        RuleBreak rb;
-        rb.ruleType = "harmony";
-        rb.severity = std::abs(emotion.valence);
-        rb.description = "Dissonant intervals and clusters";
-        rb.musicalImpact["allow_dissonance"] = true;
-        rb.musicalImpact["cluster_probability"] = std::abs(emotion.valence);
-        breaks.push_back(rb);
+std::vector<RuleBreak> IntentProcessor::deriveRuleBreaks(const EmotionNode& emotion) const {
+    if (const CompiledEmotion* compiled = getCompiled(emotion)) {
+        return compiled->ruleBreaks;
     }
+    return ruleBreaksFor(emotion);
+}
 
-    // High arousal breaks rhythmic conventions
-    if (emotion.arousal > 0.7f) {
-        RuleBreak rb;
-        rb.ruleType = "rhythm";
-        rb.severity = emotion.arousal;
-        rb.description = "Irregular rhythms and syncopation";
-        rb.musicalImpact["syncopation_level"] = emotion.arousal;
-        rb.musicalImpact["irregular_meters"] = true;
-        breaks.push_back(rb);
+const CompiledEmotion* IntentProcessor::getCompiled(const EmotionNode& emotion) const {
+    // Only nodes of this engine are cached; any other node is compiled per call
+    return engine_.getEmotion(emotion.id) == &emotion ? model_->getCompiled(emotion.id) : nullptr;
+}
+
+MusicalParams IntentProcessor::compileMusicalParams(
+    const EmotionNode& emotion,
+    std::span<const RuleBreak> ruleBreaks
+) const {
+    return musicalParamsFor(emotion, ruleBreaks);
+}
+
+IntentResult IntentProcessor::mapIntent(const Wound& wound) const {
+    const EmotionNode* emotion = classifyWound(wound);
+
+    IntentResult result;
+    result.wound = wound;
+    result.emotion = emotion;
+    // classifyWound only returns this engine's nodes, so after a node's first
+    // use this is a table lookup. Extension maps are empty for the built-in
+    // rule breaks, so copying them does not allocate.
+    if (const CompiledEmotion* compiled = emotion ? getCompiled(*emotion) : nullptr) {
+        result.ruleBreaks = compiled->ruleBreaks;
+        result.musicalParams = compiled->musicalParams;
+        result.extensionParams = compiled->extensionParams;
     }
 
-    ruleBreaks_.insert(ruleBreaks_.end(), breaks.begin(), breaks.end());
-    return breaks;
+    return result;
 }
 
-std::map<std::string, std::any> IntentProcessor::compileMusicalParams(
-    const EmotionNode& emotion,
-    const std::vector<RuleBreak>& ruleBreaks
-) {
-    std::map<std::string, std::any> params;
-    params["tempo_modifier"] = emotion.musicalAttributes.tempoModifier;
-    params["mode"] = emotion.musicalAttributes.mode;
-    params["dynamics"] = emotion.musicalAttributes.dynamics;
-
-    for (const auto& rb : ruleBreaks) {
-        for (const auto& [key, value] : rb.musicalImpact) {
-            params[key] = value;
+void IntentProcessor::recordIntent(const IntentResult& result) {
+    recordWound(result.wound, result.emotion);
+    for (const auto& rb : result.ruleBreaks) {
+        recordRuleBreak(rb);
+    }
+}
+
+void IntentProcessor::recordWound(const Wound& wound, const EmotionNode* emotion) {
+    if (woundHistory_.full()) {
+        if (const EmotionNode* evicted = engine_.getEmotion(woundHistory_.front().emotionId)) {
+            valenceSum_ -= evicted->valence;
+            arousalSum_ -= evicted->arousal;
+            --emotionCount_;
         }
     }
 
-    return params;
+    woundHistory_.push(IntentHistoryEntry{wound, emotion ? emotion->id : -1});
+    ++summary_.totalWounds;
+
+    if (emotion) {
+        valenceSum_ += emotion->valence;
+        arousalSum_ += emotion->arousal;
+        ++emotionCount_;
+    }
+    summary_.meanValence = emotionCount_ ? static_cast<float>(valenceSum_ / emotionCount_) : 0.0f;
+    summary_.meanArousal = emotionCount_ ? static_cast<float>(arousalSum_ / emotionCount_) : 0.0f;
 }
 
-IntentResult IntentProcessor::processIntent(const Wound& wound) {
-    const EmotionNode* emotion = processWound(wound);
-    std::vector<RuleBreak> breaks = emotion ? emotionToRuleBreaks(*emotion) : std::vector<RuleBreak>{};
+void IntentProcessor::recordRuleBreak(const RuleBreak& ruleBreak) {
+    if (ruleBreaks_.full()) {
+        --summary_.ruleBreakCounts[static_cast<size_t>(ruleBreaks_.front().type)];
+    }
+    ruleBreaks_.push(ruleBreak);
+    ++summary_.ruleBreakCounts[static_cast<size_t>(ruleBreak.type)];
+}
 
-    IntentResult result;
-    result.wound = wound;
-    result.emotion = emotion;
-    result.ruleBreaks = breaks;
-    result.musicalParams = emotion ? compileMusicalParams(*emotion, breaks) : std::map<std::string, std::any>{};
+void IntentProcessor::clearHistory() {
+    woundHistory_.clear();
+    ruleBreaks_.clear();
+    summary_ = IntentSummary{};
+    valenceSum_ = 0.0;
+    arousalSum_ = 0.0;
+    emotionCount_ = 0;
+}
 
+IntentResult IntentProcessor::processIntent(const Wound& wound) {
+    KELLY_ZONE();
+    IntentResult result = mapIntent(wound);
+    recordIntent(result);
     return result;
 }
 
+std::vector<IntentResult> IntentProcessor::processIntents(std::span<const Wound> wounds) {
+    KELLY_ZONE();
+    KELLY_ZONE_VALUE(wounds.size());
+    std::vector<IntentResult> results(wounds.size());
+
+    // mapIntent only reads the engine, so chunks can be mapped concurrently;
+    // history is appended afterwards in input order.
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const size_t workers = std::min(hardware, (wounds.size() + kMinWoundsPerWorker - 1) / kMinWoundsPerWorker);
+
+    auto mapRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = mapIntent(wounds[i]);
+        }
+    };
+
+    if (workers <= 1) {
+        mapRange(0, wounds.size());
+    } else {
+        const size_t chunk = (wounds.size() + workers - 1) / workers;
+        std::vector<std::jthread> threads;
+        threads.reserve(workers - 1);
+        for (size_t w = 1; w < workers; ++w) {
+            threads.emplace_back(mapRange, std::min(w * chunk, wounds.size()),
+                                 std::min((w + 1) * chunk, wounds.size()));
+        }
+        mapRange(0, std::min(chunk, wounds.size()));
+    }
+
+    for (const auto& result : results) {
+        recordIntent(result);
+    }
+
+    return results;
+}
+
 } // namespace kelly
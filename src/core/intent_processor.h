@@ -4,7 +4,15 @@
 #include <vector>
 #include <map>
 #include <any>
+#include <span>
+#include <array>
 #include "emotion_engine.h"
+#include "emotion_model.h"
+#include "musical_params.h"
+#include "ring_buffer.h"
+#include "keyword_matcher.h"
+#include "emotion_catalog.h"
+#include "rule_breaks.h"
 
 namespace kelly {
 
@@ -20,38 +28,92 @@ struct Wound {
     std::string source;
 };
 
-struct RuleBreak {
-    std::string ruleType;  // e.g., "harmony", "rhythm", "dynamics"
-    float severity;        // 0.0 to 1.0
-    std::string description;
-    std::map<std::string, std::any> musicalImpact;
-};
-
+// ruleBreaks views the model's CompiledEmotion for the node, like emotion
+// points at its node: both stay valid while the processor's model lives.
 struct IntentResult {
     Wound wound;
     const EmotionNode* emotion;
-    std::vector<RuleBreak> ruleBreaks;
-    std::map<std::string, std::any> musicalParams;
+    std::span<const RuleBreak> ruleBreaks;
+    MusicalParams musicalParams;
+    std::map<std::string, std::any> extensionParams;  // merged RuleBreak::musicalImpact
+};
+
+struct IntentHistoryEntry {
+    Wound wound;
+    int emotionId = -1;
+};
+
+// Maintained incrementally as history entries arrive and are evicted
+struct IntentSummary {
+    size_t totalWounds = 0;      // recorded since construction or clearHistory()
+    float meanValence = 0.0f;    // over the retained wound history
+    float meanArousal = 0.0f;
+    std::array<size_t, kRuleBreakTypeCount> ruleBreakCounts{};  // over the retained rule breaks
 };
 
 class IntentProcessor {
 public:
-    IntentProcessor();
+    static constexpr size_t kDefaultHistoryDepth = 256;
+
+    // Keeps the last historyDepth wounds and historyDepth × 3 rule breaks.
+    // Processors share one immutable model; a null handle means EmotionModel::shared().
+    explicit IntentProcessor(size_t historyDepth = kDefaultHistoryDepth,
+                             EmotionModelHandle model = nullptr);
     ~IntentProcessor() = default;
 
     const EmotionNode* processWound(const Wound& wound);
     std::vector<RuleBreak> emotionToRuleBreaks(const EmotionNode& emotion);
     IntentResult processIntent(const Wound& wound);
 
-private:
-    std::map<std::string, std::any> compileMusicalParams(
+    // Maps the batch across cores, then records it in input order.
+    // Results match calling processIntent on each wound in turn.
+    std::vector<IntentResult> processIntents(std::span<const Wound> wounds);
+
+    // Stateless stages: safe to call concurrently, never touch the history
+    const EmotionNode* classifyWound(const Wound& wound) const;
+    std::vector<RuleBreak> deriveRuleBreaks(const EmotionNode& emotion) const;
+    IntentResult mapIntent(const Wound& wound) const;
+
+    // Rule breaks and params for one of this model's nodes, compiled on first
+    // use and shared by every processor on the model. Null for nodes that
+    // belong to another engine.
+    const CompiledEmotion* getCompiled(const EmotionNode& emotion) const;
+
+    // Summed keyword weights per EmotionCategory, in enum order
+    std::array<float, kEmotionCategoryCount> scoreCategories(std::string_view description) const;
+
+    // Pure: the node's musical attributes with each rule break's impact applied
+    MusicalParams compileMusicalParams(
         const EmotionNode& emotion,
-        const std::vector<RuleBreak>& ruleBreaks
-    );
+        std::span<const RuleBreak> ruleBreaks
+    ) const;
+
+    const EmotionEngine& getEngine() const { return engine_; }
+    const EmotionModelHandle& getModel() const { return model_; }
+
+    const RingBuffer<IntentHistoryEntry>& getHistory() const { return woundHistory_; }
+    const RingBuffer<RuleBreak>& getRuleBreakHistory() const { return ruleBreaks_; }
+    const IntentSummary& getSummary() const { return summary_; }
+    void clearHistory();
+
+private:
+    static constexpr size_t kMinWoundsPerWorker = 64;
+    static constexpr size_t kMaxRuleBreaksPerWound = 3;
+
+    void recordIntent(const IntentResult& result);
+    void recordWound(const Wound& wound, const EmotionNode* emotion);
+    void recordRuleBreak(const RuleBreak& ruleBreak);
+
+    EmotionModelHandle model_;
+    const EmotionEngine& engine_;  // both owned by model_
+    const KeywordMatcher& matcher_;
+    RingBuffer<IntentHistoryEntry> woundHistory_;
+    RingBuffer<RuleBreak> ruleBreaks_;
 
-    EmotionEngine engine_;
-    std::vector<Wound> woundHistory_;
-    std::vector<RuleBreak> ruleBreaks_;
+    IntentSummary summary_;
+    double valenceSum_ = 0.0;
+    double arousalSum_ = 0.0;
+    size_t emotionCount_ = 0;  // retained entries that mapped to an emotion
 };
 
 } // namespace kelly
@@ -0,0 +1,246 @@
+#include "json_reader.h"
+#include <charconv>
+#include <cstdint>
+#include <locale>
+#include <sstream>
+
+namespace kelly {
+
+const JsonValue* JsonValue::find(std::string_view key) const {
+    for (const auto& [name, value] : members_) {
+        if (name == key) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text) : text_(text) {}
+
+    std::optional<JsonValue> parseDocument() {
+        JsonValue value;
+        if (!parseValue(value, 0)) {
+            return std::nullopt;
+        }
+        skipWhitespace();
+        if (pos_ != text_.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+private:
+    static constexpr int kMaxDepth = 256;
+
+    void skipWhitespace() {
+        while (pos_ < text_.size()
+               && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char expected) {
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == expected) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool consumeLiteral(std::string_view literal) {
+        if (text_.substr(pos_, literal.size()) != literal) {
+            return false;
+        }
+        pos_ += literal.size();
+        return true;
+    }
+
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > kMaxDepth) {
+            return false;
+        }
+        skipWhitespace();
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+
+        switch (text_[pos_]) {
+            case '{': return parseObject(out, depth);
+            case '[': return parseArray(out, depth);
+            case '"':
+                out.type_ = JsonValue::Type::String;
+                return parseString(out.string_);
+            case 't':
+                out.type_ = JsonValue::Type::Bool;
+                out.bool_ = true;
+                return consumeLiteral("true");
+            case 'f':
+                out.type_ = JsonValue::Type::Bool;
+                return consumeLiteral("false");
+            case 'n':
+                return consumeLiteral("null");
+            default:
+                return parseNumber(out);
+        }
+    }
+
+    bool parseObject(JsonValue& out, int depth) {
+        out.type_ = JsonValue::Type::Object;
+        ++pos_;  // '{'
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            skipWhitespace();
+            std::string key;
+            if (pos_ >= text_.size() || text_[pos_] != '"' || !parseString(key) || !consume(':')) {
+                return false;
+            }
+            JsonValue value;
+            if (!parseValue(value, depth + 1)) {
+                return false;
+            }
+            out.members_.emplace_back(std::move(key), std::move(value));
+        } while (consume(','));
+        return consume('}');
+    }
+
+    bool parseArray(JsonValue& out, int depth) {
+        out.type_ = JsonValue::Type::Array;
+        ++pos_;  // '['
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            JsonValue value;
+            if (!parseValue(value, depth + 1)) {
+                return false;
+            }
+            out.items_.push_back(std::move(value));
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool parseHex4(uint32_t& out) {
+        if (pos_ + 4 > text_.size()) {
+            return false;
+        }
+        const char* begin = text_.data() + pos_;
+        auto [end, error] = std::from_chars(begin, begin + 4, out, 16);
+        if (error != std::errc() || end != begin + 4) {
+            return false;
+        }
+        pos_ += 4;
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    bool parseString(std::string& out) {
+        ++pos_;  // opening quote
+        while (pos_ < text_.size()) {
+            const char c = text_[pos_++];
+            if (c == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return false;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                return false;
+            }
+            switch (text_[pos_++]) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t codePoint = 0;
+                    if (!parseHex4(codePoint)) {
+                        return false;
+                    }
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                        uint32_t low = 0;
+                        if (!consumeLiteral("\\u") || !parseHex4(low) || low < 0xDC00 || low >= 0xE000) {
+                            return false;
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, codePoint);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool parseNumber(JsonValue& out) {
+        // Validate the JSON grammar first; from_chars alone accepts e.g. "01" or "inf"
+        const size_t start = pos_;
+        if (pos_ < text_.size() && text_[pos_] == '-') ++pos_;
+        if (pos_ >= text_.size() || !isDigit(text_[pos_])) return false;
+        if (text_[pos_] == '0') {
+            ++pos_;
+        } else {
+            while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+        }
+        if (pos_ < text_.size() && text_[pos_] == '.') {
+            ++pos_;
+            if (pos_ >= text_.size() || !isDigit(text_[pos_])) return false;
+            while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+        }
+        if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+            ++pos_;
+            if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) ++pos_;
+            if (pos_ >= text_.size() || !isDigit(text_[pos_])) return false;
+            while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+        }
+
+        // Floating-point from_chars is missing from older libc++, so use a
+        // classic-locale stream; the grammar was already checked above
+        std::istringstream in(std::string(text_.substr(start, pos_ - start)));
+        in.imbue(std::locale::classic());
+        out.type_ = JsonValue::Type::Number;
+        return static_cast<bool>(in >> out.number_);
+    }
+
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    std::string_view text_;
+    size_t pos_ = 0;
+};
+
+std::optional<JsonValue> parseJson(std::string_view text) {
+    return JsonParser(text).parseDocument();
+}
+
+} // namespace kelly
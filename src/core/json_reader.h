@@ -0,0 +1,50 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace kelly {
+
+// Minimal JSON document model for offline data loading; not for the audio thread
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    JsonValue() = default;
+
+    Type getType() const { return type_; }
+    bool isNull() const { return type_ == Type::Null; }
+    bool isNumber() const { return type_ == Type::Number; }
+    bool isString() const { return type_ == Type::String; }
+    bool isArray() const { return type_ == Type::Array; }
+    bool isObject() const { return type_ == Type::Object; }
+
+    bool asBool() const { return bool_; }
+    double asNumber() const { return number_; }
+    const std::string& asString() const { return string_; }
+
+    // Empty unless the value is an array / object; members keep document order
+    const std::vector<JsonValue>& items() const { return items_; }
+    const std::vector<std::pair<std::string, JsonValue>>& members() const { return members_; }
+
+    // nullptr if not an object or the key is absent
+    const JsonValue* find(std::string_view key) const;
+
+private:
+    friend class JsonParser;
+
+    Type type_ = Type::Null;
+    bool bool_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<JsonValue> items_;
+    std::vector<std::pair<std::string, JsonValue>> members_;
+};
+
+// Strict RFC 8259 parse; std::nullopt on any syntax error
+std::optional<JsonValue> parseJson(std::string_view text);
+
+} // namespace kelly
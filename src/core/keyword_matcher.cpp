@@ -0,0 +1,93 @@
+#include "keyword_matcher.h"
+#include <algorithm>
+
+namespace kelly {
+
+KeywordMatcher::KeywordMatcher() {
+    trie_.emplace_back();
+    trie_.back().fill(-1);
+    trieOutputs_.emplace_back();
+}
+
+void KeywordMatcher::addKeyword(std::string_view keyword, int emotionId, float weight, bool wholeWord) {
+    if (keyword.empty()) {
+        return;
+    }
+
+    int32_t state = 0;
+    for (char c : keyword) {
+        const uint8_t symbol = classify(static_cast<unsigned char>(c));
+        if (trie_[state][symbol] < 0) {
+            trie_[state][symbol] = static_cast<int32_t>(trie_.size());
+            trie_.emplace_back();
+            trie_.back().fill(-1);
+            trieOutputs_.emplace_back();
+        }
+        state = trie_[state][symbol];
+    }
+
+    auto& outputs = trieOutputs_[state];
+    auto existing = std::find_if(outputs.begin(), outputs.end(),
+                                 [&](const Output& o) { return o.emotionId == emotionId; });
+    if (existing != outputs.end()) {
+        existing->weight = std::max(existing->weight, weight);
+        existing->wholeWord = existing->wholeWord && wholeWord;
+        built_ = false;
+        return;
+    }
+
+    outputs.push_back(Output{emotionId, weight, static_cast<uint32_t>(keywordCount_++),
+                             static_cast<uint32_t>(keyword.size()), wholeWord});
+    built_ = false;
+}
+
+void KeywordMatcher::build() {
+    const size_t stateCount = trie_.size();
+    transitions_.assign(stateCount * kAlphabetSize, 0);
+    std::vector<int32_t> failure(stateCount, 0);
+    std::vector<std::vector<Output>> merged = trieOutputs_;
+
+    // Breadth-first, so a state's failure target is always complete before it
+    std::vector<int32_t> queue;
+    queue.reserve(stateCount);
+
+    for (size_t symbol = 0; symbol < kAlphabetSize; ++symbol) {
+        const int32_t child = trie_[0][symbol];
+        if (child >= 0) {
+            transitions_[symbol] = child;
+            queue.push_back(child);
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int32_t state = queue[head];
+        const size_t row = static_cast<size_t>(state) * kAlphabetSize;
+        const size_t failRow = static_cast<size_t>(failure[state]) * kAlphabetSize;
+
+        for (size_t symbol = 0; symbol < kAlphabetSize; ++symbol) {
+            const int32_t child = trie_[state][symbol];
+            if (child < 0) {
+                transitions_[row + symbol] = transitions_[failRow + symbol];
+                continue;
+            }
+
+            transitions_[row + symbol] = child;
+            failure[child] = transitions_[failRow + symbol];
+            const auto& inherited = merged[failure[child]];
+            merged[child].insert(merged[child].end(), inherited.begin(), inherited.end());
+            queue.push_back(child);
+        }
+    }
+
+    outputBegin_.assign(stateCount + 1, 0);
+    outputs_.clear();
+    for (size_t state = 0; state < stateCount; ++state) {
+        outputBegin_[state] = static_cast<uint32_t>(outputs_.size());
+        outputs_.insert(outputs_.end(), merged[state].begin(), merged[state].end());
+    }
+    outputBegin_[stateCount] = static_cast<uint32_t>(outputs_.size());
+
+    built_ = true;
+}
+
+} // namespace kelly
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace kelly {
+
+struct KeywordMatch {
+    int emotionId;
+    float weight;
+    uint32_t keywordIndex;  // registration order, lower wins ties
+    size_t begin;           // byte offsets into the searched text
+    size_t end;
+};
+
+// Case-insensitive multi-pattern matcher (Aho-Corasick, compiled to a DFA).
+// Keywords match at the start of a word, so "fear" finds "fearful" but
+// "rage" does not fire inside "courage". Whole-word keywords must also end
+// at a separator, and no prefix match fires on a word negated by "-less"
+// ("fearless", "hopelessly"). Search cost is one table step per input byte
+// regardless of how many keywords are registered.
+class KeywordMatcher {
+public:
+    KeywordMatcher();
+    ~KeywordMatcher() = default;
+
+    // Registering the same keyword twice for one emotion keeps the larger
+    // weight, and prefix matching if either registration asked for it
+    void addKeyword(std::string_view keyword, int emotionId, float weight = 1.0f, bool wholeWord = false);
+
+    // Must be called after the last addKeyword and before searching
+    void build();
+
+    size_t getKeywordCount() const { return keywordCount_; }
+    size_t getStateCount() const { return trie_.size(); }
+
+    // Calls onMatch(const KeywordMatch&) for every match, in order of end position
+    template <typename Callback>
+    void forEachMatch(std::string_view text, Callback&& onMatch) const;
+
+private:
+    // Letters fold to 1..26; every other byte is a word separator (0)
+    static constexpr size_t kAlphabetSize = 27;
+
+    struct Output {
+        int emotionId;
+        float weight;
+        uint32_t keywordIndex;
+        uint32_t length;
+        bool wholeWord;
+    };
+
+    static constexpr uint8_t classify(unsigned char c) {
+        if (c >= 'a' && c <= 'z') return static_cast<uint8_t>(c - 'a' + 1);
+        if (c >= 'A' && c <= 'Z') return static_cast<uint8_t>(c - 'A' + 1);
+        return 0;
+    }
+
+    // The word continues with "less", turning the keyword into its opposite
+    static constexpr bool negatesWord(std::string_view rest) {
+        constexpr std::string_view kSuffix = "less";
+        if (rest.size() < kSuffix.size()) return false;
+        for (size_t i = 0; i < kSuffix.size(); ++i) {
+            if (classify(static_cast<unsigned char>(rest[i])) != classify(static_cast<unsigned char>(kSuffix[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Build-time trie; outputs are flattened into CSR form by build()
+    std::vector<std::array<int32_t, kAlphabetSize>> trie_;
+    std::vector<std::vector<Output>> trieOutputs_;
+    size_t keywordCount_ = 0;
+
+    // Search-time DFA
+    std::vector<int32_t> transitions_;  // state * kAlphabetSize + symbol
+    std::vector<uint32_t> outputBegin_;  // per state, plus one sentinel
+    std::vector<Output> outputs_;
+    bool built_ = false;
+};
+
+template <typename Callback>
+void KeywordMatcher::forEachMatch(std::string_view text, Callback&& onMatch) const {
+    if (!built_) {
+        return;
+    }
+
+    int32_t state = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        state = transitions_[static_cast<size_t>(state) * kAlphabetSize + classify(static_cast<unsigned char>(text[i]))];
+
+        for (uint32_t o = outputBegin_[state]; o < outputBegin_[state + 1]; ++o) {
+            const Output& out = outputs_[o];
+            const size_t begin = i + 1 - out.length;
+            if (begin > 0 && classify(static_cast<unsigned char>(text[begin - 1])) != 0) {
+                continue;  // not at a word start
+            }
+            if (i + 1 < text.size() && classify(static_cast<unsigned char>(text[i + 1])) != 0
+                && (out.wholeWord || negatesWord(text.substr(i + 1)))) {
+                continue;  // inside a longer word
+            }
+            onMatch(KeywordMatch{out.emotionId, out.weight, out.keywordIndex, begin, i + 1});
+        }
+    }
+}
+
+} // namespace kelly
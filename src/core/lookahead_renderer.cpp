@@ -0,0 +1,129 @@
+#include "lookahead_renderer.h"
+#include "profiling.h"
+#include <algorithm>
+#include <memory>
+
+namespace kelly {
+
+LookaheadRenderer::LookaheadRenderer(TaskPoolHandle pool, GrooveTemplatesHandle grooves)
+    : pool_(std::move(pool)),
+      grooves_(grooves ? std::move(grooves) : GrooveTemplates::shared()) {
+}
+
+LookaheadRenderer::~LookaheadRenderer() {
+    waitForRender();
+    freeRetired();
+    delete next_.exchange(nullptr, std::memory_order_acq_rel);
+    delete current_;
+}
+
+void LookaheadRenderer::setRequest(const PhraseRequest& request) {
+    request_ = request;
+    ++generation_;
+}
+
+void LookaheadRenderer::service() {
+    freeRetired();
+    if (generation_ == 0 || inFlight_->load(std::memory_order_acquire)) {
+        return;
+    }
+    if (isNextReady() && readyGeneration_.load(std::memory_order_acquire) == generation_) {
+        return;
+    }
+    submitRender();
+}
+
+void LookaheadRenderer::waitForRender() const {
+    inFlight_->wait(true, std::memory_order_acquire);
+}
+
+void LookaheadRenderer::submitRender() {
+    PhraseRequest request = request_;
+    request.seed += phraseCount_++;  // consecutive phrases vary
+    const uint64_t generation = generation_;
+
+    if (!pool_) {
+        pool_ = TaskPool::shared();
+    }
+    inFlight_->store(true, std::memory_order_release);
+    pool_->submit([this, inFlight = inFlight_, request, generation] {
+        KELLY_ZONE_NAMED("render phrase");
+        auto phrase = std::make_unique<RenderedPhrase>();
+        phrase->emotionId = request.emotionId;
+        phrase->generation = generation;
+        phrase->ppq = request.ppq;
+        phrase->lengthTicks = generator_.render(request, pipeline_);
+        phrase->barTicks = phrase->lengthTicks / std::clamp<uint32_t>(request.bars, 1, PhraseGenerator::kMaxBars);
+        rendered_ = *phrase;  // before the notes: they stay in pipeline_
+        hasRendered_ = true;
+        phrase->notes.assign(pipeline_.getNotes().begin(), pipeline_.getNotes().end());
+
+        // Whatever this displaces was never taken by the audio thread
+        delete next_.exchange(phrase.release(), std::memory_order_acq_rel);
+        readyGeneration_.store(generation, std::memory_order_release);
+
+        inFlight->store(false, std::memory_order_release);
+        inFlight->notify_all();
+    });
+}
+
+bool LookaheadRenderer::snapshot(RenderedPhrase& out) const {
+    waitForRender();
+    if (!hasRendered_) {
+        return false;
+    }
+    out = rendered_;
+    out.notes.assign(pipeline_.getNotes().begin(), pipeline_.getNotes().end());
+    return true;
+}
+
+void LookaheadRenderer::restore(const PhraseRequest& request, RenderedPhrase&& phrase) {
+    waitForRender();
+    setRequest(request);
+
+    rendered_ = RenderedPhrase{phrase.emotionId, generation_, phrase.ppq, phrase.barTicks, phrase.lengthTicks, {}};
+    hasRendered_ = true;
+    pipeline_.clear();
+    pipeline_.addNotes(phrase.notes);  // sorted: a single append
+
+    auto restored = std::make_unique<RenderedPhrase>(rendered_);
+    restored->notes = std::move(phrase.notes);
+
+    delete next_.exchange(restored.release(), std::memory_order_acq_rel);
+    readyGeneration_.store(generation_, std::memory_order_release);
+}
+
+void LookaheadRenderer::freeRetired() {
+    RenderedPhrase* phrase = nullptr;
+    while (retired_.tryPop(phrase)) {
+        delete phrase;
+    }
+}
+
+const RenderedPhrase* LookaheadRenderer::advance(uint64_t playheadTick) noexcept {
+    if (current_ == nullptr) {
+        current_ = next_.exchange(nullptr, std::memory_order_acq_rel);
+        if (current_ != nullptr && current_->barTicks > 0) {
+            phraseStart_ = playheadTick - playheadTick % current_->barTicks;
+        }
+        return current_;
+    }
+
+    const uint64_t length = std::max<uint32_t>(current_->lengthTicks, 1);
+    if (playheadTick < phraseStart_ || playheadTick >= phraseStart_ + 2 * length) {
+        // Seek or loop in the host: realign to the bar under the playhead
+        const uint64_t bar = std::max<uint32_t>(current_->barTicks, 1);
+        phraseStart_ = playheadTick - playheadTick % bar;
+    } else if (playheadTick >= phraseStart_ + length) {
+        phraseStart_ += length;
+        // Swap only when the old phrase can be handed back for freeing,
+        // otherwise repeat it. Only this thread empties next_, so a non-null
+        // load means the exchange returns a phrase.
+        if (next_.load(std::memory_order_relaxed) != nullptr && retired_.tryPush(current_)) {
+            current_ = next_.exchange(nullptr, std::memory_order_acq_rel);
+        }
+    }
+    return current_;
+}
+
+} // namespace kelly
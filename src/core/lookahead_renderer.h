@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "groove_templates.h"
+#include "midi_pipeline.h"
+#include "phrase_generator.h"
+#include "spsc_ring.h"
+#include "task_pool.h"
+
+namespace kelly {
+
+// A finished phrase; immutable once published
+struct RenderedPhrase {
+    int emotionId = 0;
+    uint64_t generation = 0;   // LookaheadRenderer::setRequest count it was rendered for
+    uint32_t ppq = 480;
+    uint32_t barTicks = 0;
+    uint32_t lengthTicks = 0;
+    std::vector<MidiNote> notes;  // sorted by time, relative to the phrase start
+};
+
+// Pre-renders phrases on a TaskPool one phrase ahead of the playhead, so
+// generation never runs in processBlock.
+//
+// The message thread sets the request and calls service() periodically.
+// service() frees retired phrases and, when no job is in flight and the next
+// phrase is missing or stale, submits a render. The job publishes
+// its phrase by exchanging it into an atomic "next" pointer. It deletes
+// any unconsumed phrase it displaces, which the audio thread never saw.
+// The audio thread's advance() takes the next phrase with one exchange
+// once the playhead passes the end of the current one. The old phrase goes
+// back through an SPSC ring for service() to delete, so the audio thread
+// never frees memory. With nothing new ready, the current phrase repeats.
+// A request change is heard at the next phrase boundary.
+//
+// Each instance runs at most one job at a time; many instances on the shared
+// pool render in parallel.
+class LookaheadRenderer {
+public:
+    static constexpr size_t kRetiredCapacity = 16;
+
+    // A null pool means TaskPool::shared(), acquired at the first render so
+    // an instance that never plays starts no threads. Null grooves means
+    // GrooveTemplates::shared().
+    explicit LookaheadRenderer(TaskPoolHandle pool = nullptr, GrooveTemplatesHandle grooves = nullptr);
+    // Waits for an in-flight render
+    ~LookaheadRenderer();
+
+    LookaheadRenderer(const LookaheadRenderer&) = delete;
+    LookaheadRenderer& operator=(const LookaheadRenderer&) = delete;
+
+    // Message thread
+    void setRequest(const PhraseRequest& request);
+    const PhraseRequest& getRequest() const { return request_; }
+    void service();
+    void waitForRender() const;
+    bool isNextReady() const { return next_.load(std::memory_order_acquire) != nullptr; }
+
+    const GrooveTemplates& getGrooves() const { return *grooves_; }
+
+    // Message thread: the newest finished render, for saving. Waits for an
+    // in-flight job. False before the first render.
+    bool snapshot(RenderedPhrase& out) const;
+    // Message thread: makes the phrase the finished render for the request,
+    // as if it had just been rendered, e.g. when restoring saved state.
+    // Its notes, sorted by time as loadPluginState guarantees, move into the
+    // published phrase and are copied once into the render cache.
+    // Nothing is re-rendered until the request changes.
+    void restore(const PhraseRequest& request, RenderedPhrase&& phrase);
+
+    // Audio thread: the phrase playing at playheadTick, or null before the
+    // first render lands. The phrase stays valid until the next advance().
+    const RenderedPhrase* advance(uint64_t playheadTick) noexcept;
+    // Audio thread: absolute tick of the current phrase's first note time
+    uint64_t getPhraseStart() const { return phraseStart_; }
+
+private:
+    void submitRender();
+    void freeRetired();
+
+    TaskPoolHandle pool_;
+    GrooveTemplatesHandle grooves_;
+
+    // Message thread
+    PhraseRequest request_;
+    uint64_t generation_ = 0;
+    uint32_t phraseCount_ = 0;
+
+    // Render job (one at a time); the message thread reads them once it has
+    // waited for the job
+    PhraseGenerator generator_{*grooves_};
+    MidiPipeline pipeline_;
+    RenderedPhrase rendered_;  // metadata of the render held in pipeline_
+    bool hasRendered_ = false;
+
+    // Shared with the job so its final notify can outlive a destructor it woke
+    std::shared_ptr<std::atomic<bool>> inFlight_ = std::make_shared<std::atomic<bool>>(false);
+    std::atomic<uint64_t> readyGeneration_{0};
+    std::atomic<RenderedPhrase*> next_{nullptr};
+    SpscRing<RenderedPhrase*, kRetiredCapacity> retired_;
+
+    // Audio thread
+    RenderedPhrase* current_ = nullptr;
+    uint64_t phraseStart_ = 0;
+};
+
+} // namespace kelly
@@ -0,0 +1,152 @@
+#include "midi_block_renderer.h"
+#include "profiling.h"
+#include <algorithm>
+#include <cmath>
+
+namespace kelly {
+
+namespace {
+
+// Absorbs rounding in tick <-> sample conversion; far below one sample
+constexpr double kOffsetEpsilon = 1e-6;
+
+// Later end tick = lower priority: std::*_heap with this keeps a min-heap
+struct EndsLater {
+    template <typename T>
+    bool operator()(const T& a, const T& b) const { return a.tick > b.tick; }
+};
+
+} // namespace
+
+void MidiBlockRenderer::prepare(double sampleRate, int samplesPerBlock) {
+    sampleRate_ = sampleRate > 0.0 ? sampleRate : 44100.0;
+    events_.assign(std::max<size_t>(kMinEventCapacity, static_cast<size_t>(std::max(samplesPerBlock, 0))),
+                   GeneratedMidiEvent{});
+    reset();
+}
+
+void MidiBlockRenderer::reset() {
+    heapCount_ = 0;
+    eventCount_ = 0;
+    located_ = false;
+}
+
+void MidiBlockRenderer::setSequence(std::span<const MidiNote> notes, uint64_t originTick) {
+    notes_ = notes;
+    origin_ = originTick;
+    // First note starting in the play position's tick or later; one that is a
+    // fraction of a tick overdue plays at the start of the next block
+    const double position = std::floor(tick_);
+    cursor_ = static_cast<size_t>(std::partition_point(notes_.begin(), notes_.end(), [&](const MidiNote& note) {
+        return static_cast<double>(origin_ + note.time) < position;
+    }) - notes_.begin());
+}
+
+void MidiBlockRenderer::locate(double tick) {
+    tick_ = tick;
+    located_ = true;
+    setSequence(notes_, origin_);
+}
+
+std::span<const GeneratedMidiEvent> MidiBlockRenderer::process(int numSamples, const TempoMap& tempo, uint32_t ppq) {
+    KELLY_ZONE();
+    eventCount_ = 0;
+    flushIfLocated();
+    if (numSamples <= 0) {
+        return {events_.data(), eventCount_};
+    }
+
+    // Exact across tempo changes inside the block
+    const double startSeconds = tempo.tickToSeconds(tick_, ppq);
+    const double endTick = tempo.secondsToTick(startSeconds + numSamples / sampleRate_, ppq);
+    render(numSamples, [&](double tick) {
+        return (tempo.tickToSeconds(tick, ppq) - startSeconds) * sampleRate_;
+    });
+    tick_ = endTick;
+    return {events_.data(), eventCount_};
+}
+
+std::span<const GeneratedMidiEvent> MidiBlockRenderer::process(int numSamples, double hostTick, double ticksPerSample) {
+    KELLY_ZONE();
+    // Hosts report positions rounded to their own resolution, so allow a little slack
+    const double tolerance = std::max(1.0, 2.0 * ticksPerSample);
+    if (std::abs(hostTick - tick_) > tolerance) {
+        locate(hostTick);
+    }
+    eventCount_ = 0;
+    flushIfLocated();
+    if (numSamples <= 0 || ticksPerSample <= 0.0) {
+        return {events_.data(), eventCount_};
+    }
+
+    const double endTick = hostTick + numSamples * ticksPerSample;
+    render(numSamples, [&](double tick) { return (tick - hostTick) / ticksPerSample; });
+    tick_ = endTick;
+    return {events_.data(), eventCount_};
+}
+
+std::span<const GeneratedMidiEvent> MidiBlockRenderer::allNotesOff() {
+    eventCount_ = 0;
+    releaseAll();
+    return {events_.data(), eventCount_};
+}
+
+template <typename ToOffset>
+void MidiBlockRenderer::render(int numSamples, ToOffset&& toOffset) {
+    // The sample an event lands on decides its block, so accumulated
+    // rounding in the play position cannot push an event one sample early
+    // or into the wrong block. Anything overdue plays at the block start.
+    auto offsetOf = [&](uint64_t tick) {
+        return std::max(std::floor(toOffset(static_cast<double>(tick)) + kOffsetEpsilon), 0.0);
+    };
+    const auto blockEnd = static_cast<double>(numSamples);
+
+    while (eventCount_ < events_.size()) {
+        const double onOffset = cursor_ < notes_.size() ? offsetOf(origin_ + notes_[cursor_].time) : blockEnd;
+        const double offOffset = heapCount_ > 0 ? offsetOf(heap_[0].tick) : blockEnd;
+        if (onOffset >= blockEnd && offOffset >= blockEnd) {
+            break;
+        }
+
+        // Offs first on ties, so a retriggered pitch is released before it restarts
+        if (offOffset <= onOffset) {
+            std::pop_heap(heap_.begin(), heap_.begin() + heapCount_, EndsLater{});
+            const PendingNoteOff off = heap_[--heapCount_];
+            push(static_cast<int>(offOffset), off.note, 0);
+            continue;
+        }
+
+        const MidiNote& note = notes_[cursor_++];
+        if (heapCount_ == heap_.size()) {
+            ++droppedNotes_;
+            continue;
+        }
+        push(static_cast<int>(onOffset), note.note, std::clamp<uint8_t>(note.velocity, 1, 127));
+        heap_[heapCount_++] = PendingNoteOff{origin_ + note.time + note.duration, note.note};
+        std::push_heap(heap_.begin(), heap_.begin() + heapCount_, EndsLater{});
+    }
+}
+
+void MidiBlockRenderer::flushIfLocated() {
+    if (located_) {
+        releaseAll();
+        located_ = false;
+    }
+}
+
+void MidiBlockRenderer::releaseAll() {
+    for (size_t i = 0; i < heapCount_; ++i) {
+        push(0, heap_[i].note, 0);
+    }
+    heapCount_ = 0;
+}
+
+bool MidiBlockRenderer::push(int sampleOffset, uint8_t note, uint8_t velocity) {
+    if (eventCount_ >= events_.size()) {
+        return false;
+    }
+    events_[eventCount_++] = GeneratedMidiEvent{sampleOffset, note, velocity};
+    return true;
+}
+
+} // namespace kelly
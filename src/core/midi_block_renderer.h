@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "midi_pipeline.h"
+#include "realtime_generator.h"
+#include "tempo_map.h"
+
+namespace kelly {
+
+// Plays a time-sorted MidiNote sequence as sample-accurate note-on/off
+// events, one audio block at a time. Note-ons come from a cursor over the
+// sequence and note-offs from a fixed-capacity min-heap keyed by end tick.
+// The two sorted streams are merged, so a block costs
+// O(events in it × log held notes), however long the sequence is.
+//
+// The play position is kept in ticks, not samples. A tempo change
+// therefore only rescales what is still to come, and nothing already
+// played moves. Everything is sized in prepare(); the rest is allocation-
+// and lock-free for the audio thread.
+class MidiBlockRenderer {
+public:
+    static constexpr size_t kMaxActiveNotes = 128;  // further overlapping notes are dropped
+    static constexpr size_t kMinEventCapacity = 512;
+
+    // Not real-time safe: sizes the event buffer
+    void prepare(double sampleRate, int samplesPerBlock);
+    // Forgets sounding notes without releasing them
+    void reset();
+
+    // Notes must be sorted by time and outlive their use; originTick is the
+    // absolute tick of time 0. Playback continues from the tick holding
+    // getPosition(), and notes already sounding still end on time.
+    void setSequence(std::span<const MidiNote> notes, uint64_t originTick = 0);
+    void setSequence(const MidiPipeline& pipeline) { setSequence(pipeline.getNotes()); }
+
+    // Moves the play position. Sounding notes are released at the start of
+    // the next block, and notes starting before the new tick are skipped.
+    void locate(double tick);
+    double getPosition() const { return tick_; }
+
+    size_t getActiveNoteCount() const { return heapCount_; }
+    uint64_t getDroppedNoteCount() const { return droppedNotes_; }
+
+    // Free-running from getPosition(), timed by a tempo map such as
+    // MidiPipeline::getTempoMap(). Returns events ordered by sample offset,
+    // valid until the next call.
+    std::span<const GeneratedMidiEvent> process(int numSamples, const TempoMap& tempo, uint32_t ppq);
+
+    // Follows the host: the block starts at hostTick and runs ticksPerSample
+    // per sample (bpm / 60 × ppq / sampleRate). A host position that
+    // disagrees with getPosition() is treated as a seek.
+    std::span<const GeneratedMidiEvent> process(int numSamples, double hostTick, double ticksPerSample);
+
+    // Releases every sounding note at offset 0
+    std::span<const GeneratedMidiEvent> allNotesOff();
+
+private:
+    struct PendingNoteOff {
+        uint64_t tick;
+        uint8_t note;
+    };
+
+    template <typename ToOffset>
+    void render(int numSamples, ToOffset&& toOffset);
+    void flushIfLocated();
+    void releaseAll();
+    bool push(int sampleOffset, uint8_t note, uint8_t velocity);
+
+    double sampleRate_ = 44100.0;
+
+    std::span<const MidiNote> notes_;
+    uint64_t origin_ = 0;
+    size_t cursor_ = 0;
+    double tick_ = 0.0;
+    bool located_ = false;
+
+    std::array<PendingNoteOff, kMaxActiveNotes> heap_{};
+    size_t heapCount_ = 0;
+    uint64_t droppedNotes_ = 0;
+
+    std::vector<GeneratedMidiEvent> events_;
+    size_t eventCount_ = 0;
+};
+
+} // namespace kelly
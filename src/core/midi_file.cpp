@@ -0,0 +1,392 @@
+#include "midi_file.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace kelly {
+
+namespace {
+
+constexpr uint32_t kMaxVarLen = 0x0FFFFFFF;  // largest value four VLQ bytes hold
+constexpr uint8_t kNoteOn = 0x90;
+constexpr uint8_t kNoteOff = 0x80;
+constexpr uint8_t kMetaEvent = 0xFF;
+constexpr uint8_t kMetaTempo = 0x51;
+constexpr uint8_t kMetaEndOfTrack = 0x2F;
+constexpr int kDefaultBpm = 120;  // SMF tempo until the first tempo event
+
+uint8_t* putBigEndian(uint8_t* out, uint32_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+        *out++ = static_cast<uint8_t>(value >> shift);
+    }
+    return out;
+}
+
+uint8_t* putTag(uint8_t* out, const char (&tag)[5]) {
+    std::memcpy(out, tag, 4);
+    return out + 4;
+}
+
+uint8_t* putVarLen(uint8_t* out, uint32_t value) {
+    value = std::min(value, kMaxVarLen);
+    uint8_t bytes[4];
+    int count = 0;
+    do {
+        bytes[count++] = static_cast<uint8_t>(value & 0x7F);
+        value >>= 7;
+    } while (value != 0);
+    while (count > 1) {
+        *out++ = static_cast<uint8_t>(bytes[--count] | 0x80);
+    }
+    *out++ = bytes[0];
+    return out;
+}
+
+uint32_t readBigEndian(const uint8_t* in, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+bool hasTag(const uint8_t* in, const char (&tag)[5]) {
+    return std::memcmp(in, tag, 4) == 0;
+}
+
+} // namespace
+
+size_t MidiFileWriter::maxEncodedSize(size_t noteCount, size_t tempoChangeCount) {
+    constexpr size_t kHeaderChunk = 14;
+    constexpr size_t kTrackHeader = 8;
+    constexpr size_t kTempoEvent = 4 + 6;  // longest delta, FF 51 03, three data bytes
+    constexpr size_t kEndOfTrack = 1 + 3;
+    constexpr size_t kNoteEvent = 4 + 3;  // longest delta, status, two data bytes
+    return kHeaderChunk + kTrackHeader + std::max<size_t>(tempoChangeCount, 1) * kTempoEvent + kEndOfTrack +
+           noteCount * 2 * kNoteEvent;
+}
+
+std::span<const uint8_t> MidiFileWriter::write(std::span<const MidiNote> notes, int bpm,
+                                               const MidiFileOptions& options) {
+    return write(notes, TempoMap(bpm), options);
+}
+
+std::span<const uint8_t> MidiFileWriter::write(std::span<const MidiNote> notes, const TempoMap& tempo,
+                                               const MidiFileOptions& options) {
+    if (!std::is_sorted(notes.begin(), notes.end(),
+                        [](const MidiNote& a, const MidiNote& b) { return a.time < b.time; })) {
+        buffer_.clear();
+        return {};
+    }
+
+    const std::span<const TempoChange> changes = tempo.getChanges();
+    buffer_.resize(maxEncodedSize(notes.size(), changes.size()));
+    uint8_t* out = buffer_.data();
+
+    out = putTag(out, "MThd");
+    out = putBigEndian(out, 6, 4);
+    out = putBigEndian(out, 0, 2);  // format 0
+    out = putBigEndian(out, 1, 2);  // one track
+    out = putBigEndian(out, std::clamp<uint16_t>(options.ppq, 1, 0x7FFF), 2);
+
+    out = putTag(out, "MTrk");
+    uint8_t* trackLength = out;
+    out += 4;
+    uint8_t* trackStart = out;
+
+    const uint8_t status = static_cast<uint8_t>(kNoteOn | (options.channel & 0x0F));
+    uint32_t lastTick = 0;
+    bool statusWritten = false;
+    size_t nextChange = 0;
+    // Tempo changes at or before tick go out ahead of the notes there
+    auto emitTempoUntil = [&](uint32_t tick) {
+        for (; nextChange < changes.size() && changes[nextChange].tick <= tick; ++nextChange) {
+            const TempoChange& change = changes[nextChange];
+            out = putVarLen(out, change.tick - lastTick);
+            lastTick = change.tick;
+            *out++ = kMetaEvent;
+            *out++ = kMetaTempo;
+            *out++ = 3;
+            out = putBigEndian(out, 60000000u / static_cast<uint32_t>(std::clamp(change.bpm, 4, 1000)), 3);
+            statusWritten = false;  // meta events cancel running status
+        }
+    };
+    auto emit = [&](uint32_t tick, uint8_t note, uint8_t velocity) {
+        emitTempoUntil(tick);
+        out = putVarLen(out, tick - lastTick);
+        lastTick = tick;
+        if (!statusWritten) {
+            *out++ = status;  // running status covers the events up to the next meta event
+            statusWritten = true;
+        }
+        *out++ = static_cast<uint8_t>(note & 0x7F);
+        *out++ = velocity;
+    };
+    emitTempoUntil(0);
+
+    auto heapOrder = [](const PendingOff& a, const PendingOff& b) { return a.time > b.time; };
+    pendingOffs_.clear();
+    pendingOffs_.reserve(notes.size());
+    auto flushOffsUntil = [&](uint32_t tick) {
+        // Offs at the same tick as an on go first, so repeated pitches retrigger
+        while (!pendingOffs_.empty() && pendingOffs_.front().time <= tick) {
+            std::pop_heap(pendingOffs_.begin(), pendingOffs_.end(), heapOrder);
+            emit(pendingOffs_.back().time, pendingOffs_.back().note, 0);
+            pendingOffs_.pop_back();
+        }
+    };
+
+    for (const MidiNote& note : notes) {
+        flushOffsUntil(note.time);
+        emit(note.time, note.note, static_cast<uint8_t>(std::clamp<int>(note.velocity, 1, 127)));
+
+        const uint32_t end = note.time + std::min(note.duration, std::numeric_limits<uint32_t>::max() - note.time);
+        pendingOffs_.push_back(PendingOff{end, note.note});
+        std::push_heap(pendingOffs_.begin(), pendingOffs_.end(), heapOrder);
+    }
+    flushOffsUntil(std::numeric_limits<uint32_t>::max());
+    emitTempoUntil(std::numeric_limits<uint32_t>::max());
+
+    *out++ = 0;
+    *out++ = kMetaEvent;
+    *out++ = kMetaEndOfTrack;
+    *out++ = 0;
+
+    putBigEndian(trackLength, static_cast<uint32_t>(out - trackStart), 4);
+    buffer_.resize(static_cast<size_t>(out - buffer_.data()));
+    return buffer_;
+}
+
+std::span<const uint8_t> MidiFileWriter::write(const MidiPipeline& pipeline, const MidiFileOptions& options) {
+    return write(pipeline.getNotes(), pipeline.getTempoMap(), options);
+}
+
+bool MidiFileWriter::save(const MidiPipeline& pipeline, const std::string& path, const MidiFileOptions& options) {
+    const std::span<const uint8_t> bytes = write(pipeline, options);
+    if (bytes.empty()) {
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(out);
+}
+
+bool MidiFileReader::open(std::span<const uint8_t> data) {
+    *this = MidiFileReader();
+    if (data.size() < 14 || !hasTag(data.data(), "MThd")) {
+        return fail();
+    }
+
+    const uint32_t headerLength = readBigEndian(data.data() + 4, 4);
+    const uint16_t division = static_cast<uint16_t>(readBigEndian(data.data() + 12, 2));
+    if (headerLength < 6 || headerLength > data.size() - 8 || (division & 0x8000) != 0 || division == 0) {
+        return fail();  // SMPTE timing is not supported
+    }
+
+    data_ = data;
+    pos_ = 8 + headerLength;
+    info_.format = static_cast<uint16_t>(readBigEndian(data.data() + 8, 2));
+    info_.trackCount = static_cast<uint16_t>(readBigEndian(data.data() + 10, 2));
+    info_.ppq = division;
+    return true;
+}
+
+bool MidiFileReader::fail() {
+    error_ = true;
+    return false;
+}
+
+bool MidiFileReader::beginNextTrack() {
+    while (data_.size() - pos_ >= 8) {
+        const uint32_t length = readBigEndian(data_.data() + pos_ + 4, 4);
+        if (length > data_.size() - pos_ - 8) {
+            return fail();  // truncated chunk
+        }
+        const bool isTrack = hasTag(data_.data() + pos_, "MTrk");
+        pos_ += 8;
+        if (isTrack) {
+            trackEnd_ = pos_ + length;
+            tick_ = 0;
+            runningStatus_ = 0;
+            inTrack_ = true;
+            return true;
+        }
+        pos_ += length;  // unknown chunk types are skipped, as the spec requires
+    }
+    return false;
+}
+
+bool MidiFileReader::readVarLen(uint32_t& value) {
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (pos_ >= trackEnd_) {
+            return false;
+        }
+        const uint8_t byte = data_[pos_++];
+        value = (value << 7) | (byte & 0x7F);
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MidiFileReader::startNote(uint8_t channel, uint8_t note, uint8_t velocity) {
+    active_[channel * 128u + note] = ActiveNote{tick_, velocity, true};
+}
+
+bool MidiFileReader::endNote(uint8_t channel, uint8_t note, MidiNote& out) {
+    ActiveNote& slot = active_[channel * 128u + note];
+    if (!slot.active) {
+        return false;
+    }
+    slot.active = false;
+    out = MidiNote{note, slot.velocity, slot.start, tick_ - slot.start};
+    return true;
+}
+
+bool MidiFileReader::nextNote(MidiNote& note) {
+    if (data_.empty()) {
+        return false;
+    }
+
+    while (!error_) {
+        if (draining_) {
+            while (drainIndex_ < active_.size()) {
+                const size_t index = drainIndex_++;
+                if (endNote(static_cast<uint8_t>(index / 128), static_cast<uint8_t>(index % 128), note)) {
+                    return true;
+                }
+            }
+            draining_ = false;
+        }
+
+        if (!inTrack_ && !beginNextTrack()) {
+            return false;
+        }
+
+        if (pos_ >= trackEnd_) {
+            inTrack_ = false;
+            draining_ = true;
+            drainIndex_ = 0;
+            continue;
+        }
+
+        uint32_t delta = 0;
+        if (!readVarLen(delta) || pos_ >= trackEnd_) {
+            return fail();
+        }
+        tick_ += delta;
+
+        uint8_t status = data_[pos_];
+        if (status & 0x80) {
+            ++pos_;
+        } else if (runningStatus_ != 0) {
+            status = runningStatus_;
+        } else {
+            return fail();
+        }
+
+        if (status == kMetaEvent) {
+            if (pos_ >= trackEnd_) {
+                return fail();
+            }
+            const uint8_t type = data_[pos_++];
+            uint32_t length = 0;
+            if (!readVarLen(length) || length > trackEnd_ - pos_) {
+                return fail();
+            }
+            if (type == kMetaTempo && length == 3) {
+                const uint32_t micros = readBigEndian(data_.data() + pos_, 3);
+                if (micros > 0) {
+                    const int bpm = static_cast<int>(std::lround(60000000.0 / micros));
+                    if (tempoChanges_.empty()) {
+                        info_.tempo = bpm;
+                    }
+                    tempoChanges_.push_back(TempoChange{tick_, bpm});
+                }
+            }
+            pos_ = type == kMetaEndOfTrack ? trackEnd_ : pos_ + length;
+            continue;
+        }
+
+        if (status == 0xF0 || status == 0xF7) {
+            uint32_t length = 0;
+            if (!readVarLen(length) || length > trackEnd_ - pos_) {
+                return fail();
+            }
+            pos_ += length;
+            runningStatus_ = 0;
+            continue;
+        }
+
+        if (status > 0xF0) {
+            return fail();  // system common / real-time bytes are not valid in a file
+        }
+
+        runningStatus_ = status;
+        const uint8_t type = status & 0xF0;
+        const uint8_t channel = status & 0x0F;
+        const size_t dataBytes = (type == 0xC0 || type == 0xD0) ? 1 : 2;
+        if (dataBytes > trackEnd_ - pos_) {
+            return fail();
+        }
+        const uint8_t data1 = data_[pos_];
+        const uint8_t data2 = dataBytes == 2 ? data_[pos_ + 1] : 0;
+        pos_ += dataBytes;
+        if (((data1 | data2) & 0x80) != 0) {
+            return fail();
+        }
+
+        if (type == kNoteOn && data2 > 0) {
+            const bool retriggered = endNote(channel, data1, note);
+            startNote(channel, data1, data2);
+            if (retriggered) {
+                return true;
+            }
+        } else if ((type == kNoteOn || type == kNoteOff) && endNote(channel, data1, note)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MidiFileReader::read(std::span<const uint8_t> data, MidiPipeline& pipeline, MidiFileInfo* info) {
+    MidiFileReader reader;
+    if (!reader.open(data)) {
+        return false;
+    }
+
+    MidiNote note{};
+    while (reader.nextNote(note)) {
+        pipeline.addNote(note);  // arrival is by end time, so most inserts land near the back
+    }
+    if (reader.hasError()) {
+        return false;
+    }
+
+    if (!reader.tempoChanges_.empty()) {
+        pipeline.setTempo(kDefaultBpm);
+        for (const TempoChange& change : reader.tempoChanges_) {
+            pipeline.setTempoAt(change.tick, change.bpm);
+        }
+    }
+    if (info) {
+        *info = reader.info_;
+    }
+    return true;
+}
+
+bool MidiFileReader::load(const std::string& path, MidiPipeline& pipeline, MidiFileInfo* info) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    const auto bytes = file.bytes();
+    return read({reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()}, pipeline, info);
+}
+
+} // namespace kelly
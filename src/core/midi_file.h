@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "midi_pipeline.h"
+
+namespace kelly {
+
+struct MidiFileOptions {
+    uint16_t ppq = 480;    // ticks per quarter note, as used by MidiNote times
+    uint8_t channel = 0;   // 0..15
+};
+
+// Standard MIDI File (format 0) writer. Every buffer is kept between calls,
+// so exporting many clips with one writer allocates only while clips grow.
+// Note-offs are written as velocity-0 note-ons, which keeps the whole track
+// under one running status.
+class MidiFileWriter {
+public:
+    MidiFileWriter() = default;
+    ~MidiFileWriter() = default;
+
+    // Upper bound on the encoded size of a file with noteCount notes and
+    // tempoChangeCount tempo events
+    static size_t maxEncodedSize(size_t noteCount, size_t tempoChangeCount = 1);
+
+    // Notes must be ordered by start time (as MidiPipeline keeps them); an
+    // unsorted span yields an empty result. Every tempo change becomes one
+    // FF 51 event at its tick. The view is valid until the next write.
+    std::span<const uint8_t> write(std::span<const MidiNote> notes, const TempoMap& tempo,
+                                   const MidiFileOptions& options = {});
+    std::span<const uint8_t> write(std::span<const MidiNote> notes, int bpm, const MidiFileOptions& options = {});
+    std::span<const uint8_t> write(const MidiPipeline& pipeline, const MidiFileOptions& options = {});
+
+    bool save(const MidiPipeline& pipeline, const std::string& path, const MidiFileOptions& options = {});
+
+private:
+    struct PendingOff {
+        uint32_t time;
+        uint8_t note;
+    };
+
+    std::vector<uint8_t> buffer_;
+    std::vector<PendingOff> pendingOffs_;  // min-heap on time
+};
+
+struct MidiFileInfo {
+    uint16_t format = 0;
+    uint16_t trackCount = 0;
+    uint16_t ppq = 480;
+    int tempo = 120;  // bpm from the first tempo event seen so far; all of them are in getTempoChanges()
+};
+
+// Streaming SMF reader: decodes straight from the caller's bytes (e.g. a
+// MappedFile) and yields one MidiNote per call, with no allocation. Notes
+// come out when they end, track by track; channels are merged. A note-on
+// for a sounding pitch ends the earlier note, and notes still sounding at
+// the end of a track end there.
+class MidiFileReader {
+public:
+    MidiFileReader() = default;
+    ~MidiFileReader() = default;
+
+    // Parses the header; false if the data is not an SMF with PPQ timing
+    bool open(std::span<const uint8_t> data);
+
+    // False once the file is exhausted or malformed (see hasError)
+    bool nextNote(MidiNote& note);
+
+    const MidiFileInfo& getInfo() const { return info_; }
+    bool hasError() const { return error_; }
+    // Tempo events read so far, in file order, at their track ticks. Only
+    // files with tempo events allocate here.
+    std::span<const TempoChange> getTempoChanges() const { return tempoChanges_; }
+
+    // Reads every note into the pipeline and sets its tempo map from every
+    // tempo event (120 bpm before the first); false on malformed data
+    static bool read(std::span<const uint8_t> data, MidiPipeline& pipeline, MidiFileInfo* info = nullptr);
+    static bool load(const std::string& path, MidiPipeline& pipeline, MidiFileInfo* info = nullptr);
+
+private:
+    struct ActiveNote {
+        uint32_t start;
+        uint8_t velocity;
+        bool active;
+    };
+
+    bool beginNextTrack();
+    bool readVarLen(uint32_t& value);
+    bool fail();
+    void startNote(uint8_t channel, uint8_t note, uint8_t velocity);
+    bool endNote(uint8_t channel, uint8_t note, MidiNote& out);
+
+    std::span<const uint8_t> data_;
+    size_t pos_ = 0;
+    size_t trackEnd_ = 0;
+    bool inTrack_ = false;
+    bool draining_ = false;  // closing notes left sounding at the end of a track
+    size_t drainIndex_ = 0;
+    uint32_t tick_ = 0;
+    uint8_t runningStatus_ = 0;
+    bool error_ = false;
+    MidiFileInfo info_;
+    std::vector<TempoChange> tempoChanges_;
+    std::array<ActiveNote, 16 * 128> active_{};
+};
+
+} // namespace kelly
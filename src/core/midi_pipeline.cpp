@@ -1,19 +1,103 @@
 #include "midi_pipeline.h"
+#include <algorithm>
+#include <functional>
 
 namespace kelly {
 
 MidiPipeline::MidiPipeline() = default;
 
+MidiPipeline::MidiPipeline(std::pmr::memory_resource* resource)
+    : notes_(resource) {}
+
 void MidiPipeline::setTempo(int bpm) {
-    tempo_ = bpm;
+    tempoMap_.setTempo(bpm);
+}
+
+void MidiPipeline::setTempoAt(uint32_t tick, int bpm) {
+    tempoMap_.setTempoAt(tick, bpm);
 }
 
+namespace {
+
+bool startsBefore(const MidiNote& note, uint32_t tick) { return note.time < tick; }
+bool startsAfter(uint32_t tick, const MidiNote& note) { return tick < note.time; }
+bool earlierThan(const MidiNote& a, const MidiNote& b) { return a.time < b.time; }
+
+} // namespace
+
 void MidiPipeline::addNote(const MidiNote& note) {
-    notes_.push_back(note);
+    if (notes_.empty() || notes_.back().time <= note.time) {
+        notes_.push_back(note);
+        return;
+    }
+    notes_.insert(std::upper_bound(notes_.begin(), notes_.end(), note.time, startsAfter), note);
+}
+
+void MidiPipeline::addNotes(std::span<const MidiNote> notes) {
+    if (notes.empty()) {
+        return;
+    }
+
+    // A batch viewing our own notes would dangle once the vector grows
+    const std::less<const MidiNote*> before;
+    if (!notes_.empty() && !before(notes.data(), notes_.data()) && before(notes.data(), notes_.data() + notes_.size())) {
+        const std::pmr::vector<MidiNote> copy(notes.begin(), notes.end(), notes_.get_allocator());
+        addNotes(copy);
+        return;
+    }
+
+    // Geometric growth, so repeated small batches stay amortized O(1) per note
+    const size_t existing = notes_.size();
+    if (existing + notes.size() > notes_.capacity()) {
+        notes_.reserve(std::max(existing + notes.size(), 2 * notes_.capacity()));
+    }
+    const bool sorted = std::is_sorted(notes.begin(), notes.end(), earlierThan);
+
+    if (!sorted) {
+        notes_.insert(notes_.end(), notes.begin(), notes.end());
+        std::stable_sort(notes_.begin() + static_cast<std::ptrdiff_t>(existing), notes_.end(), earlierThan);
+        std::inplace_merge(notes_.begin(), notes_.begin() + static_cast<std::ptrdiff_t>(existing),
+                           notes_.end(), earlierThan);
+        return;
+    }
+
+    if (existing == 0 || notes_.back().time <= notes.front().time) {
+        notes_.insert(notes_.end(), notes.begin(), notes.end());
+        return;
+    }
+
+    // Merge from the back into the grown vector; on equal times the incoming
+    // note goes last, matching repeated addNote calls.
+    notes_.resize(existing + notes.size());
+    size_t i = existing;
+    size_t j = notes.size();
+    size_t k = notes_.size();
+    while (j > 0) {
+        if (i > 0 && notes_[i - 1].time > notes[j - 1].time) {
+            notes_[--k] = notes_[--i];
+        } else {
+            notes_[--k] = notes[--j];
+        }
+    }
 }
 
 void MidiPipeline::clear() {
     notes_.clear();
 }
 
+void MidiPipeline::restoreTimeOrder() {
+    if (!std::is_sorted(notes_.begin(), notes_.end(), earlierThan)) {
+        std::stable_sort(notes_.begin(), notes_.end(), earlierThan);
+    }
+}
+
+std::span<const MidiNote> MidiPipeline::notesInRange(uint32_t tickBegin, uint32_t tickEnd) const {
+    if (tickEnd <= tickBegin) {
+        return {};
+    }
+    auto first = std::lower_bound(notes_.begin(), notes_.end(), tickBegin, startsBefore);
+    auto last = std::lower_bound(first, notes_.end(), tickEnd, startsBefore);
+    return {first, last};
+}
+
 } // namespace kelly
@@ -3,6 +3,10 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <span>
+#include <memory_resource>
+#include <type_traits>
+#include "tempo_map.h"
 
 namespace kelly {
 
@@ -13,21 +17,59 @@ struct MidiNote {
     uint32_t duration;  // in ticks
 };
 
+static_assert(std::is_trivially_copyable_v<MidiNote>, "bulk operations copy notes as raw memory");
+
 class MidiPipeline {
 public:
     MidiPipeline();
+    // All note storage comes from the given resource, e.g. a
+    // std::pmr::monotonic_buffer_resource over a preallocated arena
+    explicit MidiPipeline(std::pmr::memory_resource* resource);
     ~MidiPipeline() = default;
 
+    // Replaces the tempo map with a single tempo
     void setTempo(int bpm);
+    // Tempo change from a tick on; earlier note times keep their seconds
+    void setTempoAt(uint32_t tick, int bpm);
+
+    void reserve(size_t noteCount) { notes_.reserve(noteCount); }
+    size_t capacity() const { return notes_.capacity(); }
+
+    // Keeps notes ordered by start time; notes with equal times stay in insertion order.
+    // Appending in time order is O(1), out-of-order inserts shift the tail.
     void addNote(const MidiNote& note);
+
+    // Bulk insert with at most one growth step, doubling capacity so repeated
+    // batches don't reallocate each time. A batch already sorted by time is
+    // merged in place without extra allocation; an unsorted one is stable-sorted
+    // first. The batch may view this pipeline's own notes; it is copied first.
+    void addNotes(std::span<const MidiNote> notes);
+
+    // Keeps capacity
     void clear();
-    
-    const std::vector<MidiNote>& getNotes() const { return notes_; }
-    int getTempo() const { return tempo_; }
+
+    // In-place bulk edit; start-time order is restored afterwards if the edit broke it
+    template <typename Edit>
+    void editNotes(Edit&& edit) {
+        edit(std::span<MidiNote>(notes_));
+        restoreTimeOrder();
+    }
+
+    // Notes starting in [tickBegin, tickEnd), found by binary search, no copies.
+    // Invalidated by the next modification.
+    std::span<const MidiNote> notesInRange(uint32_t tickBegin, uint32_t tickEnd) const;
+
+    const std::pmr::vector<MidiNote>& getNotes() const { return notes_; }
+    int getTempo() const { return tempoMap_.getTempo(); }  // at tick 0
+    int getTempoAt(uint32_t tick) const { return tempoMap_.getTempoAt(tick); }
+    const TempoMap& getTempoMap() const { return tempoMap_; }
+    std::pmr::memory_resource* getMemoryResource() const { return notes_.get_allocator().resource(); }
 
 private:
-    std::vector<MidiNote> notes_;
-    int tempo_ = 120;
+    void restoreTimeOrder();
+
+    std::pmr::vector<MidiNote> notes_;
+    TempoMap tempoMap_;
 };
 
 } // namespace kelly
@@ -0,0 +1,564 @@
+#include "music_database.h"
+#include "binary_image.h"
+#include "json_reader.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+// Set by the build to where data/json is installed
+#ifndef KELLY_MUSIC_DATA_DIR
+#define KELLY_MUSIC_DATA_DIR ""
+#endif
+
+namespace kelly {
+
+namespace {
+
+constexpr std::string_view kCacheFile = "music.kmdc";
+
+std::string environment(const char* name) {
+    const char* value = std::getenv(name);
+    return value != nullptr ? value : "";
+}
+
+constexpr std::string_view kSourceFiles[] = {
+    MusicDatabase::kProgressionsFile,
+    MusicDatabase::kFamiliesFile,
+    MusicDatabase::kScalesFile,
+};
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+std::optional<std::string> readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+std::optional<JsonValue> readJson(const std::string& directory, std::string_view file) {
+    const auto text = readFile(std::filesystem::path(directory) / file);
+    return text ? parseJson(*text) : std::nullopt;
+}
+
+// Scale degree of a Roman numeral's root: "bVII" -> 10, "ii7" -> 2, "#iv" -> 6.
+// The quality suffix is ignored; -1 if there is no numeral.
+int romanNumeralDegree(std::string_view numeral) {
+    int accidental = 0;
+    while (!numeral.empty() && (numeral.front() == 'b' || numeral.front() == '#')) {
+        accidental += numeral.front() == 'b' ? -1 : 1;
+        numeral.remove_prefix(1);
+    }
+
+    // Longest match first, so "VII" is not read as "V"
+    constexpr std::pair<std::string_view, int> kNumerals[] = {
+        {"VII", 11}, {"III", 4}, {"VI", 9}, {"IV", 5}, {"II", 2}, {"V", 7}, {"I", 0},
+    };
+    for (const auto& [roman, degree] : kNumerals) {
+        if (numeral.size() < roman.size()) continue;
+        bool matches = true;
+        for (size_t i = 0; i < roman.size(); ++i) {
+            const char c = numeral[i];
+            matches = matches && (c == roman[i] || c == roman[i] + ('a' - 'A'));
+        }
+        if (matches) {
+            return ((degree + accidental) % 12 + 12) % 12;
+        }
+    }
+    return -1;
+}
+
+std::string_view stringOr(const JsonValue* value, std::string_view fallback) {
+    return value && value->isString() ? std::string_view(value->asString()) : fallback;
+}
+
+class MusicDataCompiler {
+public:
+    void addFamilies(const JsonValue& root) {
+        for (const auto& [groupKey, group] : root.members()) {
+            if (groupKey.starts_with('_')) continue;
+            for (const auto& [key, entry] : group.members()) {
+                // Entries without a name are chord-function or cadence tables, not progressions
+                const JsonValue* name = entry.find("name");
+                const JsonValue* degreeList = entry.find("degrees");
+                if (!name || !name->isString() || !degreeList) continue;
+
+                std::vector<uint8_t> degrees;
+                bool valid = degreeList->isArray();
+                for (const JsonValue& degree : degreeList->items()) {
+                    valid = valid && degree.isNumber() && degree.asNumber() >= 0 && degree.asNumber() < 12;
+                    if (valid) degrees.push_back(static_cast<uint8_t>(degree.asNumber()));
+                }
+                if (valid) {
+                    addProgression(name->asString(), groupKey, stringOr(entry.find("roman"), key),
+                                   ProgressionSource::Family, degrees);
+                }
+            }
+        }
+    }
+
+    void addProgressions(const JsonValue& root) {
+        if (const JsonValue* byFunction = root.find("progressions_by_function")) {
+            for (const auto& [group, value] : byFunction->members()) {
+                if (const JsonValue* examples = value.find("examples")) {
+                    addNamedNumerals(*examples, group, ProgressionSource::Function);
+                }
+            }
+        }
+        if (const JsonValue* byEmotion = root.find("progressions_by_emotion")) {
+            for (const auto& [emotion, examples] : byEmotion->members()) {
+                const size_t first = progressions_.size();
+                addNamedNumerals(examples, emotion, ProgressionSource::Emotion);
+                for (size_t id = first; id < progressions_.size(); ++id) {
+                    tags_[emotion].second.push_back(static_cast<uint16_t>(id));
+                }
+            }
+        }
+        if (const JsonValue* byGenre = root.find("progressions_by_genre")) {
+            for (const auto& [genre, examples] : byGenre->members()) {
+                addNamedNumerals(examples, genre, ProgressionSource::Genre);
+            }
+        }
+        if (const JsonValue* modal = root.find("modal_progressions")) {
+            for (const auto& [mode, value] : modal->members()) {
+                const JsonValue* examples = value.find("examples");
+                if (!examples) continue;
+                for (const JsonValue& numerals : examples->items()) {
+                    addNumerals(mode, mode, numerals, ProgressionSource::Modal);
+                }
+            }
+        }
+    }
+
+    void addScales(const JsonValue& root) {
+        const JsonValue* scales = root.find("scales");
+        if (!scales) return;
+
+        for (const JsonValue& scale : scales->items()) {
+            const JsonValue* name = scale.find("scale_type");
+            const JsonValue* semitones = scale.find("intervals_semitones");
+            if (!name || !name->isString() || !semitones) continue;
+
+            ScaleRecord record{};
+            record.name = intern(name->asString());
+            record.category = intern(stringOr(scale.find("category"), ""));
+            record.intervalsBegin = static_cast<uint32_t>(intervals_.size());
+            for (const JsonValue& interval : semitones->items()) {
+                if (!interval.isNumber() || interval.asNumber() < 0 || interval.asNumber() >= 12) continue;
+                const auto semitone = static_cast<uint8_t>(interval.asNumber());
+                intervals_.push_back(semitone);
+                record.intervalMask |= static_cast<uint16_t>(1u << semitone);
+            }
+            record.intervalCount = static_cast<uint8_t>(intervals_.size() - record.intervalsBegin);
+
+            const auto id = static_cast<uint16_t>(scales_.size());
+            scales_.push_back(record);
+            if (const JsonValue* qualities = scale.find("emotional_quality")) {
+                for (const JsonValue& quality : qualities->items()) {
+                    if (quality.isString()) {
+                        tags_[quality.asString()].first.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+
+    // std::nullopt when the records outgrow the uint16_t IDs the tag indexes use
+    std::optional<std::vector<std::byte>> finish(uint64_t fingerprint) {
+        if (progressions_.size() > MusicDatabase::kMaxRecords || scales_.size() > MusicDatabase::kMaxRecords) {
+            return std::nullopt;
+        }
+
+        std::vector<EmotionTagRecord> tags;
+        std::vector<uint16_t> tagScales;
+        std::vector<uint16_t> tagProgressions;
+        for (const auto& [tag, ids] : tags_) {  // std::map keeps tags sorted
+            tags.push_back(EmotionTagRecord{intern(tag), static_cast<uint32_t>(tagScales.size()),
+                                            static_cast<uint32_t>(tagProgressions.size())});
+            tagScales.insert(tagScales.end(), ids.first.begin(), ids.first.end());
+            tagProgressions.insert(tagProgressions.end(), ids.second.begin(), ids.second.end());
+        }
+        tags.push_back(EmotionTagRecord{{0, 0}, static_cast<uint32_t>(tagScales.size()),
+                                        static_cast<uint32_t>(tagProgressions.size())});
+
+        BinaryImageWriter<MusicDataHeader> writer;
+        MusicDataHeader header{};
+        std::memcpy(header.magic, kMusicDataMagic, sizeof(header.magic));
+        header.version = kMusicDataVersion;
+        header.headerSize = sizeof(MusicDataHeader);
+        header.fingerprint = fingerprint;
+        header.progressionCount = static_cast<uint32_t>(progressions_.size());
+        header.degreeCount = static_cast<uint32_t>(degrees_.size());
+        header.scaleCount = static_cast<uint32_t>(scales_.size());
+        header.intervalCount = static_cast<uint32_t>(intervals_.size());
+        header.tagCount = static_cast<uint32_t>(tags.size() - 1);
+        header.tagScaleCount = static_cast<uint32_t>(tagScales.size());
+        header.tagProgressionCount = static_cast<uint32_t>(tagProgressions.size());
+        header.stringPoolSize = static_cast<uint32_t>(strings_.size());
+        header.progressionsOffset = writer.append(std::span<const ProgressionRecord>(progressions_));
+        header.degreesOffset = writer.append(std::span<const uint8_t>(degrees_));
+        header.scalesOffset = writer.append(std::span<const ScaleRecord>(scales_));
+        header.intervalsOffset = writer.append(std::span<const uint8_t>(intervals_));
+        header.tagsOffset = writer.append(std::span<const EmotionTagRecord>(tags));
+        header.tagScalesOffset = writer.append(std::span<const uint16_t>(tagScales));
+        header.tagProgressionsOffset = writer.append(std::span<const uint16_t>(tagProgressions));
+        header.stringsOffset = writer.append(std::span<const char>(strings_));
+        header.totalSize = writer.size();
+        return writer.finish(header);
+    }
+
+private:
+    PooledString intern(std::string_view text) {
+        auto it = interned_.find(text);
+        if (it == interned_.end()) {
+            const PooledString pooled{static_cast<uint32_t>(strings_.size()), static_cast<uint32_t>(text.size())};
+            strings_ += text;
+            it = interned_.emplace(std::string(text), pooled).first;
+        }
+        return it->second;
+    }
+
+    void addProgression(std::string_view name, std::string_view group, std::string_view numerals,
+                        ProgressionSource source, std::span<const uint8_t> degrees) {
+        ProgressionRecord record{};
+        record.name = intern(name);
+        record.group = intern(group);
+        record.numerals = intern(numerals);
+        record.degreesBegin = static_cast<uint32_t>(degrees_.size());
+        record.degreeCount = static_cast<uint8_t>(std::min<size_t>(degrees.size(), 255));
+        record.source = source;
+        degrees_.insert(degrees_.end(), degrees.begin(), degrees.begin() + record.degreeCount);
+        progressions_.push_back(record);
+    }
+
+    // [{"name": ..., "numerals": [...]}, ...]
+    void addNamedNumerals(const JsonValue& examples, std::string_view group, ProgressionSource source) {
+        for (const JsonValue& example : examples.items()) {
+            if (const JsonValue* numerals = example.find("numerals")) {
+                addNumerals(stringOr(example.find("name"), group), group, *numerals, source);
+            }
+        }
+    }
+
+    // Skipped unless every numeral resolves to a degree
+    void addNumerals(std::string_view name, std::string_view group, const JsonValue& numerals,
+                     ProgressionSource source) {
+        std::vector<uint8_t> degrees;
+        std::string text;
+        for (const JsonValue& numeral : numerals.items()) {
+            const int degree = numeral.isString() ? romanNumeralDegree(numeral.asString()) : -1;
+            if (degree < 0) return;
+            degrees.push_back(static_cast<uint8_t>(degree));
+            if (!text.empty()) text += " - ";
+            text += numeral.asString();
+        }
+        if (!degrees.empty()) {
+            addProgression(name, group, text, source, degrees);
+        }
+    }
+
+    std::vector<ProgressionRecord> progressions_;
+    std::vector<uint8_t> degrees_;
+    std::vector<ScaleRecord> scales_;
+    std::vector<uint8_t> intervals_;
+    // tag -> (scale IDs, progression IDs)
+    std::map<std::string, std::pair<std::vector<uint16_t>, std::vector<uint16_t>>, std::less<>> tags_;
+    std::string strings_;
+    std::map<std::string, PooledString, std::less<>> interned_;
+};
+
+bool writeCache(const std::string& cachePath, std::span<const std::byte> image) {
+    // Write aside and rename, so concurrent instances never map a half-written cache
+    const std::string temporary = cachePath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, cachePath, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+uint64_t MusicDatabase::fingerprint(const std::string& jsonDirectory) {
+    uint64_t hash = hashBytes(kFnvOffset, &kMusicDataVersion, sizeof(kMusicDataVersion));
+    for (std::string_view file : kSourceFiles) {
+        std::error_code error;
+        const auto path = std::filesystem::path(jsonDirectory) / file;
+        const auto size = std::filesystem::file_size(path, error);
+        if (error) return 0;
+        const auto modified = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        if (error) return 0;
+
+        hash = hashBytes(hash, file.data(), file.size());
+        hash = hashBytes(hash, &size, sizeof(size));
+        hash = hashBytes(hash, &modified, sizeof(modified));
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+std::optional<std::vector<std::byte>> MusicDatabase::compile(const std::string& jsonDirectory) {
+    // Taken before reading: a file edited mid-compile then leaves a stale
+    // fingerprint, so the next load() recompiles rather than trusting the cache
+    const uint64_t sources = fingerprint(jsonDirectory);
+    if (sources == 0) {
+        return std::nullopt;
+    }
+
+    const auto progressions = readJson(jsonDirectory, kProgressionsFile);
+    const auto families = readJson(jsonDirectory, kFamiliesFile);
+    const auto scales = readJson(jsonDirectory, kScalesFile);
+    if (!progressions || !families || !scales) {
+        return std::nullopt;
+    }
+
+    MusicDataCompiler compiler;
+    compiler.addFamilies(*families);
+    compiler.addProgressions(*progressions);
+    compiler.addScales(*scales);
+    return compiler.finish(sources);
+}
+
+std::unique_ptr<MusicDatabase> MusicDatabase::load(const std::string& jsonDirectory, const std::string& cachePath) {
+    const uint64_t expected = fingerprint(jsonDirectory);
+
+    if (auto cached = open(cachePath); cached && (expected == 0 || cached->getFingerprint() == expected)) {
+        return cached;
+    }
+    if (expected == 0) {
+        return nullptr;
+    }
+
+    auto image = compile(jsonDirectory);
+    if (!image) {
+        return nullptr;
+    }
+
+    std::unique_ptr<MusicDatabase> database;
+    if (writeCache(cachePath, *image)) {
+        database = open(cachePath);
+    }
+    if (!database) {
+        database = fromImage(std::move(*image));  // read-only location: serve from memory
+    }
+    if (database) {
+        database->compiled_ = true;
+    }
+    return database;
+}
+
+std::string MusicDatabase::installedDataDirectory() {
+    if (std::string directory = environment("KELLY_DATA_DIR"); !directory.empty()) {
+        return directory;
+    }
+    return KELLY_MUSIC_DATA_DIR;
+}
+
+std::string MusicDatabase::defaultCachePath() {
+    std::filesystem::path directory = environment("KELLY_CACHE_DIR");
+    if (directory.empty()) {
+#if defined(_WIN32)
+        directory = environment("LOCALAPPDATA");
+#elif defined(__APPLE__)
+        if (const std::string home = environment("HOME"); !home.empty()) {
+            directory = std::filesystem::path(home) / "Library" / "Caches";
+        }
+#else
+        directory = environment("XDG_CACHE_HOME");
+        if (const std::string home = environment("HOME"); directory.empty() && !home.empty()) {
+            directory = std::filesystem::path(home) / ".cache";
+        }
+#endif
+        if (directory.empty()) {
+            return {};
+        }
+        directory /= "kelly";
+    }
+    return (directory / kCacheFile).string();
+}
+
+const MusicDatabase* MusicDatabase::installed() {
+    static const std::unique_ptr<MusicDatabase> database = []() -> std::unique_ptr<MusicDatabase> {
+        const std::string jsonDirectory = installedDataDirectory();
+        const std::string cachePath = defaultCachePath();
+        if (jsonDirectory.empty()) {
+            return cachePath.empty() ? nullptr : open(cachePath);
+        }
+        if (cachePath.empty()) {
+            auto image = compile(jsonDirectory);
+            return image ? fromImage(std::move(*image)) : nullptr;
+        }
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+        return load(jsonDirectory, cachePath);  // an unwritable cache is served from memory
+    }();
+    return database.get();
+}
+
+std::unique_ptr<MusicDatabase> MusicDatabase::open(const std::string& cachePath) {
+    std::unique_ptr<MusicDatabase> database(new MusicDatabase());
+    if (!database->file_.open(cachePath) || !database->bind(database->file_.bytes())) {
+        return nullptr;
+    }
+    return database;
+}
+
+std::unique_ptr<MusicDatabase> MusicDatabase::fromImage(std::vector<std::byte> image) {
+    std::unique_ptr<MusicDatabase> database(new MusicDatabase());
+    database->image_ = std::move(image);
+    if (!database->bind(database->image_)) {
+        return nullptr;
+    }
+    return database;
+}
+
+bool MusicDatabase::bind(std::span<const std::byte> bytes) {
+    if constexpr (std::endian::native != std::endian::little) {
+        return false;
+    }
+    if (bytes.size() < sizeof(MusicDataHeader)
+        || reinterpret_cast<uintptr_t>(bytes.data()) % alignof(MusicDataHeader) != 0) {
+        return false;
+    }
+
+    const auto* header = imageSection<MusicDataHeader>(bytes, 0);
+    const uint64_t totalSize = header->totalSize;
+    if (std::memcmp(header->magic, kMusicDataMagic, sizeof(header->magic)) != 0
+        || header->version != kMusicDataVersion
+        || header->headerSize != sizeof(MusicDataHeader)
+        || totalSize > bytes.size()
+        || header->scaleCount > kMaxRecords || header->progressionCount > kMaxRecords
+        || !imageSectionFits(header->progressionsOffset, header->progressionCount, sizeof(ProgressionRecord), totalSize)
+        || !imageSectionFits(header->degreesOffset, header->degreeCount, 1, totalSize)
+        || !imageSectionFits(header->scalesOffset, header->scaleCount, sizeof(ScaleRecord), totalSize)
+        || !imageSectionFits(header->intervalsOffset, header->intervalCount, 1, totalSize)
+        || !imageSectionFits(header->tagsOffset, uint64_t{header->tagCount} + 1, sizeof(EmotionTagRecord), totalSize)
+        || !imageSectionFits(header->tagScalesOffset, header->tagScaleCount, sizeof(uint16_t), totalSize)
+        || !imageSectionFits(header->tagProgressionsOffset, header->tagProgressionCount, sizeof(uint16_t), totalSize)
+        || header->stringsOffset + uint64_t{header->stringPoolSize} > totalSize) {
+        return false;
+    }
+
+    const auto* progressions = imageSection<ProgressionRecord>(bytes, header->progressionsOffset);
+    const auto* scales = imageSection<ScaleRecord>(bytes, header->scalesOffset);
+    const auto* tags = imageSection<EmotionTagRecord>(bytes, header->tagsOffset);
+    const auto* tagScales = imageSection<uint16_t>(bytes, header->tagScalesOffset);
+    const auto* tagProgressions = imageSection<uint16_t>(bytes, header->tagProgressionsOffset);
+
+    // Bounds only, so accessors never need checks; nothing is copied
+    auto stringFits = [&](PooledString s) { return s.offset + uint64_t{s.length} <= header->stringPoolSize; };
+    for (uint32_t i = 0; i < header->progressionCount; ++i) {
+        const ProgressionRecord& p = progressions[i];
+        if (!stringFits(p.name) || !stringFits(p.group) || !stringFits(p.numerals)
+            || p.degreesBegin + uint64_t{p.degreeCount} > header->degreeCount) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->scaleCount; ++i) {
+        const ScaleRecord& s = scales[i];
+        if (!stringFits(s.name) || !stringFits(s.category)
+            || s.intervalsBegin + uint64_t{s.intervalCount} > header->intervalCount) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->tagCount; ++i) {
+        if (!stringFits(tags[i].tag)
+            || tags[i].scalesBegin > tags[i + 1].scalesBegin
+            || tags[i].progressionsBegin > tags[i + 1].progressionsBegin) {
+            return false;
+        }
+    }
+    if (tags[0].scalesBegin != 0 || tags[0].progressionsBegin != 0
+        || tags[header->tagCount].scalesBegin != header->tagScaleCount
+        || tags[header->tagCount].progressionsBegin != header->tagProgressionCount) {
+        return false;
+    }
+    for (uint32_t i = 0; i < header->tagScaleCount; ++i) {
+        if (tagScales[i] >= header->scaleCount) return false;
+    }
+    for (uint32_t i = 0; i < header->tagProgressionCount; ++i) {
+        if (tagProgressions[i] >= header->progressionCount) return false;
+    }
+
+    header_ = header;
+    progressions_ = progressions;
+    degrees_ = imageSection<uint8_t>(bytes, header->degreesOffset);
+    scales_ = scales;
+    intervals_ = imageSection<uint8_t>(bytes, header->intervalsOffset);
+    tags_ = tags;
+    tagScales_ = tagScales;
+    tagProgressions_ = tagProgressions;
+    strings_ = imageSection<char>(bytes, header->stringsOffset);
+    return true;
+}
+
+MusicProgression MusicDatabase::getProgression(size_t id) const {
+    const ProgressionRecord& p = progressions_[id];
+    return MusicProgression{str(p.name), str(p.group), str(p.numerals), p.source,
+                            {degrees_ + p.degreesBegin, p.degreeCount}};
+}
+
+MusicScale MusicDatabase::getScale(size_t id) const {
+    const ScaleRecord& s = scales_[id];
+    return MusicScale{str(s.name), str(s.category), s.intervalMask,
+                      {intervals_ + s.intervalsBegin, s.intervalCount}};
+}
+
+int MusicDatabase::findScale(std::string_view name) const {
+    for (uint32_t i = 0; i < header_->scaleCount; ++i) {
+        if (str(scales_[i].name) == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const EmotionTagRecord* MusicDatabase::findTag(std::string_view tag) const {
+    const EmotionTagRecord* first = tags_;
+    const EmotionTagRecord* last = tags_ + header_->tagCount;
+    const EmotionTagRecord* it = std::lower_bound(first, last, tag, [&](const EmotionTagRecord& record, std::string_view key) {
+        return str(record.tag) < key;
+    });
+    return (it != last && str(it->tag) == tag) ? it : nullptr;
+}
+
+std::span<const uint16_t> MusicDatabase::scalesForEmotion(std::string_view tag) const {
+    const EmotionTagRecord* record = findTag(tag);
+    return record ? std::span<const uint16_t>(tagScales_ + record->scalesBegin, tagScales_ + record[1].scalesBegin)
+                  : std::span<const uint16_t>();
+}
+
+std::span<const uint16_t> MusicDatabase::progressionsForEmotion(std::string_view tag) const {
+    const EmotionTagRecord* record = findTag(tag);
+    return record ? std::span<const uint16_t>(tagProgressions_ + record->progressionsBegin,
+                                              tagProgressions_ + record[1].progressionsBegin)
+                  : std::span<const uint16_t>();
+}
+
+} // namespace kelly
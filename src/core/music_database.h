@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mapped_file.h"
+
+namespace kelly {
+
+// Compiled cache (".kmdc") of the data/json chord progression and scale
+// maps, read in place like the emotion graph:
+//
+//   MusicDataHeader
+//   ProgressionRecord[progressionCount]
+//   uint8_t degrees[degreeCount]           chord roots, semitones above the tonic
+//   ScaleRecord[scaleCount]
+//   uint8_t intervals[intervalCount]       semitones above the root
+//   EmotionTagRecord[tagCount + 1]         sorted by tag, last is a CSR sentinel
+//   uint16_t tagScales[tagScaleCount]      scale IDs per tag
+//   uint16_t tagProgressions[tagProgressionCount]
+//   char strings[stringPoolSize]           interned, not terminated
+//
+// The header carries a fingerprint of the source JSON files; a mismatch
+// makes load() recompile. Bump kMusicDataVersion when the layout or the
+// compile rules change.
+inline constexpr char kMusicDataMagic[4] = {'K', 'M', 'D', 'C'};
+inline constexpr uint16_t kMusicDataVersion = 1;
+
+struct PooledString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+enum class ProgressionSource : uint8_t {
+    Family,    // chord_progression_families.json
+    Function,  // chord_progressions.json, by function
+    Emotion,
+    Genre,
+    Modal
+};
+
+struct ProgressionRecord {
+    PooledString name;
+    PooledString group;     // e.g. "jazz_progressions", "melancholy"
+    PooledString numerals;  // e.g. "I - V - vi - IV"
+    uint32_t degreesBegin;
+    uint8_t degreeCount;
+    ProgressionSource source;
+    uint16_t reserved;
+};
+
+struct ScaleRecord {
+    PooledString name;
+    PooledString category;
+    uint32_t intervalsBegin;
+    uint16_t intervalMask;  // bit n set when n semitones above the root is in the scale
+    uint8_t intervalCount;
+    uint8_t reserved;
+};
+
+struct EmotionTagRecord {
+    PooledString tag;
+    uint32_t scalesBegin;
+    uint32_t progressionsBegin;
+};
+
+struct MusicDataHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint64_t fingerprint;
+    uint32_t progressionCount;
+    uint32_t degreeCount;
+    uint32_t scaleCount;
+    uint32_t intervalCount;
+    uint32_t tagCount;
+    uint32_t tagScaleCount;
+    uint32_t tagProgressionCount;
+    uint32_t stringPoolSize;
+    uint32_t progressionsOffset;
+    uint32_t degreesOffset;
+    uint32_t scalesOffset;
+    uint32_t intervalsOffset;
+    uint32_t tagsOffset;
+    uint32_t tagScalesOffset;
+    uint32_t tagProgressionsOffset;
+    uint32_t stringsOffset;
+    uint32_t totalSize;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ProgressionRecord) == 32);
+static_assert(sizeof(ScaleRecord) == 24);
+static_assert(sizeof(EmotionTagRecord) == 16);
+static_assert(sizeof(MusicDataHeader) == 88);
+
+struct MusicProgression {
+    std::string_view name;
+    std::string_view group;
+    std::string_view numerals;
+    ProgressionSource source;
+    std::span<const uint8_t> degrees;
+};
+
+struct MusicScale {
+    std::string_view name;
+    std::string_view category;
+    uint16_t intervalMask;
+    std::span<const uint8_t> intervals;
+};
+
+// Chord progressions and scales with emotion-tag indexes, served from a
+// memory-mapped binary cache. JSON is parsed only when the cache is missing
+// or stale.
+class MusicDatabase {
+public:
+    static constexpr std::string_view kProgressionsFile = "chord_progressions.json";
+    static constexpr std::string_view kFamiliesFile = "chord_progression_families.json";
+    static constexpr std::string_view kScalesFile = "scale_emotional_map.json";
+    static constexpr size_t kMaxRecords = 0xFFFF;  // progressions and scales each, as uint16_t IDs
+
+    ~MusicDatabase() = default;
+
+    MusicDatabase(const MusicDatabase&) = delete;
+    MusicDatabase& operator=(const MusicDatabase&) = delete;
+
+    // Maps cachePath if it matches the JSON in jsonDirectory, otherwise
+    // compiles the JSON and rewrites the cache. With no JSON present, any
+    // valid cache is used as is. nullptr if neither source is usable.
+    static std::unique_ptr<MusicDatabase> load(const std::string& jsonDirectory, const std::string& cachePath);
+
+    static std::unique_ptr<MusicDatabase> open(const std::string& cachePath);
+
+    // The installed data/json, loaded once per process through the cache at
+    // defaultCachePath(); nullptr if neither the JSON nor a valid cache is there
+    static const MusicDatabase* installed();
+    // $KELLY_DATA_DIR if set, else the configured install directory
+    static std::string installedDataDirectory();
+    // music.kmdc in $KELLY_CACHE_DIR if set, else in the per-user cache
+    // directory (%LOCALAPPDATA%, ~/Library/Caches or $XDG_CACHE_HOME) under
+    // "kelly"; empty if the platform names none
+    static std::string defaultCachePath();
+    static std::unique_ptr<MusicDatabase> fromImage(std::vector<std::byte> image);
+
+    // Parses the three JSON files; std::nullopt if any is missing or malformed,
+    // or if there are more than kMaxRecords progressions or scales
+    static std::optional<std::vector<std::byte>> compile(const std::string& jsonDirectory);
+
+    // Hash of the JSON files' names, sizes and modification times; 0 if any is missing.
+    // Cheap enough for every startup, no file contents are read.
+    static uint64_t fingerprint(const std::string& jsonDirectory);
+
+    uint64_t getFingerprint() const { return header_->fingerprint; }
+    bool isMapped() const { return file_.isOpen(); }
+    bool wasCompiled() const { return compiled_; }  // load() had to parse JSON
+
+    size_t getProgressionCount() const { return header_->progressionCount; }
+    MusicProgression getProgression(size_t id) const;
+
+    size_t getScaleCount() const { return header_->scaleCount; }
+    MusicScale getScale(size_t id) const;
+    int findScale(std::string_view name) const;  // -1 if absent
+
+    // Emotion tags ("melancholy", "bright", ...) in sorted order
+    size_t getEmotionTagCount() const { return header_->tagCount; }
+    std::string_view getEmotionTag(size_t index) const { return str(tags_[index].tag); }
+
+    // Binary search over the tags; empty when the tag is unknown
+    std::span<const uint16_t> scalesForEmotion(std::string_view tag) const;
+    std::span<const uint16_t> progressionsForEmotion(std::string_view tag) const;
+
+private:
+    MusicDatabase() = default;
+
+    bool bind(std::span<const std::byte> bytes);
+    const EmotionTagRecord* findTag(std::string_view tag) const;
+    std::string_view str(PooledString s) const { return {strings_ + s.offset, s.length}; }
+
+    MappedFile file_;
+    std::vector<std::byte> image_;
+    bool compiled_ = false;
+
+    const MusicDataHeader* header_ = nullptr;
+    const ProgressionRecord* progressions_ = nullptr;
+    const uint8_t* degrees_ = nullptr;
+    const ScaleRecord* scales_ = nullptr;
+    const uint8_t* intervals_ = nullptr;
+    const EmotionTagRecord* tags_ = nullptr;
+    const uint16_t* tagScales_ = nullptr;
+    const uint16_t* tagProgressions_ = nullptr;
+    const char* strings_ = nullptr;
+};
+
+} // namespace kelly
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace kelly {
+
+enum class MusicalMode : uint8_t {
+    Minor,
+    Major
+};
+
+constexpr MusicalMode musicalModeFromName(std::string_view name) {
+    return name == "major" ? MusicalMode::Major : MusicalMode::Minor;
+}
+
+// Semitones above the tonic for each scale degree
+inline constexpr std::array<int, 7> kMajorScaleSteps = {0, 2, 4, 5, 7, 9, 11};
+inline constexpr std::array<int, 7> kMinorScaleSteps = {0, 2, 3, 5, 7, 8, 10};  // natural minor
+
+constexpr const std::array<int, 7>& scaleSteps(MusicalMode mode) {
+    return mode == MusicalMode::Major ? kMajorScaleSteps : kMinorScaleSteps;
+}
+
+// Degrees past the seventh continue into the next octave
+constexpr int scaleDegreeSemitones(MusicalMode mode, int degree) {
+    return (degree / 7) * 12 + scaleSteps(mode)[static_cast<size_t>(degree % 7)];
+}
+
+// Indexed access to the numeric fields of MusicalParams
+enum class MusicalParamId : uint8_t {
+    TempoModifier,
+    Dynamics,
+    VelocityMin,
+    VelocityMax,
+    ClusterProbability,
+    SyncopationLevel,
+    Count
+};
+
+inline constexpr size_t kMusicalParamCount = static_cast<size_t>(MusicalParamId::Count);
+
+enum class MusicalFlag : uint32_t {
+    AllowDissonance = 1u << 0,
+    SuddenChanges = 1u << 1,
+    IrregularMeters = 1u << 2
+};
+
+// Fixed-layout musical parameter block compiled from an emotion and its
+// rule breaks. Trivially copyable, so it can cross to the audio thread.
+struct MusicalParams {
+    float tempoModifier = 1.0f;
+    MusicalMode mode = MusicalMode::Minor;
+    float dynamics = 0.5f;
+    uint8_t velocityMin = 40;
+    uint8_t velocityMax = 110;
+    float clusterProbability = 0.0f;
+    float syncopationLevel = 0.0f;
+    uint32_t flags = 0;
+
+    bool hasFlag(MusicalFlag flag) const { return (flags & static_cast<uint32_t>(flag)) != 0; }
+    void setFlag(MusicalFlag flag) { flags |= static_cast<uint32_t>(flag); }
+
+    constexpr float get(MusicalParamId id) const {
+        switch (id) {
+            case MusicalParamId::TempoModifier: return tempoModifier;
+            case MusicalParamId::Dynamics: return dynamics;
+            case MusicalParamId::VelocityMin: return velocityMin;
+            case MusicalParamId::VelocityMax: return velocityMax;
+            case MusicalParamId::ClusterProbability: return clusterProbability;
+            case MusicalParamId::SyncopationLevel: return syncopationLevel;
+            case MusicalParamId::Count: break;
+        }
+        return 0.0f;
+    }
+
+    constexpr void set(MusicalParamId id, float value) {
+        switch (id) {
+            case MusicalParamId::TempoModifier: tempoModifier = value; break;
+            case MusicalParamId::Dynamics: dynamics = value; break;
+            case MusicalParamId::VelocityMin: velocityMin = toVelocity(value); break;
+            case MusicalParamId::VelocityMax: velocityMax = toVelocity(value); break;
+            case MusicalParamId::ClusterProbability: clusterProbability = value; break;
+            case MusicalParamId::SyncopationLevel: syncopationLevel = value; break;
+            case MusicalParamId::Count: break;
+        }
+    }
+
+private:
+    static constexpr uint8_t toVelocity(float value) {
+        return static_cast<uint8_t>(value < 0.0f ? 0.0f : (value > 127.0f ? 127.0f : value));
+    }
+};
+
+// Sparse set of parameter overrides carried by a rule break
+struct MusicalImpact {
+    std::array<float, kMusicalParamCount> values{};
+    uint32_t mask = 0;   // one bit per MusicalParamId that this impact sets
+    uint32_t flags = 0;  // MusicalFlag bits it raises
+
+    MusicalImpact& set(MusicalParamId id, float value) {
+        values[static_cast<size_t>(id)] = value;
+        mask |= 1u << static_cast<uint32_t>(id);
+        return *this;
+    }
+
+    MusicalImpact& raise(MusicalFlag flag) {
+        flags |= static_cast<uint32_t>(flag);
+        return *this;
+    }
+
+    bool sets(MusicalParamId id) const { return (mask & (1u << static_cast<uint32_t>(id))) != 0; }
+
+    void applyTo(MusicalParams& params) const {
+        for (size_t i = 0; i < kMusicalParamCount; ++i) {
+            if (mask & (1u << i)) {
+                params.set(static_cast<MusicalParamId>(i), values[i]);
+            }
+        }
+        params.flags |= flags;
+    }
+};
+
+} // namespace kelly
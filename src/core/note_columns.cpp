@@ -0,0 +1,178 @@
+#include "note_columns.h"
+#include "profiling.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace kelly {
+
+namespace {
+
+constexpr double kMaxTick = static_cast<double>(std::numeric_limits<uint32_t>::max());
+
+} // namespace
+
+VelocityCurve makeVelocityCurve(float dynamics, uint8_t velocityMin, uint8_t velocityMax) {
+    const double low = std::clamp<uint8_t>(std::min(velocityMin, velocityMax), 1, 127);
+    const double high = std::clamp<uint8_t>(std::max(velocityMin, velocityMax), 1, 127);
+    // dynamics 0 → exponent 4, 0.5 → 1, 1 → 0.25
+    const double exponent = std::pow(4.0, 1.0 - 2.0 * std::clamp(dynamics, 0.0f, 1.0f));
+
+    VelocityCurve curve{};
+    curve[0] = 0;  // still a note-off
+    for (size_t v = 1; v < curve.size(); ++v) {
+        const double shaped = std::pow(static_cast<double>(v) / 127.0, exponent);
+        curve[v] = static_cast<uint8_t>(std::lround(low + (high - low) * shaped));
+    }
+    return curve;
+}
+
+NoteColumns::NoteColumns() = default;
+
+NoteColumns::NoteColumns(std::pmr::memory_resource* resource)
+    : times_(resource), durations_(resource), pitches_(resource), velocities_(resource) {}
+
+void NoteColumns::assign(std::span<const MidiNote> notes) {
+    clear();
+    append(notes);
+}
+
+void NoteColumns::append(std::span<const MidiNote> notes) {
+    KELLY_ZONE();
+    const size_t existing = size();
+    const size_t count = existing + notes.size();
+    times_.resize(count);
+    durations_.resize(count);
+    pitches_.resize(count);
+    velocities_.resize(count);
+
+    uint32_t* times = times_.data() + existing;
+    uint32_t* durations = durations_.data() + existing;
+    uint8_t* pitches = pitches_.data() + existing;
+    uint8_t* velocities = velocities_.data() + existing;
+    for (size_t i = 0; i < notes.size(); ++i) {
+        times[i] = notes[i].time;
+        durations[i] = notes[i].duration;
+        pitches[i] = notes[i].note;
+        velocities[i] = notes[i].velocity;
+    }
+}
+
+void NoteColumns::append(const MidiNote& note) {
+    times_.push_back(note.time);
+    durations_.push_back(note.duration);
+    pitches_.push_back(note.note);
+    velocities_.push_back(note.velocity);
+}
+
+void NoteColumns::copyTo(std::span<MidiNote> out) const {
+    KELLY_ZONE();
+    const size_t count = std::min(out.size(), size());
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = MidiNote{pitches_[i], velocities_[i], times_[i], durations_[i]};
+    }
+}
+
+std::vector<MidiNote> NoteColumns::toNotes() const {
+    std::vector<MidiNote> notes(size());
+    copyTo(notes);
+    return notes;
+}
+
+MidiNote NoteColumns::operator[](size_t index) const {
+    return MidiNote{pitches_[index], velocities_[index], times_[index], durations_[index]};
+}
+
+void NoteColumns::reserve(size_t noteCount) {
+    times_.reserve(noteCount);
+    durations_.reserve(noteCount);
+    pitches_.reserve(noteCount);
+    velocities_.reserve(noteCount);
+}
+
+void NoteColumns::clear() {
+    times_.clear();
+    durations_.clear();
+    pitches_.clear();
+    velocities_.clear();
+}
+
+void NoteColumns::transpose(int semitones) {
+    const int shift = std::clamp(semitones, -127, 127);
+    uint8_t* pitches = pitches_.data();
+    const size_t count = pitches_.size();
+    for (size_t i = 0; i < count; ++i) {
+        pitches[i] = static_cast<uint8_t>(std::clamp(pitches[i] + shift, 0, 127));
+    }
+}
+
+void NoteColumns::clampPitches(uint8_t low, uint8_t high) {
+    const uint8_t lo = std::min(low, high);
+    const uint8_t hi = std::max(low, high);
+    uint8_t* pitches = pitches_.data();
+    const size_t count = pitches_.size();
+    for (size_t i = 0; i < count; ++i) {
+        pitches[i] = std::clamp(pitches[i], lo, hi);
+    }
+}
+
+void NoteColumns::applyVelocityCurve(const VelocityCurve& curve) {
+    uint8_t* velocities = velocities_.data();
+    const size_t count = velocities_.size();
+    for (size_t i = 0; i < count; ++i) {
+        velocities[i] = curve[velocities[i] & 0x7f];
+    }
+}
+
+void NoteColumns::shiftTime(int64_t ticks) {
+    // Saturating 32-bit add or subtract, so the loop stays in 32-bit lanes
+    constexpr uint32_t kMax = std::numeric_limits<uint32_t>::max();
+    const auto magnitude = static_cast<uint32_t>(std::min<uint64_t>(ticks < 0 ? 0 - static_cast<uint64_t>(ticks)
+                                                                             : static_cast<uint64_t>(ticks), kMax));
+    uint32_t* times = times_.data();
+    const size_t count = times_.size();
+    if (ticks >= 0) {
+        for (size_t i = 0; i < count; ++i) {
+            times[i] = times[i] > kMax - magnitude ? kMax : times[i] + magnitude;
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            times[i] = times[i] < magnitude ? 0 : times[i] - magnitude;
+        }
+    }
+}
+
+void NoteColumns::scaleTime(double factor) {
+    const double scale = std::max(factor, 0.0);
+    for (std::pmr::vector<uint32_t>* column : {&times_, &durations_}) {
+        uint32_t* ticks = column->data();
+        const size_t count = column->size();
+        for (size_t i = 0; i < count; ++i) {
+            ticks[i] = static_cast<uint32_t>(std::min(ticks[i] * scale + 0.5, kMaxTick));
+        }
+    }
+}
+
+void NoteColumns::clipToRange(uint32_t tickBegin, uint32_t tickEnd) {
+    KELLY_ZONE();
+    // Stream compaction: survivors move down in place, in order
+    size_t kept = 0;
+    const size_t count = size();
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t start = times_[i];
+        if (start < tickBegin || start >= tickEnd) {
+            continue;
+        }
+        times_[kept] = start;
+        durations_[kept] = std::min(durations_[i], tickEnd - start);
+        pitches_[kept] = pitches_[i];
+        velocities_[kept] = velocities_[i];
+        ++kept;
+    }
+    times_.resize(kept);
+    durations_.resize(kept);
+    pitches_.resize(kept);
+    velocities_.resize(kept);
+}
+
+} // namespace kelly
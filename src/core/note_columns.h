@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+#include "midi_pipeline.h"
+
+namespace kelly {
+
+// 0-127 velocity lookup table for NoteColumns::applyVelocityCurve
+using VelocityCurve = std::array<uint8_t, 128>;
+
+// Maps velocities into [velocityMin, velocityMax] along a power curve
+// steered by MusicalAttributes/MusicalParams dynamics. 0.5 is linear;
+// higher values lift soft notes and lower values push them down.
+VelocityCurve makeVelocityCurve(float dynamics, uint8_t velocityMin = 1, uint8_t velocityMax = 127);
+
+// Structure-of-arrays note storage for bulk offline work. A transform that
+// touches one field streams through just that column: 1 byte per note for
+// pitch or velocity instead of the 12-byte MidiNote. The transforms are
+// branch-free loops over contiguous arrays, written so the compiler can
+// vectorize them.
+//
+// Order is whatever was assigned. Every transform except clipToRange keeps
+// start-time order, and clipToRange keeps the survivors in order.
+class NoteColumns {
+public:
+    NoteColumns();
+    // All column storage comes from the given resource, as with MidiPipeline
+    explicit NoteColumns(std::pmr::memory_resource* resource);
+    ~NoteColumns() = default;
+
+    // Conversion from and to MidiNote
+    void assign(std::span<const MidiNote> notes);
+    void append(std::span<const MidiNote> notes);
+    void append(const MidiNote& note);
+    // out must hold size() notes
+    void copyTo(std::span<MidiNote> out) const;
+    std::vector<MidiNote> toNotes() const;
+    MidiNote operator[](size_t index) const;
+
+    size_t size() const { return times_.size(); }
+    bool empty() const { return times_.empty(); }
+    void reserve(size_t noteCount);
+    // Keeps capacity
+    void clear();
+
+    std::span<uint32_t> times() { return times_; }
+    std::span<uint32_t> durations() { return durations_; }
+    std::span<uint8_t> pitches() { return pitches_; }
+    std::span<uint8_t> velocities() { return velocities_; }
+    std::span<const uint32_t> times() const { return times_; }
+    std::span<const uint32_t> durations() const { return durations_; }
+    std::span<const uint8_t> pitches() const { return pitches_; }
+    std::span<const uint8_t> velocities() const { return velocities_; }
+
+    // Pitches saturate at 0 and 127
+    void transpose(int semitones);
+    void clampPitches(uint8_t low, uint8_t high);
+    void applyVelocityCurve(const VelocityCurve& curve);
+    // Start times saturate at 0 and UINT32_MAX
+    void shiftTime(int64_t ticks);
+    // Scales start times and durations about tick 0; negative factors count as 0
+    void scaleTime(double factor);
+    // Keeps notes starting in [tickBegin, tickEnd) and shortens any that
+    // ring past tickEnd. Notes starting before tickBegin are dropped.
+    void clipToRange(uint32_t tickBegin, uint32_t tickEnd);
+
+    std::pmr::memory_resource* getMemoryResource() const { return times_.get_allocator().resource(); }
+
+private:
+    std::pmr::vector<uint32_t> times_;
+    std::pmr::vector<uint32_t> durations_;
+    std::pmr::vector<uint8_t> pitches_;
+    std::pmr::vector<uint8_t> velocities_;
+};
+
+} // namespace kelly
@@ -0,0 +1,101 @@
+#include "phrase_generator.h"
+#include "profiling.h"
+#include <algorithm>
+#include <array>
+
+namespace kelly {
+
+namespace {
+
+// One chord per bar, as scale degrees: I IV V I (i iv v i in minor)
+constexpr std::array<int, 4> kProgression = {0, 3, 4, 0};
+
+// Chord tones walked over the groove slots: root, third, fifth, octave
+constexpr std::array<int, 4> kChordTones = {0, 2, 4, 7};
+
+constexpr float kGate = 0.9f;
+constexpr int kVelocityJitter = 6;
+
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+uint8_t toPitch(int pitch) {
+    return static_cast<uint8_t>(std::clamp(pitch, 0, 127));
+}
+
+} // namespace
+
+PhraseGenerator::PhraseGenerator(const GrooveTemplates& grooves)
+    : grooves_(grooves) {
+}
+
+uint32_t PhraseGenerator::render(const PhraseRequest& request, MidiPipeline& out) {
+    KELLY_ZONE();
+    out.clear();
+    out.setTempo(request.bpm);
+
+    const GrooveGrid* groove = grooveEngine_.getGrid(grooves_, request.grooveId, request.ppq);
+    if (groove == nullptr) {
+        groove = grooveEngine_.getGrid(grooves_, 0, request.ppq);
+    }
+    if (groove == nullptr) {
+        return 0;
+    }
+
+    const GrooveGrid& grid = *groove;
+    const std::span<const uint32_t> slots = grid.getSlotTicks();
+    const uint32_t barTicks = grid.getTicksPerBar();
+    const uint32_t bars = std::clamp<uint32_t>(request.bars, 1, kMaxBars);
+
+    const MusicalParams& p = request.params;
+    const int velocityLow = std::min(p.velocityMin, p.velocityMax);
+    const int velocityHigh = std::max(p.velocityMin, p.velocityMax);
+    const int baseVelocity = velocityLow + static_cast<int>((velocityHigh - velocityLow) * std::clamp(p.dynamics, 0.0f, 1.0f));
+    const auto clusterThreshold = static_cast<uint32_t>(std::clamp(p.clusterProbability, 0.0f, 1.0f) * 65535.0f);
+    uint32_t rng = request.seed != 0 ? request.seed : 1;
+
+    auto velocity = [&](int accent) {
+        const int jitter = static_cast<int>(nextRandom(rng) % (2 * kVelocityJitter + 1)) - kVelocityJitter;
+        return static_cast<uint8_t>(std::max(std::clamp(baseVelocity + accent + jitter, velocityLow, velocityHigh), 1));
+    };
+
+    scratch_.clear();
+    scratch_.reserve(bars * (2 * slots.size() + 1));
+    for (uint32_t bar = 0; bar < bars; ++bar) {
+        const int degree = kProgression[bar % kProgression.size()];
+        const uint32_t barStart = bar * barTicks;
+
+        scratch_.push_back(MidiNote{toPitch(kTonic - 12 + scaleDegreeSemitones(p.mode, degree)), velocity(0),
+                                    barStart, static_cast<uint32_t>(barTicks * kGate)});
+
+        for (size_t s = 0; s < slots.size(); ++s) {
+            const uint32_t next = s + 1 < slots.size() ? slots[s + 1] : barTicks + slots.front();
+            const auto duration = std::max<uint32_t>(static_cast<uint32_t>((next - slots[s]) * kGate), 1);
+            const int tone = degree + kChordTones[s % kChordTones.size()];
+            const uint8_t pitch = toPitch(kTonic + 12 + scaleDegreeSemitones(p.mode, tone));
+            const uint8_t noteVelocity = velocity(s == 0 ? 8 : 0);
+            scratch_.push_back(MidiNote{pitch, noteVelocity, barStart + slots[s], duration});
+
+            if (clusterThreshold > 0 && (nextRandom(rng) & 0xffff) < clusterThreshold) {
+                scratch_.push_back(MidiNote{toPitch(pitch + 1), static_cast<uint8_t>(std::max(noteVelocity * 4 / 5, 1)),
+                                            barStart + slots[s], duration});
+            }
+        }
+    }
+
+    // Notes already sit on the swung slots, so the grid contributes accents and humanization
+    GrooveSettings settings;
+    settings.humanizeMs = 12.0f * std::clamp(p.syncopationLevel, 0.0f, 1.0f);
+    settings.humanizeVelocity = p.hasFlag(MusicalFlag::SuddenChanges) ? 16 : 4;
+    settings.seed = rng;
+    grid.apply(scratch_, settings, request.bpm);
+
+    out.addNotes(scratch_);
+    return bars * barTicks;
+}
+
+} // namespace kelly
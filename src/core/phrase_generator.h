@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "groove_engine.h"
+#include "groove_templates.h"
+#include "midi_pipeline.h"
+#include "musical_params.h"
+
+namespace kelly {
+
+struct PhraseRequest {
+    int emotionId = 0;
+    MusicalParams params;
+    int grooveId = 0;    // GrooveTemplates ID; unknown IDs fall back to the first template
+    uint32_t ppq = 480;
+    uint32_t bars = 4;
+    int bpm = 120;       // for groove humanization
+    uint32_t seed = 1;
+};
+
+// Offline phrase builder for the lookahead renderer: one chord per bar
+// (I-IV-V-I or i-iv-v-i by mode) with a sustained bass, and chord tones
+// arpeggiated over the groove's slots. Velocities, clusters and
+// humanization follow the params. Times are relative to the phrase start.
+// Not thread-safe: each instance caches groove grids, so give every
+// concurrent job its own generator.
+class PhraseGenerator {
+public:
+    static constexpr uint8_t kTonic = 48;  // C3
+    static constexpr uint32_t kMaxBars = 64;
+
+    explicit PhraseGenerator(const GrooveTemplates& grooves);
+
+    // Replaces the pipeline's notes with the phrase; returns its length in ticks
+    uint32_t render(const PhraseRequest& request, MidiPipeline& out);
+
+private:
+    const GrooveTemplates& grooves_;
+    GrooveEngine grooveEngine_;
+    std::vector<MidiNote> scratch_;
+};
+
+} // namespace kelly
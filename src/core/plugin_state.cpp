@@ -0,0 +1,145 @@
+#include "plugin_state.h"
+#include "emotion_engine.h"
+#include "profiling.h"
+#include "tempo_map.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace kelly {
+
+namespace {
+
+constexpr uint32_t kKnownFlags = static_cast<uint32_t>(MusicalFlag::AllowDissonance) |
+                                 static_cast<uint32_t>(MusicalFlag::SuddenChanges) |
+                                 static_cast<uint32_t>(MusicalFlag::IrregularMeters);
+
+bool isNodeId(int id) {
+    return id >= 0 && static_cast<size_t>(id) < EmotionEngine::kEmotionCount;
+}
+
+// False for NaN as well
+bool isUnit(float value) {
+    return value >= 0.0f && value <= 1.0f;
+}
+
+bool isWellFormed(const MusicalParams& p) {
+    return p.tempoModifier > 0.0f && p.tempoModifier <= kPluginStateMaxTempoModifier &&
+           (p.mode == MusicalMode::Minor || p.mode == MusicalMode::Major) && isUnit(p.dynamics) &&
+           p.velocityMin <= 127 && p.velocityMax <= 127 && isUnit(p.clusterProbability) &&
+           isUnit(p.syncopationLevel) && (p.flags & ~kKnownFlags) == 0;
+}
+
+bool isWellFormed(const PhraseRequest& request, size_t grooveCount) {
+    return isNodeId(request.emotionId) && isWellFormed(request.params) && request.grooveId >= 0 &&
+           static_cast<size_t>(request.grooveId) < grooveCount && request.ppq >= 1 &&
+           request.ppq <= kPluginStateMaxPpq && request.bars >= 1 && request.bars <= PhraseGenerator::kMaxBars &&
+           request.bpm >= TempoMap::kMinBpm && request.bpm <= TempoMap::kMaxBpm;
+}
+
+bool isWellFormed(const MidiNote& note) {
+    return note.note <= 127 && note.velocity >= 1 && note.velocity <= 127;
+}
+
+bool isWellFormedPhrase(const PluginStateHeader& header, std::span<const MidiNote> notes) {
+    if (notes.empty()) {
+        return true;
+    }
+    const uint32_t bar = header.phraseBarTicks;
+    if (bar == 0 || header.phraseLengthTicks == 0 || header.phraseLengthTicks % bar != 0 ||
+        header.phraseLengthTicks / bar > PhraseGenerator::kMaxBars) {
+        return false;
+    }
+    return std::all_of(notes.begin(), notes.end(), [](const MidiNote& note) { return isWellFormed(note); }) &&
+           std::is_sorted(notes.begin(), notes.end(),
+                          [](const MidiNote& a, const MidiNote& b) { return a.time < b.time; });
+}
+
+} // namespace
+
+std::vector<std::byte> savePluginState(const PluginState& state) {
+    KELLY_ZONE();
+    const bool hasTrajectory = state.hasTrajectory && state.trajectory.isValid();
+    PluginStateHeader header{};
+    std::memcpy(header.magic, kPluginStateMagic, sizeof(header.magic));
+    header.version = kPluginStateVersion;
+    header.headerSize = sizeof(PluginStateHeader);
+    header.emotionId = state.emotionId;
+    header.trajectoryBytes = hasTrajectory ? static_cast<uint32_t>(EmotionTrajectory::kImageSize) : 0;
+    header.trajectoryLengthTicks = state.trajectoryLengthTicks;
+    header.trajectoryProgress = state.trajectoryProgress;
+    header.noteCount = static_cast<uint32_t>(state.phrase.notes.size());
+    header.phraseBarTicks = state.phrase.barTicks;
+    header.phraseLengthTicks = state.phrase.lengthTicks;
+    header.request = state.request;
+
+    const size_t notesBytes = state.phrase.notes.size() * sizeof(MidiNote);
+    std::vector<std::byte> data(sizeof(header) + header.trajectoryBytes + notesBytes);
+    std::byte* out = data.data();
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    if (hasTrajectory) {
+        state.trajectory.writeImage(std::span<std::byte, EmotionTrajectory::kImageSize>(out, EmotionTrajectory::kImageSize));
+        out += EmotionTrajectory::kImageSize;
+    }
+    if (notesBytes > 0) {
+        std::memcpy(out, state.phrase.notes.data(), notesBytes);
+    }
+    return data;
+}
+
+bool loadPluginState(std::span<const std::byte> data, PluginState& out, size_t grooveCount) {
+    KELLY_ZONE();
+    PluginStateHeader header;
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, kPluginStateMagic, sizeof(header.magic)) != 0 ||
+        header.version != kPluginStateVersion || header.headerSize != sizeof(header) ||
+        (header.trajectoryBytes != 0 && header.trajectoryBytes != EmotionTrajectory::kImageSize)) {
+        return false;
+    }
+
+    const uint64_t notesBytes = uint64_t{header.noteCount} * sizeof(MidiNote);
+    if (data.size() != sizeof(header) + header.trajectoryBytes + notesBytes) {
+        return false;
+    }
+    if ((header.emotionId != -1 && !isNodeId(header.emotionId)) || !isWellFormed(header.request, grooveCount)) {
+        return false;
+    }
+
+    PluginState state;
+    state.emotionId = header.emotionId;
+    state.request = header.request;
+
+    const std::byte* in = data.data() + sizeof(header);
+    state.hasTrajectory = header.trajectoryBytes != 0;
+    if (state.hasTrajectory) {
+        if (header.trajectoryLengthTicks == 0 || !isUnit(header.trajectoryProgress) ||
+            !state.trajectory.readImage(
+                std::span<const std::byte, EmotionTrajectory::kImageSize>(in, EmotionTrajectory::kImageSize))) {
+            return false;
+        }
+        state.trajectoryLengthTicks = header.trajectoryLengthTicks;
+        state.trajectoryProgress = header.trajectoryProgress;
+        in += EmotionTrajectory::kImageSize;
+    }
+
+    state.phrase.notes.resize(header.noteCount);
+    if (notesBytes > 0) {
+        std::memcpy(state.phrase.notes.data(), in, static_cast<size_t>(notesBytes));
+    }
+    if (!isWellFormedPhrase(header, state.phrase.notes)) {
+        return false;
+    }
+    state.phrase.emotionId = header.request.emotionId;
+    state.phrase.ppq = header.request.ppq;
+    state.phrase.barTicks = header.phraseBarTicks;
+    state.phrase.lengthTicks = header.phraseLengthTicks;
+
+    out = std::move(state);
+    return true;
+}
+
+} // namespace kelly
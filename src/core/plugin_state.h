@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "emotion_trajectory.h"
+#include "lookahead_renderer.h"
+#include "phrase_generator.h"
+
+namespace kelly {
+
+// Saved plugin state (".kstate" blob handed to the host), little-endian:
+//
+//   PluginStateHeader
+//   EmotionTrajectory image           if header.trajectoryBytes != 0
+//   MidiNote notes[header.noteCount]  the cached phrase, sorted by time
+//
+// Every section is stored as its in-memory bytes, so loading is one
+// memcpy per section followed by range checks, and nothing is
+// regenerated. This ties the format to the layouts of PhraseRequest,
+// EmotionTrajectory and MidiNote. Bump kPluginStateVersion whenever one
+// of them changes; readers reject any other version, and hosts then fall
+// back to a fresh instance.
+inline constexpr char kPluginStateMagic[4] = {'K', 'S', 'T', 'A'};
+inline constexpr uint16_t kPluginStateVersion = 1;
+
+// Bounds beyond which a loaded field is treated as corrupt
+inline constexpr uint32_t kPluginStateMaxPpq = 960;
+inline constexpr float kPluginStateMaxTempoModifier = 4.0f;
+
+struct PluginStateHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    int32_t emotionId;         // generator emotion, -1 until a wound, trajectory or restore set one
+    uint32_t trajectoryBytes;  // EmotionTrajectory::kImageSize or 0
+    uint64_t trajectoryLengthTicks;
+    float trajectoryProgress;
+    uint32_t noteCount;
+    uint32_t phraseBarTicks;
+    uint32_t phraseLengthTicks;
+    PhraseRequest request;     // includes the groove ID and the compiled params
+};
+
+static_assert(std::is_trivially_copyable_v<PluginStateHeader>);
+
+struct PluginState {
+    int emotionId = -1;
+    PhraseRequest request;
+    bool hasTrajectory = false;
+    EmotionTrajectory trajectory;
+    uint64_t trajectoryLengthTicks = 0;
+    float trajectoryProgress = 0.0f;
+    RenderedPhrase phrase;  // no notes when nothing had been rendered
+
+    // False for a state saved before anything set an emotion: restoring it
+    // keeps the step generator playing, as on a fresh instance
+    bool restoresPhrases() const { return emotionId >= 0; }
+};
+
+std::vector<std::byte> savePluginState(const PluginState& state);
+// False, leaving out untouched, for data that is truncated, foreign or
+// from another version, or has any field out of range: an unknown
+// emotion or groove (grooveCount is the library size), ppq outside
+// 1..kPluginStateMaxPpq, bars outside 1..PhraseGenerator::kMaxBars,
+// non-finite or out-of-range params, a malformed trajectory, or notes
+// that are invalid MIDI or not sorted by time.
+bool loadPluginState(std::span<const std::byte> data, PluginState& out, size_t grooveCount);
+
+} // namespace kelly
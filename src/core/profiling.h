@@ -0,0 +1,103 @@
+#pragma once
+
+// Tracy instrumentation for KellyCore and the plugin.
+// With ENABLE_TRACY (TRACY_ENABLE defined) these forward to Tracy; otherwise
+// every macro expands to nothing and arguments are not evaluated.
+
+#if defined(TRACY_ENABLE)
+
+#include <tracy/Tracy.hpp>
+
+#define KELLY_PROFILING_CONCAT_(a, b) a##b
+#define KELLY_PROFILING_CONCAT(a, b) KELLY_PROFILING_CONCAT_(a, b)
+
+// KELLY_ZONE covers the enclosing function; KELLY_ZONE_NAMED can be used
+// alongside it in the same scope to time the rest of that scope
+#define KELLY_ZONE() ZoneScoped
+#define KELLY_ZONE_NAMED(name) ZoneNamedN(KELLY_PROFILING_CONCAT(kellyZone, __LINE__), name, true)
+// Attaches a number to the KELLY_ZONE of the current function
+#define KELLY_ZONE_VALUE(value) ZoneValue(static_cast<uint64_t>(value))
+// name must be a string literal: Tracy keys frames and plots by pointer
+#define KELLY_FRAME_MARK(name) FrameMarkNamed(name)
+#define KELLY_PLOT(name, value) TracyPlot(name, value)
+#define KELLY_PLOT_PERCENTAGE(name) TracyPlotConfig(name, tracy::PlotFormatType::Percentage, false, true, 0)
+#define KELLY_MESSAGE(text) TracyMessageL(text)
+#define KELLY_ALLOC(ptr, size) TracySecureAlloc(ptr, size)
+#define KELLY_FREE(ptr) TracySecureFree(ptr)
+
+#else
+
+#define KELLY_ZONE()
+#define KELLY_ZONE_NAMED(name)
+#define KELLY_ZONE_VALUE(value)
+#define KELLY_FRAME_MARK(name)
+#define KELLY_PLOT(name, value)
+#define KELLY_PLOT_PERCENTAGE(name)
+#define KELLY_MESSAGE(text)
+#define KELLY_ALLOC(ptr, size)
+#define KELLY_FREE(ptr)
+
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include "audio_thread.h"
+
+namespace kelly::profiling {
+
+// One definition per name, so every translation unit hands Tracy the same pointer
+inline constexpr const char* kAudioFrame = "audio block";
+inline constexpr const char* kBlockTimePlot = "block time (us)";
+inline constexpr const char* kBlockBudgetPlot = "block budget (us)";
+inline constexpr const char* kBlockLoadPlot = "block load";
+inline constexpr const char* kAudioAllocPlot = "audio thread allocations";
+
+// Wraps one audio callback: marks the audio thread and, in profiling builds,
+// plots block time against the samples / sampleRate budget, the block's
+// load and allocation count, then ends the block's frame
+class AudioBlockScope {
+public:
+    AudioBlockScope([[maybe_unused]] int numSamples, [[maybe_unused]] double sampleRate) noexcept
+#if defined(TRACY_ENABLE)
+        : budgetUs_(sampleRate > 0.0 ? 1.0e6 * numSamples / sampleRate : 0.0),
+          start_(std::chrono::steady_clock::now())
+#endif
+    {
+    }
+
+    ~AudioBlockScope() {
+#if defined(TRACY_ENABLE)
+        const double elapsedUs =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+        KELLY_PLOT(kBlockTimePlot, elapsedUs);
+        KELLY_PLOT(kBlockBudgetPlot, budgetUs_);
+        if (budgetUs_ > 0.0) {
+            KELLY_PLOT(kBlockLoadPlot, 100.0 * elapsedUs / budgetUs_);
+            if (elapsedUs > budgetUs_) {
+                KELLY_MESSAGE("audio block over budget");
+            }
+        }
+        KELLY_PLOT(kAudioAllocPlot, static_cast<int64_t>(thread_.allocationCount()));
+        KELLY_FRAME_MARK(kAudioFrame);
+#endif
+    }
+
+    AudioBlockScope(const AudioBlockScope&) = delete;
+    AudioBlockScope& operator=(const AudioBlockScope&) = delete;
+
+    uint32_t allocationCount() const noexcept { return thread_.allocationCount(); }
+
+    // Not real-time safe; call once before the first block
+    static void configurePlots() {
+        KELLY_PLOT_PERCENTAGE(kBlockLoadPlot);
+    }
+
+private:
+    AudioThreadScope thread_;
+#if defined(TRACY_ENABLE)
+    double budgetUs_;
+    std::chrono::steady_clock::time_point start_;
+#endif
+};
+
+} // namespace kelly::profiling
@@ -0,0 +1,212 @@
+#include "realtime_generator.h"
+#include "intent_processor.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace kelly {
+
+namespace {
+
+// Scale degrees walked per 16th step: root, third, fifth, octave
+constexpr std::array<int, 4> kArpeggio = {0, 2, 4, 7};
+
+constexpr double kMinBpm = 20.0;
+constexpr double kGate = 0.9;
+
+} // namespace
+
+RealtimeGenerator::RealtimeGenerator(const IntentProcessor& processor)
+    : model_(processor.getModel()) {
+    intents_.write(Intent{0, getParams(0)});
+}
+
+void RealtimeGenerator::prepare(double sampleRate, int samplesPerBlock) {
+    sampleRate_ = sampleRate > 0.0 ? sampleRate : 44100.0;
+
+    // Worst case per step: a forced note-off plus a note-on, for the note and its cluster
+    const double minSamplesPerStep = sampleRate_ * 60.0 / (kMaxBpm * kMaxTempoModifier) / 4.0;
+    const auto maxSteps = static_cast<size_t>(std::ceil(std::max(samplesPerBlock, 1) / minSamplesPerStep)) + 1;
+    events_.assign(maxSteps * 4 + kMaxPendingNotes, GeneratedMidiEvent{});
+
+    reset();
+}
+
+void RealtimeGenerator::reset() {
+    samplePosition_ = 0;
+    nextStepSample_ = 0.0;
+    stepIndex_ = 0;
+    pendingCount_ = 0;
+    eventCount_ = 0;
+}
+
+void RealtimeGenerator::setEmotion(int emotionId) {
+    if (const CompiledEmotion* compiled = model_->getCompiled(emotionId)) {
+        publishIntent(emotionId, compiled->musicalParams);
+    }
+}
+
+void RealtimeGenerator::publishIntent(int emotionId, const MusicalParams& params) {
+    if (emotionId < 0 || static_cast<size_t>(emotionId) >= EmotionEngine::kEmotionCount) {
+        return;
+    }
+
+    Intent& intent = intents_.back();
+    intent.emotionId = emotionId;
+    intent.params = params;
+    intent.params.tempoModifier = std::clamp(params.tempoModifier, kMinTempoModifier, kMaxTempoModifier);
+    if (intent.params.velocityMin > intent.params.velocityMax) {
+        std::swap(intent.params.velocityMin, intent.params.velocityMax);
+    }
+    intents_.publish();
+    emotionId_.store(emotionId, std::memory_order_relaxed);
+}
+
+const MusicalParams& RealtimeGenerator::getParams(int emotionId) const {
+    static const MusicalParams defaults{};
+    const CompiledEmotion* compiled = model_->getCompiled(emotionId);
+    return compiled ? compiled->musicalParams : defaults;
+}
+
+void RealtimeGenerator::setMorph(const MorphFrame* frame) noexcept {
+    morphActive_ = frame != nullptr;
+    if (frame != nullptr) {
+        morph_ = *frame;
+    }
+}
+
+std::span<const GeneratedMidiEvent> RealtimeGenerator::process(int numSamples, double bpm) {
+    eventCount_ = 0;
+    if (numSamples <= 0 || events_.empty()) {
+        return {};
+    }
+
+    intents_.update();
+    MusicalParams p = intents_.front().params;
+    if (morphActive_) {
+        p.tempoModifier = std::clamp(morph_.tempoModifier, kMinTempoModifier, kMaxTempoModifier);
+        p.dynamics = std::clamp(morph_.dynamics, 0.0f, 1.0f);
+        p.mode = morph_.mode();
+    }
+    const double effectiveBpm = std::clamp(bpm, kMinBpm, kMaxBpm) * p.tempoModifier;
+    const double samplesPerStep = sampleRate_ * 60.0 / effectiveBpm / 4.0;
+    const auto noteLength = static_cast<int64_t>(samplesPerStep * kGate);
+
+    const int64_t blockStart = samplePosition_;
+    const int64_t blockEnd = blockStart + numSamples;
+    nextStepSample_ = std::max(nextStepSample_, static_cast<double>(blockStart));
+
+    while (nextStepSample_ < static_cast<double>(blockEnd)) {
+        const auto stepSample = static_cast<int64_t>(nextStepSample_);
+        flushNoteOffs(stepSample + 1, blockStart);
+
+        const bool downbeat = stepIndex_ % 4 == 0;
+        const float density = 0.25f + 0.5f * p.syncopationLevel;
+        if (downbeat || nextRandom() < density) {
+            const int degree = kArpeggio[stepIndex_ % kArpeggio.size()];
+            const int pitch = kRootNote + scaleDegreeSemitones(p.mode, degree);
+
+            const float base = p.velocityMin + (p.velocityMax - p.velocityMin) * p.dynamics;
+            const float accent = downbeat ? 8.0f : 0.0f;
+            const float jitter = (nextRandom() - 0.5f) * 12.0f;
+            const int velocity = std::clamp(static_cast<int>(base + accent + jitter),
+                                            static_cast<int>(p.velocityMin), static_cast<int>(p.velocityMax));
+
+            startNote(stepSample, static_cast<uint8_t>(pitch), static_cast<uint8_t>(std::max(velocity, 1)),
+                      noteLength, blockStart);
+
+            if (p.clusterProbability > 0.0f && nextRandom() < p.clusterProbability) {
+                startNote(stepSample, static_cast<uint8_t>(pitch + 1),
+                          static_cast<uint8_t>(std::max(velocity * 4 / 5, 1)), noteLength, blockStart);
+            }
+        }
+
+        nextStepSample_ += samplesPerStep;
+        ++stepIndex_;
+    }
+
+    flushNoteOffs(blockEnd, blockStart);
+    samplePosition_ = blockEnd;
+
+    return {events_.data(), eventCount_};
+}
+
+std::span<const GeneratedMidiEvent> RealtimeGenerator::allNotesOff() {
+    eventCount_ = 0;
+    for (size_t i = 0; i < pendingCount_; ++i) {
+        push(0, pending_[i].note, 0);
+    }
+    pendingCount_ = 0;
+    return {events_.data(), eventCount_};
+}
+
+void RealtimeGenerator::startNote(int64_t sample, uint8_t note, uint8_t velocity,
+                                  int64_t lengthSamples, int64_t blockStart) {
+    const int offset = static_cast<int>(sample - blockStart);
+
+    // Retriggering a sounding pitch, or running out of voices, ends the old note first
+    size_t victim = pendingCount_;
+    for (size_t i = 0; i < pendingCount_; ++i) {
+        if (pending_[i].note == note) {
+            victim = i;
+            break;
+        }
+    }
+    if (victim == pendingCount_ && pendingCount_ == kMaxPendingNotes) {
+        victim = 0;
+        for (size_t i = 1; i < pendingCount_; ++i) {
+            if (pending_[i].sample < pending_[victim].sample) {
+                victim = i;
+            }
+        }
+    }
+    if (victim < pendingCount_) {
+        // Buffer full: the note-off stays pending and the new note is dropped
+        if (!push(offset, pending_[victim].note, 0)) {
+            return;
+        }
+        pending_[victim] = pending_[--pendingCount_];
+    }
+
+    if (push(offset, note, velocity)) {
+        pending_[pendingCount_++] = PendingNoteOff{sample + std::max<int64_t>(lengthSamples, 1), note};
+    }
+}
+
+void RealtimeGenerator::flushNoteOffs(int64_t untilSample, int64_t blockStart) {
+    // At most kMaxPendingNotes entries, so a selection pass keeps output ordered
+    while (pendingCount_ > 0) {
+        size_t earliest = 0;
+        for (size_t i = 1; i < pendingCount_; ++i) {
+            if (pending_[i].sample < pending_[earliest].sample) {
+                earliest = i;
+            }
+        }
+        if (pending_[earliest].sample >= untilSample) {
+            break;
+        }
+        const int offset = static_cast<int>(std::max<int64_t>(pending_[earliest].sample - blockStart, 0));
+        if (!push(offset, pending_[earliest].note, 0)) {
+            break;  // buffer full: released at the start of the next block
+        }
+        pending_[earliest] = pending_[--pendingCount_];
+    }
+}
+
+bool RealtimeGenerator::push(int sampleOffset, uint8_t note, uint8_t velocity) {
+    if (eventCount_ >= events_.size()) {
+        return false;
+    }
+    events_[eventCount_++] = GeneratedMidiEvent{sampleOffset, note, velocity};
+    return true;
+}
+
+float RealtimeGenerator::nextRandom() {
+    // xorshift32: deterministic and allocation-free
+    rngState_ ^= rngState_ << 13;
+    rngState_ ^= rngState_ >> 17;
+    rngState_ ^= rngState_ << 5;
+    return static_cast<float>(rngState_ >> 8) * (1.0f / 16777216.0f);
+}
+
+} // namespace kelly
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "emotion_engine.h"
+#include "emotion_model.h"
+#include "emotion_trajectory.h"
+#include "musical_params.h"
+#include "triple_buffer.h"
+
+namespace kelly {
+
+class IntentProcessor;
+
+struct GeneratedMidiEvent {
+    int sampleOffset;  // within the current block
+    uint8_t note;
+    uint8_t velocity;  // 0 = note-off
+};
+
+// Emotion → MIDI step generator that runs inside processBlock.
+// Everything is sized in prepare(); process() is allocation- and lock-free and
+// reads only plain-data MusicalParams. The message thread publishes the
+// current emotion and its params through a TripleBuffer; process() adopts
+// the newest block at its start, wait-free.
+class RealtimeGenerator {
+public:
+    static constexpr size_t kMaxPendingNotes = 32;
+    static constexpr double kMaxBpm = 300.0;
+    static constexpr uint8_t kRootNote = 60;
+    static constexpr float kMinTempoModifier = 0.25f;
+    static constexpr float kMaxTempoModifier = 2.0f;  // published params are clamped to this range
+
+    // One published parameter block
+    struct Intent {
+        int emotionId = 0;
+        MusicalParams params;
+    };
+
+    explicit RealtimeGenerator(const IntentProcessor& processor);
+    ~RealtimeGenerator() = default;
+
+    // Not real-time safe: sizes the event buffer for the given block size
+    void prepare(double sampleRate, int samplesPerBlock);
+    void reset();
+
+    // Message thread (single producer); picked up on the next block.
+    // setEmotion publishes the model's shared compiled params for emotionId,
+    // publishIntent a caller-compiled block such as IntentResult::musicalParams.
+    void setEmotion(int emotionId);
+    void publishIntent(int emotionId, const MusicalParams& params);
+    // Last published emotion; the audio thread may still be on the previous one
+    int getEmotion() const { return emotionId_.load(std::memory_order_relaxed); }
+
+    // Audio thread: the block process() is currently using
+    const Intent& getActiveIntent() const { return intents_.front(); }
+
+    // Audio thread: tempo, dynamics and mode from a trajectory frame override
+    // the active params from the next process() call; null clears it
+    void setMorph(const MorphFrame* frame) noexcept;
+
+    // Not for the audio thread: may compile the node on first use
+    const MusicalParams& getParams(int emotionId) const;
+
+    // Audio thread. Returns events ordered by sample offset, valid until the next call.
+    std::span<const GeneratedMidiEvent> process(int numSamples, double bpm);
+
+    // Audio thread. Releases every sounding note at offset 0.
+    std::span<const GeneratedMidiEvent> allNotesOff();
+
+private:
+    struct PendingNoteOff {
+        int64_t sample;
+        uint8_t note;
+    };
+
+    void startNote(int64_t sample, uint8_t note, uint8_t velocity, int64_t lengthSamples, int64_t blockStart);
+    void flushNoteOffs(int64_t untilSample, int64_t blockStart);
+    bool push(int sampleOffset, uint8_t note, uint8_t velocity);
+    float nextRandom();
+
+    EmotionModelHandle model_;  // owns the shared per-node params
+    std::atomic<int> emotionId_{0};
+    TripleBuffer<Intent> intents_;
+    MorphFrame morph_;
+    bool morphActive_ = false;
+
+    double sampleRate_ = 44100.0;
+    int64_t samplePosition_ = 0;
+    double nextStepSample_ = 0.0;
+    uint32_t stepIndex_ = 0;
+    uint32_t rngState_ = 0x4b656c6cu;
+
+    std::array<PendingNoteOff, kMaxPendingNotes> pending_{};
+    size_t pendingCount_ = 0;
+
+    std::vector<GeneratedMidiEvent> events_;
+    size_t eventCount_ = 0;
+};
+
+} // namespace kelly
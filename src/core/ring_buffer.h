@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace kelly {
+
+// Fixed-capacity FIFO that overwrites its oldest entry when full.
+// Storage is allocated once at construction; pushes reuse existing slots,
+// so element types like std::string keep their capacity across wraps.
+// Not thread-safe.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity)
+        : slots_(std::max<size_t>(capacity, 1)) {}
+
+    size_t capacity() const { return slots_.size(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == slots_.size(); }
+
+    // Index 0 is the oldest entry
+    const T& operator[](size_t i) const { return slots_[(tail() + i) % slots_.size()]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    void push(const T& value) { slot() = value; advance(); }
+    void push(T&& value) { slot() = std::move(value); advance(); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+        const_iterator(const RingBuffer* buffer, size_t index) : buffer_(buffer), index_(index) {}
+
+        reference operator*() const { return (*buffer_)[index_]; }
+        pointer operator->() const { return &(*buffer_)[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        const_iterator operator++(int) { auto copy = *this; ++index_; return copy; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+
+    private:
+        const RingBuffer* buffer_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size_}; }
+
+private:
+    size_t tail() const { return (head_ + slots_.size() - size_) % slots_.size(); }
+    T& slot() { return slots_[head_]; }
+
+    void advance() {
+        head_ = (head_ + 1) % slots_.size();
+        size_ = std::min(size_ + 1, slots_.size());
+    }
+
+    std::vector<T> slots_;
+    size_t head_ = 0;  // next slot to write
+    size_t size_ = 0;
+};
+
+} // namespace kelly
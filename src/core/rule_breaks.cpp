@@ -0,0 +1,90 @@
+#include "rule_breaks.h"
+#include "profiling.h"
+#include <cmath>
+
+namespace kelly {
+
+std::vector<RuleBreak> ruleBreaksFor(const EmotionNode& emotion) {
+    KELLY_ZONE();
+    std::vector<RuleBreak> breaks;
+
+    // High intensity emotions break more rules
+    if (emotion.intensity > 0.8f) {
+        RuleBreak rb;
+        rb.ruleType = "dynamics";
+        rb.type = RuleBreakType::Dynamics;
+        rb.severity = emotion.intensity;
+        rb.description = "Extreme dynamic contrasts";
+        rb.impact.set(MusicalParamId::VelocityMin, 10)
+                 .set(MusicalParamId::VelocityMax, 127)
+                 .raise(MusicalFlag::SuddenChanges);
+        breaks.push_back(rb);
+    }
+
+    // Negative valence introduces dissonance
+    if (emotion.valence < -0.5f) {
+        RuleBreak rb;
+        rb.ruleType = "harmony";
+        rb.type = RuleBreakType::Harmony;
+        rb.severity = std::abs(emotion.valence);
+        rb.description = "Dissonant intervals and clusters";
+        rb.impact.set(MusicalParamId::ClusterProbability, std::abs(emotion.valence))
+                 .raise(MusicalFlag::AllowDissonance);
+        breaks.push_back(rb);
+    }
+
+    // High arousal breaks rhythmic conventions
+    if (emotion.arousal > 0.7f) {
+        RuleBreak rb;
+        rb.ruleType = "rhythm";
+        rb.type = RuleBreakType::Rhythm;
+        rb.severity = emotion.arousal;
+        rb.description = "Irregular rhythms and syncopation";
+        rb.impact.set(MusicalParamId::SyncopationLevel, emotion.arousal)
+                 .raise(MusicalFlag::IrregularMeters);
+        breaks.push_back(rb);
+    }
+
+    return breaks;
+}
+
+MusicalParams musicalParamsFor(const EmotionNode& emotion, std::span<const RuleBreak> ruleBreaks) {
+    KELLY_ZONE();
+    MusicalParams params;
+    params.tempoModifier = emotion.musicalAttributes.tempoModifier;
+    params.mode = musicalModeFromName(emotion.musicalAttributes.mode);
+    params.dynamics = emotion.musicalAttributes.dynamics;
+
+    for (const auto& rb : ruleBreaks) {
+        rb.impact.applyTo(params);
+    }
+
+    return params;
+}
+
+CompiledEmotion compileEmotion(const EmotionNode& emotion) {
+    CompiledEmotion compiled;
+    compiled.ruleBreaks = ruleBreaksFor(emotion);
+    compiled.musicalParams = musicalParamsFor(emotion, compiled.ruleBreaks);
+    for (const auto& rb : compiled.ruleBreaks) {
+        for (const auto& [key, value] : rb.musicalImpact) {
+            compiled.extensionParams[key] = value;
+        }
+    }
+    return compiled;
+}
+
+CompiledEmotionCache::CompiledEmotionCache(const EmotionEngine& engine)
+    : engine_(engine) {}
+
+const CompiledEmotion* CompiledEmotionCache::get(int emotionId) const {
+    const EmotionNode* node = engine_.getEmotion(emotionId);
+    if (node == nullptr || static_cast<size_t>(emotionId) >= entries_.size()) {
+        return nullptr;
+    }
+    const auto index = static_cast<size_t>(emotionId);
+    std::call_once(built_[index], [&] { entries_[index].emplace(compileEmotion(*node)); });
+    return &*entries_[index];
+}
+
+} // namespace kelly
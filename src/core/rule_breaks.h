@@ -0,0 +1,68 @@
+#pragma once
+
+#include <any>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "emotion_engine.h"
+#include "musical_params.h"
+
+namespace kelly {
+
+enum class RuleBreakType : uint8_t {
+    Dynamics,
+    Harmony,
+    Rhythm,
+    Other,  // extension rule breaks
+    Count
+};
+
+inline constexpr size_t kRuleBreakTypeCount = static_cast<size_t>(RuleBreakType::Count);
+
+struct RuleBreak {
+    std::string ruleType;  // e.g., "harmony", "rhythm", "dynamics"
+    RuleBreakType type = RuleBreakType::Other;
+    float severity;        // 0.0 to 1.0
+    std::string description;
+    MusicalImpact impact;
+    std::map<std::string, std::any> musicalImpact;  // extension values only
+};
+
+// Everything that follows from a node alone
+struct CompiledEmotion {
+    std::vector<RuleBreak> ruleBreaks;
+    MusicalParams musicalParams;
+    std::map<std::string, std::any> extensionParams;  // merged RuleBreak::musicalImpact
+};
+
+// Pure: the rules an emotion breaks, from its intensity, valence and arousal
+std::vector<RuleBreak> ruleBreaksFor(const EmotionNode& emotion);
+// Pure: the node's musical attributes with each rule break's impact applied
+MusicalParams musicalParamsFor(const EmotionNode& emotion, std::span<const RuleBreak> ruleBreaks);
+CompiledEmotion compileEmotion(const EmotionNode& emotion);
+
+// Per-node CompiledEmotion for one engine, built the first time each node
+// is asked for and immutable afterwards. After that, a lookup is an index
+// plus the std::call_once fast path. Thread-safe.
+class CompiledEmotionCache {
+public:
+    explicit CompiledEmotionCache(const EmotionEngine& engine);
+
+    CompiledEmotionCache(const CompiledEmotionCache&) = delete;
+    CompiledEmotionCache& operator=(const CompiledEmotionCache&) = delete;
+
+    // Null for IDs the engine does not know
+    const CompiledEmotion* get(int emotionId) const;
+
+private:
+    const EmotionEngine& engine_;
+    mutable std::array<std::once_flag, EmotionEngine::kEmotionCount> built_;
+    mutable std::array<std::optional<CompiledEmotion>, EmotionEngine::kEmotionCount> entries_;
+};
+
+} // namespace kelly
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+namespace kelly {
+
+// Bounded single-producer/single-consumer queue of trivially copyable values.
+// tryPush and tryPop are wait-free: one relaxed load of the caller's own
+// index, one acquire load of the other side's, a copy, and a release store.
+// The release store publishes the slot contents with the index. Indices run
+// freely and are masked on use, so all Capacity slots are usable.
+// Full pushes fail rather than overwrite, so the consumer never sees a torn slot.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(std::is_trivially_copyable_v<T>, "slots are copied without synchronization");
+    static_assert(Capacity >= 2 && std::has_single_bit(Capacity), "capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Producer thread only. Returns false when full.
+    bool tryPush(const T& value) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots_[head & kMask] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only. Returns false when empty.
+    bool tryPop(T& out) noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = slots_[tail & kMask];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Exact from either side's own thread when the other is idle, otherwise a snapshot
+    size_t sizeApprox() const noexcept {
+        // Tail first: head only grows, so the difference cannot wrap
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+    bool emptyApprox() const noexcept { return sizeApprox() == 0; }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kCacheLine = 64;
+
+    // Producer and consumer indices on separate cache lines
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    alignas(kCacheLine) std::array<T, Capacity> slots_{};
+};
+
+} // namespace kelly
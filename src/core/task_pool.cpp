@@ -0,0 +1,118 @@
+#include "task_pool.h"
+#include <algorithm>
+
+namespace kelly {
+
+namespace {
+
+// Lets submit() from inside a task push onto the running worker's own deque
+struct WorkerIdentity {
+    const TaskPool* pool = nullptr;
+    size_t index = 0;
+};
+
+thread_local WorkerIdentity currentWorker;
+
+} // namespace
+
+TaskPool::TaskPool(size_t threadCount) {
+    if (threadCount == 0) {
+        const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::max<size_t>(hardware - 1, 1);
+    }
+
+    queues_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<Worker>());
+    }
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this, i] { run(i); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void TaskPool::submit(Task task) {
+    const size_t index = currentWorker.pool == this
+        ? currentWorker.index
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+
+    // Counted before taking sleepMutex_, so a worker checking the predicate
+    // under it either sees the task or is already waiting for this notify
+    pending_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_one();
+}
+
+bool TaskPool::popTask(size_t index, Task& task) {
+    {
+        Worker& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        Worker& victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::run(size_t index) {
+    currentWorker = WorkerIdentity{this, index};
+
+    Task task;
+    while (true) {
+        if (popTask(index, task)) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_.load(std::memory_order_acquire) > 0; });
+        if (stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+TaskPoolHandle TaskPool::shared() {
+    static std::mutex mutex;
+    static std::weak_ptr<TaskPool> current;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    TaskPoolHandle pool = current.lock();
+    if (!pool) {
+        pool = std::make_shared<TaskPool>();
+        current = pool;
+    }
+    return pool;
+}
+
+} // namespace kelly
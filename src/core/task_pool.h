@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kelly {
+
+class TaskPool;
+using TaskPoolHandle = std::shared_ptr<TaskPool>;
+
+// Work-stealing pool for jobs that are too heavy for the audio thread.
+// Each worker owns a deque: it pops its own newest task and steals the
+// oldest from its neighbours when empty, so bursts submitted by one plugin
+// instance spread across cores. Idle workers sleep on a condition variable.
+// submit() allocates and locks, so it must not be called on the audio thread.
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+
+    // 0 = one worker per hardware thread, minus one for the audio thread
+    explicit TaskPool(size_t threadCount = 0);
+    // Finishes every queued task, then joins. Must not run on one of the
+    // pool's own workers, so tasks should not hold the last TaskPoolHandle.
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // From a worker, the task goes to that worker's own deque; otherwise round-robin
+    void submit(Task task);
+
+    size_t getThreadCount() const { return workers_.size(); }
+    // Queued, not yet started
+    size_t getPendingCount() const { return pending_.load(std::memory_order_relaxed); }
+
+    // One pool per process while any instance holds it
+    static TaskPoolHandle shared();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(size_t index);
+    bool popTask(size_t index, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<size_t> pending_{0};
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;  // guarded by sleepMutex_
+};
+
+} // namespace kelly
@@ -0,0 +1,66 @@
+#include "tempo_map.h"
+#include <algorithm>
+
+namespace kelly {
+
+namespace {
+
+int clampBpm(int bpm) {
+    return std::clamp(bpm, TempoMap::kMinBpm, TempoMap::kMaxBpm);
+}
+
+} // namespace
+
+TempoMap::TempoMap(int bpm) {
+    setTempo(bpm);
+}
+
+void TempoMap::setTempo(int bpm) {
+    changes_.assign(1, TempoChange{0, clampBpm(bpm)});
+    tickSeconds_.assign(1, 0.0);
+}
+
+void TempoMap::setTempoAt(uint32_t tick, int bpm) {
+    auto it = std::lower_bound(changes_.begin(), changes_.end(), tick,
+                               [](const TempoChange& change, uint32_t t) { return change.tick < t; });
+    if (it != changes_.end() && it->tick == tick) {
+        it->bpm = clampBpm(bpm);
+    } else {
+        changes_.insert(it, TempoChange{tick, clampBpm(bpm)});
+    }
+    rebuildOffsets();
+}
+
+int TempoMap::getTempoAt(uint32_t tick) const {
+    return changes_[segmentAt(tick)].bpm;
+}
+
+double TempoMap::tickToSeconds(double tick, uint32_t ppq) const {
+    const size_t i = segmentAt(tick);
+    const double scaled = tickSeconds_[i] + (tick - changes_[i].tick) * 60.0 / changes_[i].bpm;
+    return scaled / std::max<uint32_t>(ppq, 1);
+}
+
+double TempoMap::secondsToTick(double seconds, uint32_t ppq) const {
+    const double scaled = seconds * std::max<uint32_t>(ppq, 1);
+    const auto it = std::upper_bound(tickSeconds_.begin() + 1, tickSeconds_.end(), scaled);
+    const auto i = static_cast<size_t>(it - tickSeconds_.begin()) - 1;
+    return changes_[i].tick + (scaled - tickSeconds_[i]) * changes_[i].bpm / 60.0;
+}
+
+size_t TempoMap::segmentAt(double tick) const {
+    // changes_[0] is at tick 0, so earlier ticks extrapolate the first tempo
+    const auto it = std::upper_bound(changes_.begin() + 1, changes_.end(), tick,
+                                     [](double t, const TempoChange& change) { return t < change.tick; });
+    return static_cast<size_t>(it - changes_.begin()) - 1;
+}
+
+void TempoMap::rebuildOffsets() {
+    tickSeconds_.resize(changes_.size());
+    tickSeconds_[0] = 0.0;
+    for (size_t i = 1; i < changes_.size(); ++i) {
+        tickSeconds_[i] = tickSeconds_[i - 1] + (changes_[i].tick - changes_[i - 1].tick) * 60.0 / changes_[i - 1].bpm;
+    }
+}
+
+} // namespace kelly
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace kelly {
+
+struct TempoChange {
+    uint32_t tick;  // where the tempo takes effect
+    int bpm;
+};
+
+// Piecewise-constant tempo over a tick timeline. Each change also stores the
+// elapsed time at its tick, so converting between ticks and seconds is a
+// binary search plus one multiply. Ticks are resolution-free; the
+// conversions take the ticks per quarter note.
+class TempoMap {
+public:
+    static constexpr int kMinBpm = 1;
+    static constexpr int kMaxBpm = 999;
+
+    explicit TempoMap(int bpm = 120);
+
+    // Replaces the whole map with a single tempo
+    void setTempo(int bpm);
+    // Adds a change, replacing one already at that tick
+    void setTempoAt(uint32_t tick, int bpm);
+
+    int getTempo() const { return changes_.front().bpm; }  // at tick 0
+    int getTempoAt(uint32_t tick) const;
+    // Always starts at tick 0
+    std::span<const TempoChange> getChanges() const { return changes_; }
+
+    double tickToSeconds(double tick, uint32_t ppq) const;
+    double secondsToTick(double seconds, uint32_t ppq) const;
+
+private:
+    size_t segmentAt(double tick) const;
+    void rebuildOffsets();
+
+    std::vector<TempoChange> changes_;
+    std::vector<double> tickSeconds_;  // seconds × ppq elapsed at each change
+};
+
+} // namespace kelly
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace kelly {
+
+// Latest-value hand-off from one producer thread to one consumer thread.
+// Three slots: the producer owns the back slot, the consumer owns the front
+// slot, and the middle one is swapped between them by a single atomic byte
+// holding its index plus a "fresh" bit. publish() and update() are one
+// atomic exchange each, so both sides are wait-free and neither ever sees a
+// slot the other is writing or reading. Intermediate values published
+// between two update() calls are skipped, which is what a parameter block wants.
+//
+// Memory ordering: publish() exchanges with acq_rel. Release makes the
+// producer's writes to the back slot visible with the index. Acquire makes
+// sure the consumer had finished reading the slot handed back. update()
+// mirrors this. The relaxed fresh-bit check in update() only decides
+// whether to exchange.
+//
+// Sizing: 3 × sizeof(T), each slot on its own cache line so the producer
+// writing back and the consumer reading front don't share one.
+template <typename T>
+class TripleBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "slots are handed over without copying constructors");
+
+public:
+    explicit TripleBuffer(const T& initial = T{}) {
+        for (Slot& slot : slots_) {
+            slot.value = initial;
+        }
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer thread only: fill back(), then publish() it
+    T& back() { return slots_[back_].value; }
+    void publish() {
+        const uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+    }
+    void write(const T& value) {
+        back() = value;
+        publish();
+    }
+
+    // Consumer thread only: adopts the newest published value, if any.
+    // Returns true when front() changed.
+    bool update() {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) {
+            return false;
+        }
+        const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & kIndexMask;
+        return true;
+    }
+    const T& front() const { return slots_[front_].value; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+    static constexpr size_t kCacheLine = 64;
+
+    struct alignas(kCacheLine) Slot {
+        T value;
+    };
+
+    std::array<Slot, 3> slots_{};
+    alignas(kCacheLine) std::atomic<uint8_t> middle_{1};
+    alignas(kCacheLine) uint8_t back_ = 0;  // producer-owned
+    alignas(kCacheLine) uint8_t front_ = 2; // consumer-owned
+};
+
+} // namespace kelly
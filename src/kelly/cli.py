@@ -96,7 +96,7 @@ def process(
     
     # Save or display
     if output:
-        midi_file = generator.create_midi_file(chord_progression, groove, str(output))
+        generator.save_midi(chord_progression, str(output), groove)
         console.print(f"\n[bold green]✓[/bold green] MIDI file saved to: {output}")
     else:
         console.print(f"\n[dim]No output file specified. Use --output to save MIDI.[/dim]")
@@ -108,6 +108,60 @@ def process(
     console.print(f"  Dissonance: {allow_dissonance}\n")
 
 
+@app.command()
+def batch(
+    wounds_file: Path = typer.Argument(..., help="Text file with one wound description per line"),
+    intensity: float = typer.Option(0.7, help="Intensity of every wound (0.0-1.0)"),
+    output_dir: Optional[Path] = typer.Option(None, help="Directory for one MIDI file per wound"),
+    tempo: int = typer.Option(120, help="Tempo in BPM"),
+    groove: str = typer.Option("straight", help="Groove template (straight/swing/syncopated)")
+) -> None:
+    """
+    Process many wounds in one call and optionally export a MIDI file for each.
+
+    Example:
+        kelly batch wounds.txt --output-dir out/
+    """
+    descriptions = [line.strip() for line in wounds_file.read_text().splitlines() if line.strip()]
+    processor = IntentProcessor()
+    results = processor.process_intents([
+        Wound(description=description, intensity=intensity, source="batch")
+        for description in descriptions
+    ])
+
+    generator = MidiGenerator(tempo=tempo)
+    if output_dir:
+        output_dir.mkdir(parents=True, exist_ok=True)
+
+    table = Table(title="Kelly Batch")
+    table.add_column("#", style="cyan")
+    table.add_column("Wound", style="white")
+    table.add_column("Emotion", style="magenta")
+    table.add_column("Mode", style="green")
+    table.add_column("Rule Breaks", style="yellow")
+
+    for index, result in enumerate(results):
+        params = result["musical_params"]
+        mode = params.get("mode", "minor")
+        if output_dir:
+            chord_progression = generator.generate_chord_progression(
+                mode=mode,
+                allow_dissonance=params.get("allow_dissonance", False)
+            )
+            generator.save_midi(chord_progression, str(output_dir / f"wound_{index:03d}.mid"), groove)
+        table.add_row(
+            str(index),
+            result["wound"].description,
+            result["emotion"].name,
+            mode,
+            ", ".join(rb.rule_type for rb in result["rule_breaks"]) or "-"
+        )
+
+    console.print(table)
+    if output_dir:
+        console.print(f"\n[bold green]✓[/bold green] {len(results)} MIDI files saved to: {output_dir}")
+
+
 @app.command()
 def version() -> None:
     """Show Kelly version."""
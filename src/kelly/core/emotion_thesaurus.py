@@ -3,6 +3,8 @@ from typing import Dict, List, Optional, Tuple
 from dataclasses import dataclass
 from enum import Enum
 
+from kelly.core.native import get_native
+
 
 class EmotionCategory(Enum):
     """Primary emotion categories."""
@@ -161,7 +163,9 @@ class EmotionThesaurus:
                     )
                     node_id += 1
 
-        # Build related_emotions links for nearby emotions
+        # Build related_emotions links for nearby emotions; with the native
+        # module these come from its precomputed neighbor table instead of
+        # 216 Python distance scans
         for nid, node in self.nodes.items():
             node.related_emotions = [
                 other.id for other in self.get_nearby_emotions(nid, threshold=0.35)
@@ -173,6 +177,11 @@ class EmotionThesaurus:
     
     def find_emotion_by_name(self, name: str) -> Optional[EmotionNode]:
         """Find emotion by name."""
+        native = get_native()
+        if native is not None:
+            # Hashed lookup in KellyCore; node IDs match this thesaurus
+            emotion_id = native.find_emotion(name.lower())
+            return self.nodes.get(emotion_id) if emotion_id >= 0 else None
         for node in self.nodes.values():
             if node.name.lower() == name.lower():
                 return node
@@ -194,6 +203,12 @@ class EmotionThesaurus:
         source = self.get_emotion(emotion_id)
         if not source:
             return []
+
+        native = get_native()
+        if native is not None:
+            # KellyCore's neighbor table is nearest first; keep ID order
+            ids = sorted(native.nearby_emotions(emotion_id, threshold).tolist())
+            return [self.nodes[other] for other in ids]
         
         nearby = []
         for node in self.nodes.values():
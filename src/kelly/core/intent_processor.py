@@ -1,9 +1,10 @@
 """Three-phase intent processing: Wound → Emotion → Rule-breaks."""
-from typing import Dict, List, Optional
+from typing import Dict, List, Optional, Tuple
 from dataclasses import dataclass
 from enum import Enum
 
 from kelly.core.emotion_thesaurus import EmotionThesaurus, EmotionNode
+from kelly.core.native import get_native
 
 
 class IntentPhase(Enum):
@@ -44,10 +45,16 @@ class IntentProcessor:
         self.thesaurus = EmotionThesaurus()
         self.wound_history: List[Wound] = []
         self.rule_breaks: List[RuleBreak] = []
+        self._native_processor = None
+        self._native_nodes: List[Optional[EmotionNode]] = []
     
     def process_wound(self, wound: Wound) -> EmotionNode:
         """
         Phase 1: Process a wound and map it to an emotion.
+
+        Classified by the native KellyCore keyword matcher when
+        ``kelly._native`` is built, so single wounds map exactly as
+        ``process_intents`` batches do.
         
         Args:
             wound: The wound to process
@@ -56,6 +63,10 @@ class IntentProcessor:
             The mapped emotion node
         """
         self.wound_history.append(wound)
+
+        native = self._native_backend()
+        if native is not None:
+            return self._native_emotion(native.classify(wound.description))
         
         # Simple mapping based on wound characteristics
         # In full implementation, this would use ML/pattern matching
@@ -85,39 +96,15 @@ class IntentProcessor:
         
         # High intensity emotions break more rules
         if emotion.intensity > 0.8:
-            rule_breaks.append(RuleBreak(
-                rule_type="dynamics",
-                severity=emotion.intensity,
-                description="Extreme dynamic contrasts",
-                musical_impact={
-                    "velocity_range": (10, 127),
-                    "sudden_changes": True
-                }
-            ))
+            rule_breaks.append(_dynamics_break(emotion.intensity, 10, 127))
         
         # Negative valence introduces dissonance
         if emotion.valence < -0.5:
-            rule_breaks.append(RuleBreak(
-                rule_type="harmony",
-                severity=abs(emotion.valence),
-                description="Dissonant intervals and clusters",
-                musical_impact={
-                    "allow_dissonance": True,
-                    "cluster_probability": abs(emotion.valence)
-                }
-            ))
+            rule_breaks.append(_harmony_break(abs(emotion.valence)))
         
         # High arousal breaks rhythmic conventions
         if emotion.arousal > 0.7:
-            rule_breaks.append(RuleBreak(
-                rule_type="rhythm",
-                severity=emotion.arousal,
-                description="Irregular rhythms and syncopation",
-                musical_impact={
-                    "syncopation_level": emotion.arousal,
-                    "irregular_meters": True
-                }
-            ))
+            rule_breaks.append(_rhythm_break(emotion.arousal))
         
         self.rule_breaks.extend(rule_breaks)
         return rule_breaks
@@ -145,6 +132,64 @@ class IntentProcessor:
             "musical_params": self._compile_musical_params(emotion, rule_breaks)
         }
     
+    def process_intents(self, wounds: List[Wound]) -> List[Dict[str, any]]:
+        """
+        Batch intent processing.
+
+        Uses the native KellyCore processor when ``kelly._native`` is
+        built: the whole batch crosses into C++ as one call, and the
+        results are read from the returned ``WOUND_RESULT_DTYPE`` columns
+        instead of being recomputed per wound. Without it, this is
+        ``process_intent`` per wound.
+
+        Args:
+            wounds: Wounds to process, in order
+
+        Returns:
+            One intent processing result per wound
+        """
+        native = self._native_backend()
+        if native is None or not wounds:
+            return [self.process_intent(wound) for wound in wounds]
+
+        rows = native.process_wounds(
+            [wound.description for wound in wounds],
+            [wound.intensity for wound in wounds],
+        )
+        # One conversion per column rather than per field of every row
+        columns = {name: rows[name].tolist() for name in rows.dtype.names}
+
+        results = []
+        for i, wound in enumerate(wounds):
+            self.wound_history.append(wound)
+            emotion = self._native_emotion(columns["emotion_id"][i])
+            rule_breaks, params = _native_result(emotion, {name: column[i] for name, column in columns.items()})
+            self.rule_breaks.extend(rule_breaks)
+            results.append({
+                "wound": wound,
+                "emotion": emotion,
+                "rule_breaks": rule_breaks,
+                "musical_params": params,
+            })
+        return results
+
+    def _native_backend(self):
+        """The native IntentProcessor, created on first use; None without ``kelly._native``."""
+        native = get_native()
+        if native is None:
+            return None
+        if self._native_processor is None:
+            self._native_processor = native.IntentProcessor()
+            self._native_nodes = [
+                self.thesaurus.get_emotion(emotion_id) for emotion_id in range(native.EMOTION_COUNT)
+            ]
+        return self._native_processor
+
+    def _native_emotion(self, emotion_id: int) -> EmotionNode:
+        """Thesaurus node for a native emotion ID, falling back like ``process_wound``."""
+        emotion = self._native_nodes[emotion_id] if 0 <= emotion_id < len(self._native_nodes) else None
+        return emotion if emotion else self.thesaurus.nodes[0]
+
     def _compile_musical_params(
         self, emotion: EmotionNode, rule_breaks: List[RuleBreak]
     ) -> Dict[str, any]:
@@ -155,3 +200,70 @@ class IntentProcessor:
             params.update(rb.musical_impact)
         
         return params
+
+
+# kelly::MusicalFlag bits in WOUND_RESULT_DTYPE["flags"]
+_FLAG_ALLOW_DISSONANCE = 1 << 0
+_FLAG_SUDDEN_CHANGES = 1 << 1
+_FLAG_IRREGULAR_METERS = 1 << 2
+
+
+def _dynamics_break(severity: float, velocity_min: int, velocity_max: int) -> RuleBreak:
+    return RuleBreak(
+        rule_type="dynamics",
+        severity=severity,
+        description="Extreme dynamic contrasts",
+        musical_impact={
+            "velocity_range": (velocity_min, velocity_max),
+            "sudden_changes": True
+        }
+    )
+
+
+def _harmony_break(cluster_probability: float) -> RuleBreak:
+    return RuleBreak(
+        rule_type="harmony",
+        severity=cluster_probability,
+        description="Dissonant intervals and clusters",
+        musical_impact={
+            "allow_dissonance": True,
+            "cluster_probability": cluster_probability
+        }
+    )
+
+
+def _rhythm_break(syncopation_level: float) -> RuleBreak:
+    return RuleBreak(
+        rule_type="rhythm",
+        severity=syncopation_level,
+        description="Irregular rhythms and syncopation",
+        musical_impact={
+            "syncopation_level": syncopation_level,
+            "irregular_meters": True
+        }
+    )
+
+
+def _native_result(emotion: EmotionNode, row: Dict[str, any]) -> Tuple[List[RuleBreak], Dict[str, any]]:
+    """Rule breaks and musical params from one native result row.
+
+    The native compiler raises one flag per rule break and writes its
+    impact into the row, so both are rebuilt here without re-deriving
+    them from the emotion.
+    """
+    rule_breaks = []
+    if row["flags"] & _FLAG_SUDDEN_CHANGES:
+        rule_breaks.append(_dynamics_break(emotion.intensity, row["velocity_min"], row["velocity_max"]))
+    if row["flags"] & _FLAG_ALLOW_DISSONANCE:
+        rule_breaks.append(_harmony_break(row["cluster_probability"]))
+    if row["flags"] & _FLAG_IRREGULAR_METERS:
+        rule_breaks.append(_rhythm_break(row["syncopation_level"]))
+
+    params = {
+        "tempo_modifier": row["tempo_modifier"],
+        "mode": "major" if row["mode"] == 1 else "minor",
+        "dynamics": row["dynamics"],
+    }
+    for rb in rule_breaks:
+        params.update(rb.musical_impact)
+    return rule_breaks, params
@@ -1,8 +1,13 @@
 """MIDI generation and pipeline."""
 from typing import Dict, List, Optional, Tuple
 from dataclasses import dataclass
+import io
 import mido
 
+from kelly.core.native import get_native
+
+TICKS_PER_BEAT = 480
+
 
 @dataclass
 class GrooveTemplate:
@@ -42,7 +47,7 @@ class MidiGenerator:
                 name="Swing",
                 time_signature=(4, 4),
                 pattern=[(0.0, 100), (0.33, 80), (0.5, 100), (0.83, 80)],
-                swing=0.66
+                swing=0.0  # positions are already swung
             ),
             "syncopated": GrooveTemplate(
                 name="Syncopated",
@@ -182,3 +187,77 @@ class MidiGenerator:
             mid.save(output_path)
         
         return mid
+
+    def chord_notes(
+        self,
+        chord_progression: List[List[int]],
+        groove: str = "straight"
+    ) -> List[Tuple[int, int, int, int]]:
+        """
+        Lay a chord progression out as notes, one chord per bar.
+
+        Args:
+            chord_progression: List of chords
+            groove: Name of groove template to use
+
+        Returns:
+            (note, velocity, time, duration) tuples in ticks, sorted by time
+        """
+        groove_template = self.groove_templates.get(groove, self.groove_templates["straight"])
+        beats_per_bar = groove_template.time_signature[0]
+        duration = int(TICKS_PER_BEAT * 0.25)
+
+        notes = []
+        for bar, chord in enumerate(chord_progression):
+            for beat_time, velocity in groove_template.pattern:
+                time = int((bar + beat_time) * beats_per_bar * TICKS_PER_BEAT)
+                notes.extend((note, velocity, time, duration) for note in chord)
+        return notes
+
+    def midi_bytes(
+        self,
+        chord_progression: List[List[int]],
+        groove: str = "straight"
+    ) -> bytes:
+        """
+        Standard MIDI File bytes for a chord progression.
+
+        Written by KellyCore's SMF writer in one call when ``kelly._native``
+        is built, otherwise through mido.
+        """
+        notes = self.chord_notes(chord_progression, groove)
+        native = get_native()
+        if native is not None:
+            import numpy as np
+            return native.write_midi(
+                np.array(notes, dtype=native.NOTE_DTYPE), bpm=self.tempo, ppq=TICKS_PER_BEAT
+            )
+
+        events = []
+        for note, velocity, time, length in notes:
+            events.append((time, 1, mido.Message('note_on', note=note, velocity=velocity)))
+            events.append((time + length, 0, mido.Message('note_off', note=note, velocity=0)))
+        events.sort(key=lambda event: (event[0], event[1]))  # note-offs first at equal times
+
+        mid = mido.MidiFile(ticks_per_beat=TICKS_PER_BEAT)
+        track = mido.MidiTrack()
+        mid.tracks.append(track)
+        track.append(mido.MetaMessage('set_tempo', tempo=mido.bpm2tempo(self.tempo)))
+        last = 0
+        for time, _, message in events:
+            track.append(message.copy(time=time - last))
+            last = time
+
+        buffer = io.BytesIO()
+        mid.save(file=buffer)
+        return buffer.getvalue()
+
+    def save_midi(
+        self,
+        chord_progression: List[List[int]],
+        output_path: str,
+        groove: str = "straight"
+    ) -> None:
+        """Write a chord progression to a Standard MIDI File."""
+        with open(output_path, "wb") as f:
+            f.write(self.midi_bytes(chord_progression, groove))
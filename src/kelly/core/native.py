@@ -0,0 +1,19 @@
+"""Optional native KellyCore backend (the ``kelly._native`` extension).
+
+Build it with ``-DBUILD_PYTHON_BINDINGS=ON``. When the module is missing,
+``NATIVE_AVAILABLE`` is False and ``kelly.core`` runs its pure-Python code.
+"""
+from typing import Any, Optional
+
+_native: Optional[Any]
+try:
+    from kelly import _native
+except ImportError:
+    _native = None
+
+NATIVE_AVAILABLE = _native is not None
+
+
+def get_native() -> Optional[Any]:
+    """Return the extension module, or None when it is not built."""
+    return _native
@@ -0,0 +1,104 @@
+// Global allocation hooks: allocations made while an AudioThreadScope is
+// active are counted for the audio thread guard and the per-block
+// allocation plot, and in profiling builds every heap allocation is
+// reported to Tracy's memory view.
+//
+// Every replaceable form is hooked, including the align_val_t overloads
+// that over-aligned types (the alignas(64) blocks) go through, and the
+// nothrow ones. On Linux the plugin module is linked with
+// -Bsymbolic-functions so its own calls bind to these definitions rather
+// than to the host's libstdc++.
+
+#include "core/profiling.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+void* tryAllocate(std::size_t size) noexcept {
+    void* ptr = std::malloc(size != 0 ? size : 1);
+    if (ptr != nullptr) {
+        kelly::AudioThreadScope::noteAllocation();
+        KELLY_ALLOC(ptr, size);
+    }
+    return ptr;
+}
+
+void* tryAllocateAligned(std::size_t size, std::align_val_t alignment) noexcept {
+    const std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#if defined(_WIN32)
+    void* ptr = _aligned_malloc(size != 0 ? size : 1, align);
+#else
+    // aligned_alloc wants a size that is a multiple of the alignment
+    void* ptr = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+#endif
+    if (ptr != nullptr) {
+        kelly::AudioThreadScope::noteAllocation();
+        KELLY_ALLOC(ptr, size);
+    }
+    return ptr;
+}
+
+void* allocate(std::size_t size) {
+    void* ptr = tryAllocate(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    void* ptr = tryAllocateAligned(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void release(void* ptr) noexcept {
+    if (ptr != nullptr) {
+        KELLY_FREE(ptr);
+        std::free(ptr);
+    }
+}
+
+void releaseAligned(void* ptr) noexcept {
+    if (ptr != nullptr) {
+        KELLY_FREE(ptr);
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return tryAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return tryAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return tryAllocateAligned(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return tryAllocateAligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(ptr); }
@@ -1,22 +1,58 @@
 #include "plugin_editor.h"
+#include <algorithm>
 
 namespace kelly {
 
 PluginEditor::PluginEditor(PluginProcessor& p)
     : AudioProcessorEditor(&p), processor(p) {
     setSize(400, 300);
+    startTimerHz(kViolationPollHz);
+}
+
+PluginEditor::~PluginEditor() {
+    stopTimer();
 }
 
 void PluginEditor::paint(juce::Graphics& g) {
     g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
-    
+
+    auto bounds = getLocalBounds().reduced(10);
     g.setColour(juce::Colours::white);
     g.setFont(15.0f);
-    g.drawFittedText("Kelly Emotion Processor", getLocalBounds(), juce::Justification::centred, 1);
+    g.drawFittedText("Kelly Emotion Processor", bounds.removeFromTop(30), juce::Justification::centred, 1);
+
+    const AudioThreadGuard& guard = processor.getAudioGuard();
+    g.setFont(12.0f);
+    g.setColour(guard.getViolationCount() > 0 ? juce::Colours::orange : juce::Colours::lightgrey);
+    g.drawText("Audio thread: " + std::to_string(guard.getViolationCount()) + " violations in "
+                   + std::to_string(guard.getBlockCount()) + " blocks",
+               bounds.removeFromTop(20), juce::Justification::centredLeft);
+
+    g.setColour(juce::Colours::lightgrey);
+    for (size_t i = 0; i < recentCount_; ++i) {
+        g.drawText(describeViolation(recentViolations_[i]), bounds.removeFromTop(18),
+                   juce::Justification::centredLeft);
+    }
 }
 
 void PluginEditor::resized() {
     // Layout components
 }
 
+void PluginEditor::timerCallback() {
+    const size_t count = processor.getAudioGuard().drain(drained_);
+    if (count == 0) {
+        return;
+    }
+
+    // Keep the newest kShownViolations, newest first
+    const size_t incoming = std::min(count, kShownViolations);
+    const size_t kept = std::min(recentCount_, kShownViolations - incoming);
+    std::move_backward(recentViolations_.begin(), recentViolations_.begin() + kept,
+                       recentViolations_.begin() + incoming + kept);
+    std::reverse_copy(drained_.begin() + (count - incoming), drained_.begin() + count, recentViolations_.begin());
+    recentCount_ = incoming + kept;
+    repaint();
+}
+
 } // namespace kelly
@@ -1,21 +1,32 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
 #include "plugin_processor.h"
 
 namespace kelly {
 
-class PluginEditor : public juce::AudioProcessorEditor {
+class PluginEditor : public juce::AudioProcessorEditor, private juce::Timer {
 public:
+    static constexpr int kViolationPollHz = 10;
+    static constexpr size_t kShownViolations = 6;
+
     explicit PluginEditor(PluginProcessor&);
-    ~PluginEditor() override = default;
+    ~PluginEditor() override;
 
     void paint(juce::Graphics&) override;
     void resized() override;
 
 private:
+    // Drains the processor's audio guard into recentViolations_
+    void timerCallback() override;
+
     PluginProcessor& processor;
 
+    std::array<AudioViolation, AudioThreadGuard::kViolationCapacity> drained_{};
+    std::array<AudioViolation, kShownViolations> recentViolations_{};  // newest first
+    size_t recentCount_ = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginEditor)
 };
 
@@ -1,27 +1,201 @@
 #include "plugin_processor.h"
 #include "plugin_editor.h"
+#include "core/profiling.h"
+#include <algorithm>
+#include <cmath>
 
 namespace kelly {
 
+namespace {
+
+// Phrases are a few bars long, so this keeps the next one well ahead
+constexpr int kRendererServiceHz = 20;
+constexpr uint32_t kPhrasePpq = 480;
+
+void addEvents(juce::MidiBuffer& midiMessages, std::span<const GeneratedMidiEvent> events, int sampleOffset) {
+    for (const auto& e : events) {
+        const auto message = e.velocity > 0
+            ? juce::MidiMessage::noteOn(1, e.note, static_cast<juce::uint8>(e.velocity))
+            : juce::MidiMessage::noteOff(1, e.note);
+        midiMessages.addEvent(message, sampleOffset + e.sampleOffset);
+    }
+}
+
+int grooveFor(const GrooveTemplates& grooves, const MusicalParams& params) {
+    if (params.syncopationLevel > 0.5f) {
+        return grooves.findTemplateId("syncopated");
+    }
+    return grooves.findTemplateId(params.syncopationLevel > 0.2f ? "swing" : "straight");
+}
+
+} // namespace
+
 PluginProcessor::PluginProcessor()
     : AudioProcessor(BusesProperties()
                      .withInput("Input", juce::AudioChannelSet::stereo(), true)
                      .withOutput("Output", juce::AudioChannelSet::stereo(), true)) {
 }
 
+PluginProcessor::~PluginProcessor() {
+    stopTimer();
+}
+
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-    // Prepare audio processing
+    KELLY_ZONE();
+    profiling::AudioBlockScope::configurePlots();
+    generator_.prepare(sampleRate, samplesPerBlock);
+    chordTracker_.reset();
+    audioGuard_.prepare(sampleRate);
+    phraseOutput_.prepare(sampleRate, samplesPerBlock);
+    phrase_ = nullptr;
+    phraseStart_ = 0;
+    generatorActive_ = true;
+    wasPlaying_ = false;
+    renderer_.service();
+    startTimerHz(kRendererServiceHz);
 }
 
 void PluginProcessor::releaseResources() {
-    // Release resources
+    stopTimer();
+    generator_.reset();
+    phraseOutput_.reset();
+    chordTracker_.reset();
+}
+
+void PluginProcessor::timerCallback() {
+    // Phrases step through the trajectory's nodes as the audio thread reaches them
+    const int trajectoryEmotion = trajectory_.getCurrentEmotion();
+    if (trajectoryEmotion >= 0 && trajectoryEmotion != phraseEmotion_) {
+        if (const CompiledEmotion* compiled = intentProcessor_.getModel()->getCompiled(trajectoryEmotion)) {
+            requestPhrases(trajectoryEmotion, compiled->musicalParams);
+        }
+    }
+    renderer_.service();
 }
 
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    const AudioThreadGuard::Block guardedBlock = audioGuard_.monitorBlock(buffer.getNumSamples());
+    const profiling::AudioBlockScope blockScope(buffer.getNumSamples(), getSampleRate());
+    KELLY_ZONE();
     juce::ScopedNoDenormals noDenormals;
-    
-    // Process audio and MIDI
-    // Emotion-based processing would be implemented here
+
+    // No allocation, locks or strings past this point: the generator reads
+    // plain-data params precomputed per emotion and fills a preallocated buffer.
+    // audioGuard_ reports any that slip in, tagged with the AudioSection below.
+
+    // Track incoming harmony before our own notes are merged into the buffer
+    {
+        const AudioSection section("chord tracking");
+        KELLY_ZONE_NAMED("chord tracking");
+        for (const auto metadata : midiMessages) {
+            chordTracker_.handleMidiMessage({metadata.data, static_cast<size_t>(metadata.numBytes)});
+        }
+    }
+    const AudioSection playHeadSection("play head");
+    double bpm = 120.0;
+    double ppqPosition = 0.0;
+    bool isPlaying = true;
+    if (auto* playHead = getPlayHead()) {
+        if (auto position = playHead->getPosition()) {
+            if (auto hostBpm = position->getBpm(); hostBpm && *hostBpm > 0.0) {
+                bpm = *hostBpm;
+            }
+            if (auto hostPpq = position->getPpqPosition()) {
+                ppqPosition = std::max(*hostPpq, 0.0);
+            }
+            isPlaying = position->getIsPlaying();
+        }
+    }
+
+    const AudioSection generateSection("generate");
+    KELLY_ZONE_NAMED("generate");
+    const int numSamples = buffer.getNumSamples();
+    if (isPlaying) {
+        generator_.setMorph(trajectory_.advance(static_cast<uint64_t>(ppqPosition * kPhrasePpq)));
+        playPhrases(midiMessages, numSamples, ppqPosition * kPhrasePpq, bpm / 60.0 * kPhrasePpq / getSampleRate());
+        // The step generator covers the gap until the first phrase is rendered
+        if (phrase_ == nullptr) {
+            addEvents(midiMessages, generator_.process(numSamples, bpm), 0);
+        } else if (generatorActive_) {
+            addEvents(midiMessages, generator_.allNotesOff(), 0);
+            generatorActive_ = false;
+        }
+    } else if (wasPlaying_) {
+        addEvents(midiMessages, generator_.allNotesOff(), 0);
+        addEvents(midiMessages, phraseOutput_.allNotesOff(), 0);
+    }
+    wasPlaying_ = isPlaying;
+}
+
+void PluginProcessor::playPhrases(juce::MidiBuffer& midiMessages, int numSamples, double startTick, double ticksPerSample) {
+    KELLY_ZONE();
+    int done = 0;
+    double tick = startTick;
+    while (done < numSamples) {
+        // Takes the next pre-rendered phrase at a boundary; never renders here.
+        // Rounding lets a boundary a fraction of a tick away count as reached.
+        const RenderedPhrase* phrase = nullptr;
+        {
+            const AudioSection section("lookahead");
+            phrase = renderer_.advance(static_cast<uint64_t>(tick + 0.5));
+        }
+        if (phrase == nullptr) {
+            return;
+        }
+        if (phrase != phrase_ || renderer_.getPhraseStart() != phraseStart_) {
+            // New phrase, or the same one looping: notes still sounding end on time
+            phrase_ = phrase;
+            phraseStart_ = renderer_.getPhraseStart();
+            phraseOutput_.setSequence(phrase->notes, phraseStart_);
+        }
+
+        const double samplesToEnd = (static_cast<double>(phraseStart_ + phrase->lengthTicks) - tick) / ticksPerSample;
+        const int segment = std::clamp(static_cast<int>(std::ceil(samplesToEnd)), 1, numSamples - done);
+        const AudioSection outputSection("midi output");
+        addEvents(midiMessages, phraseOutput_.process(segment, tick, ticksPerSample), done);
+        done += segment;
+        tick += segment * ticksPerSample;
+    }
+}
+
+void PluginProcessor::setWound(const Wound& wound) {
+    KELLY_ZONE();
+    // Rule breaks and params are compiled here, off the audio thread; the
+    // generator's triple buffer hands the finished block to processBlock.
+    const IntentResult result = intentProcessor_.processIntent(wound);
+    if (result.emotion != nullptr) {
+        trajectory_.stop();
+        trajectoryActive_ = false;
+        generator_.publishIntent(result.emotion->id, result.musicalParams);
+        requestPhrases(result.emotion->id, result.musicalParams);
+    }
+}
+
+bool PluginProcessor::startTrajectory(int toEmotionId, uint32_t bars) {
+    KELLY_ZONE();
+    // Path lookup and table sampling happen here; the audio thread only reads frames
+    const EmotionModelHandle& model = intentProcessor_.getModel();
+    EmotionTrajectory trajectory;
+    if (!trajectory.build(model->getEngine(), model->getPaths(), generator_.getEmotion(), toEmotionId)) {
+        return false;
+    }
+    trajectoryTable_ = trajectory;
+    trajectoryLengthTicks_ = static_cast<uint64_t>(std::max<uint32_t>(bars, 1)) * 4 * kPhrasePpq;
+    trajectoryActive_ = true;
+    trajectory_.start(trajectoryTable_, trajectoryLengthTicks_);
+    return true;
+}
+
+void PluginProcessor::requestPhrases(int emotionId, const MusicalParams& params) {
+    PhraseRequest request;
+    request.emotionId = emotionId;
+    request.params = params;
+    request.ppq = kPhrasePpq;
+    request.grooveId = grooveFor(renderer_.getGrooves(), params);
+    request.bpm = static_cast<int>(std::lround(120.0 * params.tempoModifier));
+    renderer_.setRequest(request);
+    renderer_.service();
+    phraseEmotion_ = emotionId;
 }
 
 juce::AudioProcessorEditor* PluginProcessor::createEditor() {
@@ -29,11 +203,58 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor() {
 }
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData) {
-    // Save plugin state
+    KELLY_ZONE();
+    PluginState state;
+    // The generator starts on emotion 0, so only a requested phrase says one was set
+    state.emotionId = phraseEmotion_ >= 0 ? generator_.getEmotion() : -1;
+    state.request = renderer_.getRequest();
+    renderer_.snapshot(state.phrase);
+    state.hasTrajectory = trajectoryActive_;
+    if (trajectoryActive_) {
+        state.trajectory = trajectoryTable_;
+        state.trajectoryLengthTicks = trajectoryLengthTicks_;
+        state.trajectoryProgress = std::max(trajectory_.getProgress(), 0.0f);
+    }
+
+    const std::vector<std::byte> bytes = savePluginState(state);
+    destData.replaceAll(bytes.data(), bytes.size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes) {
-    // Restore plugin state
+    KELLY_ZONE();
+    if (data == nullptr || sizeInBytes <= 0) {
+        return;
+    }
+    PluginState state;
+    const std::span<const std::byte> bytes(static_cast<const std::byte*>(data), static_cast<size_t>(sizeInBytes));
+    if (!loadPluginState(bytes, state, renderer_.getGrooves().getTemplateCount())) {
+        return;
+    }
+
+    const EmotionModelHandle& model = intentProcessor_.getModel();
+    if (const CompiledEmotion* compiled = model->getCompiled(state.emotionId)) {
+        generator_.publishIntent(state.emotionId, compiled->musicalParams);
+    }
+
+    // A state saved before any wound or trajectory has no phrases to bring back
+    if (state.restoresPhrases() && model->getCompiled(state.request.emotionId) != nullptr) {
+        if (state.phrase.notes.empty()) {
+            renderer_.setRequest(state.request);
+            renderer_.service();
+        } else {
+            renderer_.restore(state.request, std::move(state.phrase));
+        }
+        phraseEmotion_ = state.request.emotionId;
+    }
+
+    trajectoryActive_ = state.hasTrajectory && state.trajectory.isValid();
+    if (trajectoryActive_) {
+        trajectoryTable_ = state.trajectory;
+        trajectoryLengthTicks_ = state.trajectoryLengthTicks;
+        trajectory_.start(trajectoryTable_, trajectoryLengthTicks_, state.trajectoryProgress);
+    } else {
+        trajectory_.stop();
+    }
 }
 
 } // namespace kelly
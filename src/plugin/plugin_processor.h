@@ -1,13 +1,20 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "core/intent_processor.h"
+#include "core/realtime_generator.h"
+#include "core/chord_tracker.h"
+#include "core/audio_thread_guard.h"
+#include "core/lookahead_renderer.h"
+#include "core/midi_block_renderer.h"
+#include "core/plugin_state.h"
 
 namespace kelly {
 
-class PluginProcessor : public juce::AudioProcessor {
+class PluginProcessor : public juce::AudioProcessor, private juce::Timer {
 public:
     PluginProcessor();
-    ~PluginProcessor() override = default;
+    ~PluginProcessor() override;
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -27,10 +34,61 @@ public:
     const juce::String getProgramName(int) override { return {}; }
     void changeProgramName(int, const juce::String&) override {}
 
+    // Binary PluginState: the emotion, the running trajectory and the cached
+    // phrase are restored as-is, so nothing is re-classified or re-rendered
     void getStateInformation(juce::MemoryBlock&) override;
     void setStateInformation(const void*, int) override;
 
+    // Message thread only (the generator's single producer): classifies the
+    // wound, compiles its rule breaks into MusicalParams and publishes them
+    // to the audio thread without locking. Also requests the phrases the
+    // lookahead renderer prepares from the next phrase boundary on.
+    void setWound(const Wound& wound);
+
+    // Message thread: morphs from the current emotion to toEmotionId over the
+    // given bars along the model's smoothest path, starting at the next
+    // block. The step generator follows it per block, and phrases follow
+    // its nodes from the next phrase boundary. False for an unknown ID.
+    // setWound() cancels it.
+    bool startTrajectory(int toEmotionId, uint32_t bars);
+
+    // Any thread: harmony of the incoming MIDI as of the last processed block
+    ChordSnapshot getInputChord() const { return chordTracker_.snapshot(); }
+
+    // Allocations, locks and deadline overruns seen in processBlock
+    AudioThreadGuard& getAudioGuard() { return audioGuard_; }
+
 private:
+    // Services the lookahead renderer
+    void timerCallback() override;
+
+    // Message thread: points the lookahead renderer at the emotion's phrases
+    void requestPhrases(int emotionId, const MusicalParams& params);
+
+    // Audio thread: plays the lookahead phrases from startTick, splitting
+    // the block at phrase boundaries so each phrase starts on its sample
+    void playPhrases(juce::MidiBuffer& midiMessages, int numSamples, double startTick, double ticksPerSample);
+
+    // Touched only off the audio thread
+    IntentProcessor intentProcessor_;
+    LookaheadRenderer renderer_;
+    int phraseEmotion_ = -1;  // last emotion requested from renderer_
+    // Copy of the last trajectory started on trajectory_, for saving
+    EmotionTrajectory trajectoryTable_;
+    uint64_t trajectoryLengthTicks_ = 0;
+    bool trajectoryActive_ = false;
+
+    // Audio thread state, sized in prepareToPlay
+    RealtimeGenerator generator_{intentProcessor_};
+    ChordTracker chordTracker_;
+    AudioThreadGuard audioGuard_;
+    TrajectoryPlayer trajectory_;
+    MidiBlockRenderer phraseOutput_;
+    const RenderedPhrase* phrase_ = nullptr;  // from renderer_.advance()
+    uint64_t phraseStart_ = 0;
+    bool generatorActive_ = true;  // until the first phrase takes over
+    bool wasPlaying_ = false;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
 
@@ -0,0 +1,234 @@
+// kelly._native: KellyCore exposed to the Python brain.
+//
+// Bulk entry points exchange NumPy structured arrays whose dtypes mirror
+// the C++ structs, so a batch crosses the boundary as one buffer instead of
+// one Python object per element. The GIL is released around the C++ work.
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "core/emotion_model.h"
+#include "core/groove_engine.h"
+#include "core/groove_templates.h"
+#include "core/intent_processor.h"
+#include "core/midi_file.h"
+#include "core/midi_pipeline.h"
+
+namespace py = pybind11;
+
+namespace {
+
+// One row per wound in IntentProcessor.process_wounds
+struct WoundResultRow {
+    int16_t emotion_id;
+    uint8_t mode;  // kelly::MusicalMode
+    uint8_t reserved0;
+    uint32_t flags;  // kelly::MusicalFlag bits
+    float tempo_modifier;
+    float dynamics;
+    uint8_t velocity_min;
+    uint8_t velocity_max;
+    uint8_t reserved1[2];
+    float cluster_probability;
+    float syncopation_level;
+};
+
+using NoteArray = py::array_t<kelly::MidiNote, py::array::c_style | py::array::forcecast>;
+
+std::span<const kelly::MidiNote> noteSpan(const NoteArray& notes) {
+    return {notes.data(), static_cast<size_t>(notes.size())};
+}
+
+NoteArray toNoteArray(std::span<const kelly::MidiNote> notes) {
+    NoteArray out(static_cast<py::ssize_t>(notes.size()));
+    if (!notes.empty()) {
+        std::memcpy(out.mutable_data(), notes.data(), notes.size_bytes());
+    }
+    return out;
+}
+
+WoundResultRow toRow(const kelly::IntentResult& result) {
+    const kelly::MusicalParams& p = result.musicalParams;
+    WoundResultRow row{};
+    row.emotion_id = static_cast<int16_t>(result.emotion ? result.emotion->id : -1);
+    row.mode = static_cast<uint8_t>(p.mode);
+    row.flags = p.flags;
+    row.tempo_modifier = p.tempoModifier;
+    row.dynamics = p.dynamics;
+    row.velocity_min = static_cast<uint8_t>(p.velocityMin);
+    row.velocity_max = static_cast<uint8_t>(p.velocityMax);
+    row.cluster_probability = p.clusterProbability;
+    row.syncopation_level = p.syncopationLevel;
+    return row;
+}
+
+// Held for the module's lifetime: a temporary handle per call would rebuild
+// the shared model each time nothing else holds it
+const kelly::EmotionModel& emotionModel() {
+    static const kelly::EmotionModelHandle model = kelly::EmotionModel::shared();
+    return *model;
+}
+
+struct GrooveLibrary {
+    kelly::GrooveTemplates templates;
+    kelly::GrooveEngine engine;
+};
+
+GrooveLibrary& grooveLibrary() {
+    static GrooveLibrary library;
+    return library;
+}
+
+} // namespace
+
+PYBIND11_MODULE(_native, m) {
+    m.doc() = "Native KellyCore bindings (emotion model, intent processing, groove, MIDI files)";
+
+    PYBIND11_NUMPY_DTYPE(kelly::MidiNote, note, velocity, time, duration);
+    PYBIND11_NUMPY_DTYPE(WoundResultRow, emotion_id, mode, flags, tempo_modifier, dynamics,
+                         velocity_min, velocity_max, cluster_probability, syncopation_level);
+
+    m.attr("NOTE_DTYPE") = py::dtype::of<kelly::MidiNote>();
+    m.attr("WOUND_RESULT_DTYPE") = py::dtype::of<WoundResultRow>();
+    m.attr("EMOTION_COUNT") = kelly::EmotionEngine::kEmotionCount;
+
+    m.def("emotion_names", [] {
+        const kelly::EmotionModel& model = emotionModel();
+        std::vector<std::string> names;
+        names.reserve(kelly::EmotionEngine::kEmotionCount);
+        for (size_t id = 0; id < kelly::EmotionEngine::kEmotionCount; ++id) {
+            names.emplace_back(model.getEngine().getEmotion(static_cast<int>(id))->name);
+        }
+        return names;
+    }, "Node names indexed by native emotion ID");
+
+    m.def("emotion_coordinates", [] {
+        const kelly::EmotionEngine& engine = emotionModel().getEngine();
+        py::array_t<float> out({static_cast<py::ssize_t>(kelly::EmotionEngine::kEmotionCount), py::ssize_t{3}});
+        auto rows = out.mutable_unchecked<2>();
+        for (size_t id = 0; id < kelly::EmotionEngine::kEmotionCount; ++id) {
+            rows(id, 0) = engine.valences()[id];
+            rows(id, 1) = engine.arousals()[id];
+            rows(id, 2) = engine.intensities()[id];
+        }
+        return out;
+    }, "(216, 3) float32 array of valence, arousal, intensity");
+
+    m.def("find_emotion", [](std::string_view name) {
+        const kelly::EmotionNode* node = emotionModel().getEngine().findEmotionByName(name);
+        return node ? node->id : -1;
+    }, py::arg("name"));
+
+    m.def("nearby_emotions", [](int emotionId, float threshold) {
+        const std::span<const uint8_t> ids =
+            emotionModel().getEngine().nearbyEmotionIds(emotionId, threshold);
+        py::array_t<uint8_t> out(static_cast<py::ssize_t>(ids.size()));
+        if (!ids.empty()) {
+            std::memcpy(out.mutable_data(), ids.data(), ids.size());
+        }
+        return out;
+    }, py::arg("emotion_id"), py::arg("threshold") = 0.3f,
+       "uint8 IDs of the emotions closer than threshold, nearest first");
+
+    py::class_<kelly::IntentProcessor>(m, "IntentProcessor")
+        .def(py::init<size_t>(), py::arg("history_depth") = kelly::IntentProcessor::kDefaultHistoryDepth)
+        .def("classify", [](const kelly::IntentProcessor& processor, const std::string& description) {
+            const kelly::EmotionNode* node = processor.classifyWound(kelly::Wound{description, 0.0f, ""});
+            return node ? node->id : -1;
+        }, py::arg("description"))
+        .def("process_wounds", [](kelly::IntentProcessor& processor, const std::vector<std::string>& descriptions,
+                                  py::array_t<float, py::array::c_style | py::array::forcecast> intensities,
+                                  const std::string& source) {
+            if (static_cast<size_t>(intensities.size()) != descriptions.size()) {
+                throw py::value_error("descriptions and intensities must have the same length");
+            }
+
+            std::vector<kelly::Wound> wounds;
+            wounds.reserve(descriptions.size());
+            const float* intensity = intensities.data();
+            for (size_t i = 0; i < descriptions.size(); ++i) {
+                wounds.push_back(kelly::Wound{descriptions[i], intensity[i], source});
+            }
+
+            py::array_t<WoundResultRow> out(static_cast<py::ssize_t>(wounds.size()));
+            WoundResultRow* rows = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                const std::vector<kelly::IntentResult> results = processor.processIntents(wounds);
+                for (size_t i = 0; i < results.size(); ++i) {
+                    rows[i] = toRow(results[i]);
+                }
+            }
+            return out;
+        }, py::arg("descriptions"), py::arg("intensities"), py::arg("source") = "batch",
+           "Batch wound processing; returns a WOUND_RESULT_DTYPE array and records history")
+        .def("clear_history", &kelly::IntentProcessor::clearHistory);
+
+    m.def("write_midi", [](const NoteArray& notes, int bpm, uint16_t ppq, uint8_t channel) {
+        kelly::MidiPipeline pipeline;
+        pipeline.setTempo(bpm);
+        std::span<const uint8_t> bytes;
+        kelly::MidiFileWriter writer;
+        {
+            py::gil_scoped_release release;
+            pipeline.addNotes(noteSpan(notes));  // sorts by start time if needed
+            bytes = writer.write(pipeline, kelly::MidiFileOptions{ppq, channel});
+        }
+        return py::bytes(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }, py::arg("notes"), py::arg("bpm") = 120, py::arg("ppq") = 480, py::arg("channel") = 0,
+       "Standard MIDI File bytes for a NOTE_DTYPE array");
+
+    m.def("read_midi", [](py::buffer data) {
+        const py::buffer_info info = data.request();
+        const std::span<const uint8_t> bytes(static_cast<const uint8_t*>(info.ptr),
+                                             static_cast<size_t>(info.size * info.itemsize));
+        kelly::MidiPipeline pipeline;
+        kelly::MidiFileInfo fileInfo;
+        bool ok = false;
+        {
+            py::gil_scoped_release release;
+            ok = kelly::MidiFileReader::read(bytes, pipeline, &fileInfo);
+        }
+        if (!ok) {
+            throw py::value_error("not a valid Standard MIDI File");
+        }
+        return py::make_tuple(toNoteArray(pipeline.getNotes()), fileInfo.ppq, pipeline.getTempo());
+    }, py::arg("data"), "(notes, ppq, bpm) from Standard MIDI File bytes");
+
+    m.def("groove_templates", [] {
+        const auto keys = grooveLibrary().templates.getTemplateKeys();
+        return std::vector<std::string>(keys.begin(), keys.end());
+    });
+
+    m.def("apply_groove", [](py::array_t<kelly::MidiNote, py::array::c_style> notes, std::string_view groove,
+                             float strength, float velocityAmount, float humanizeMs, uint32_t seed,
+                             int bpm, uint32_t ppq) {
+        if (!notes.writeable()) {
+            throw py::value_error("notes array must be writeable");
+        }
+        GrooveLibrary& library = grooveLibrary();
+        const kelly::GrooveGrid* grid = library.engine.getGrid(library.templates,
+                                                               library.templates.findTemplateId(groove), ppq);
+        if (!grid) {
+            throw py::key_error(std::string(groove));
+        }
+
+        kelly::GrooveSettings settings;
+        settings.strength = strength;
+        settings.velocityAmount = velocityAmount;
+        settings.humanizeMs = humanizeMs;
+        settings.seed = seed;
+
+        std::span<kelly::MidiNote> span(notes.mutable_data(), static_cast<size_t>(notes.size()));
+        py::gil_scoped_release release;
+        grid->apply(span, settings, bpm);
+    }, py::arg("notes"), py::arg("groove") = "straight", py::arg("strength") = 1.0f,
+       py::arg("velocity_amount") = 1.0f, py::arg("humanize_ms") = 0.0f, py::arg("seed") = 1u,
+       py::arg("bpm") = 120, py::arg("ppq") = 480u,
+       "Grooves a NOTE_DTYPE array in place; start-time order is not restored");
+}
@@ -0,0 +1,28 @@
+// Writes the emotion graph image (.kemg) that EmotionGraph::open() maps at startup.
+// Usage: KellyEmotionGraph <output path>
+
+#include "core/emotion_graph.h"
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <output.kemg>\n";
+        return 1;
+    }
+
+    if (!kelly::EmotionGraph::writeImage(argv[1])) {
+        std::cerr << "failed to write " << argv[1] << "\n";
+        return 1;
+    }
+
+    const auto graph = kelly::EmotionGraph::open(argv[1]);
+    if (!graph) {
+        std::cerr << "written image does not validate: " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::cout << "wrote " << graph->getNodeCount() << " nodes, " << graph->getEdgeCount()
+              << " edges, " << graph->bytes().size() << " bytes (version "
+              << kelly::kEmotionGraphVersion << ")\n";
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Linked with src/plugin/allocation_hooks.cpp (KellyAllocationHookTests),
+// so every `new` below goes through the plugin's replacement operators.
+
+#include <catch2/catch_test_macros.hpp>
+#include "core/audio_thread_guard.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+using namespace kelly;
+
+namespace {
+
+struct alignas(64) WideBlock {
+    float samples[16];
+};
+
+// Keeps the compiler from eliding a new/delete pair
+void* volatile sink = nullptr;
+
+} // namespace
+
+TEST_CASE("Allocation hooks count real allocations inside a monitored block", "[audio_guard]") {
+    AudioThreadGuard guard;
+    guard.prepare(48000.0);
+    guard.setDeadlineFraction(1.0f);
+
+    bool aligned = false;
+    bool nothrowServed = false;
+    {
+        // No REQUIREs in here: only the allocations under test may happen
+        const AudioThreadGuard::Block block = guard.monitorBlock(48000);
+        const AudioSection section("generate");
+
+        auto value = std::make_unique<int>(7);
+        sink = value.get();
+
+        auto wide = std::make_unique<WideBlock>();
+        sink = wide.get();
+        aligned = reinterpret_cast<std::uintptr_t>(wide.get()) % alignof(WideBlock) == 0;
+
+        int* values = new (std::nothrow) int[4];
+        sink = values;
+        nothrowServed = values != nullptr;
+        delete[] values;
+
+        WideBlock* wideNothrow = new (std::nothrow) WideBlock;
+        sink = wideNothrow;
+        nothrowServed = nothrowServed && wideNothrow != nullptr;
+        delete wideNothrow;
+    }
+    REQUIRE(aligned);
+    REQUIRE(nothrowServed);
+
+    std::array<AudioViolation, 4> violations{};
+    REQUIRE(guard.drain(violations) == 1);
+    REQUIRE(violations[0].type == AudioViolationType::Allocation);
+    REQUIRE(violations[0].count == 4);
+    REQUIRE(std::strcmp(violations[0].site, "generate") == 0);
+
+    {
+        const AudioThreadGuard::Block block = guard.monitorBlock(48000);
+    }
+    auto outside = std::make_unique<WideBlock>();  // outside a block: ignored
+    sink = outside.get();
+    REQUIRE(guard.drain(violations) == 0);
+}
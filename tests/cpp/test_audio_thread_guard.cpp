@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/audio_thread_guard.h"
+#include "core/emotion_model.h"
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace kelly;
+
+TEST_CASE("SpscRing keeps FIFO order and refuses pushes when full", "[audio_guard]") {
+    SpscRing<int, 4> ring;
+    int value = 0;
+    REQUIRE_FALSE(ring.tryPop(value));
+
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(ring.tryPush(i));
+    }
+    REQUIRE_FALSE(ring.tryPush(4));
+    REQUIRE(ring.sizeApprox() == 4);
+
+    REQUIRE(ring.tryPop(value));
+    REQUIRE(value == 0);
+    REQUIRE(ring.tryPush(4));
+    for (int expected = 1; expected <= 4; ++expected) {
+        REQUIRE(ring.tryPop(value));
+        REQUIRE(value == expected);
+    }
+    REQUIRE(ring.emptyApprox());
+}
+
+TEST_CASE("SpscRing hands values across threads in order", "[audio_guard]") {
+    SpscRing<uint32_t, 64> ring;
+    constexpr uint32_t kCount = 100000;
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < kCount;) {
+            if (ring.tryPush(i)) {
+                ++i;
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t value = 0;
+    bool ordered = true;
+    while (expected < kCount) {
+        if (ring.tryPop(value)) {
+            ordered = ordered && value == expected;
+            ++expected;
+        }
+    }
+    producer.join();
+    REQUIRE(ordered);
+}
+
+TEST_CASE("AudioThreadGuard reports allocations and locks with their section", "[audio_guard]") {
+    AudioThreadGuard guard;
+    guard.prepare(48000.0);
+    guard.setDeadlineFraction(1.0f);
+
+    {
+        const AudioThreadGuard::Block block = guard.monitorBlock(48000);
+    }
+    {
+        const AudioThreadGuard::Block block = guard.monitorBlock(48000);
+        const AudioSection section("generate");
+        AudioThreadScope::noteAllocation();  // what the plugin's operator new hook does
+        AudioThreadScope::noteAllocation();
+        const EmotionModelHandle model = EmotionModel::shared();
+    }
+    REQUIRE_FALSE(AudioThreadScope::isActive());
+    AudioThreadScope::noteAllocation();  // outside a block: ignored
+
+    std::array<AudioViolation, 8> violations{};
+    REQUIRE(guard.drain(violations) == 2);
+    REQUIRE(guard.getBlockCount() == 2);
+
+    REQUIRE(violations[0].type == AudioViolationType::Allocation);
+    REQUIRE(violations[0].count == 2);
+    REQUIRE(violations[0].block == 1);
+    REQUIRE(std::strcmp(violations[0].site, "generate") == 0);
+    REQUIRE(violations[1].type == AudioViolationType::Lock);
+    REQUIRE(violations[1].count == 1);
+    REQUIRE(describeViolation(violations[0]) == "block 1: 2 allocations in generate");
+    REQUIRE(guard.drain(violations) == 0);
+}
+
+TEST_CASE("AudioThreadGuard reports blocks over the deadline fraction", "[audio_guard]") {
+    AudioThreadGuard guard;
+    guard.prepare(48000.0);
+    guard.setDeadlineFraction(0.5f);
+
+    {
+        // 48 samples at 48 kHz: a 1 ms budget
+        const AudioThreadGuard::Block block = guard.monitorBlock(48);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    std::array<AudioViolation, 4> violations{};
+    REQUIRE(guard.drain(violations) == 1);
+    REQUIRE(violations[0].type == AudioViolationType::Deadline);
+    REQUIRE(violations[0].load > 1.0f);
+    REQUIRE(violations[0].site == nullptr);
+
+    guard.setEnabled(false);
+    {
+        const AudioThreadGuard::Block block = guard.monitorBlock(48);
+        AudioThreadScope::noteAllocation();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    REQUIRE(guard.drain(violations) == 0);
+    REQUIRE(guard.getBlockCount() == 2);
+}
+
+TEST_CASE("AudioThreadGuard counts violations dropped by a full ring", "[audio_guard]") {
+    AudioThreadGuard guard;
+    guard.prepare(48000.0);
+    guard.setDeadlineFraction(1.0f);
+
+    for (size_t i = 0; i < AudioThreadGuard::kViolationCapacity + 3; ++i) {
+        const AudioThreadGuard::Block block = guard.monitorBlock(48000);
+        AudioThreadScope::noteAllocation();
+    }
+    REQUIRE(guard.getViolationCount() == AudioThreadGuard::kViolationCapacity + 3);
+    REQUIRE(guard.getDroppedCount() == 3);
+}
@@ -30,3 +30,87 @@ TEST_CASE("ChordDiagnostics checks consonance", "[chord]") {
     bool consonant = diagnostics.isConsonant(chord, 0.5f);
     REQUIRE(consonant == true);
 }
+
+TEST_CASE("ChordDiagnostics recognises inversions and sevenths", "[chord]") {
+    ChordDiagnostics diagnostics;
+
+    std::vector<uint8_t> firstInversion{64, 67, 72};  // C major / E
+    ChordInfo info = diagnostics.analyzeChord(firstInversion);
+    REQUIRE(info.quality == ChordQuality::Major);
+    REQUIRE(info.root == 0);
+    REQUIRE(info.bass == 4);
+    REQUIRE(info.inversion == 1);
+    REQUIRE(diagnostics.chordName(info) == "C major/E");
+    REQUIRE(diagnostics.identifyChord(firstInversion) == "major");
+
+    std::vector<uint8_t> dominant{55, 59, 62, 65};  // G7
+    info = diagnostics.analyzeChord(dominant);
+    REQUIRE(info.quality == ChordQuality::Dominant7);
+    REQUIRE(diagnostics.chordName(info) == "G dominant7");
+
+    std::vector<uint8_t> thirdInversion{65, 67, 71, 74};  // G7 / F
+    info = diagnostics.analyzeChord(thirdInversion);
+    REQUIRE(info.quality == ChordQuality::Dominant7);
+    REQUIRE(info.root == 7);
+    REQUIRE(info.inversion == 3);
+}
+
+TEST_CASE("ChordDiagnostics roots ambiguous sets on the bass", "[chord]") {
+    ChordDiagnostics diagnostics;
+    std::vector<uint8_t> augmented{64, 68, 72};
+    ChordInfo info = diagnostics.analyzeChord(augmented);
+    REQUIRE(info.quality == ChordQuality::Augmented);
+    REQUIRE(info.root == 4);
+
+    std::vector<uint8_t> sus{60, 62, 67};
+    REQUIRE(diagnostics.chordName(diagnostics.analyzeChord(sus)) == "C sus2");
+    std::vector<uint8_t> cluster{60, 61, 62};
+    REQUIRE(diagnostics.identifyChord(cluster) == "unknown");
+}
+
+TEST_CASE("ChordDiagnostics dissonance comes from the interval vector", "[chord]") {
+    ChordDiagnostics diagnostics;
+    Chord major{{60, 64, 67}, "C major"};
+    Chord inverted{{64, 67, 72}, "C major/E"};
+    Chord cluster{{60, 61, 62}, "cluster"};
+
+    REQUIRE(diagnostics.calculateDissonance(major) == diagnostics.calculateDissonance(inverted));
+    REQUIRE(diagnostics.calculateDissonance(cluster) > diagnostics.calculateDissonance(major));
+    REQUIRE(ChordDiagnostics::pitchClassDissonance(0) == 0.0f);
+    REQUIRE(ChordDiagnostics::pitchClassDissonance(ChordDiagnostics::toPitchClassSet(major.notes)) ==
+            diagnostics.calculateDissonance(major));
+    REQUIRE(diagnostics.voicingDissonance(major.notes) > 0.0f);
+}
+
+TEST_CASE("ChordDiagnostics batch analysis matches single-chord analysis", "[chord]") {
+    ChordDiagnostics diagnostics;
+    std::vector<std::vector<uint8_t>> voicings{
+        {60, 64, 67}, {64, 67, 72}, {55, 59, 62, 65}, {60, 61, 62}, {48, 55, 64, 67, 72, 76, 79, 84}, {}, {62}
+    };
+
+    VoicingBuffer buffer(2);
+    for (int repeat = 0; repeat < 20; ++repeat) {
+        for (const auto& v : voicings) {
+            buffer.add(v);
+        }
+    }
+    REQUIRE(buffer.size() == voicings.size() * 20);
+
+    std::vector<float> dissonance(buffer.size());
+    std::vector<ChordId> ids(buffer.size());
+    std::vector<uint8_t> mask(buffer.size());
+    diagnostics.analyzeBatch(buffer, dissonance, ids);
+    diagnostics.consonantMask(buffer, 0.35f, mask);
+
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        const auto& notes = voicings[i % voicings.size()];
+        Chord chord{notes, ""};
+        ChordInfo info = diagnostics.analyzeChord(notes);
+        REQUIRE(dissonance[i] == diagnostics.calculateDissonance(chord));
+        REQUIRE(ids[i] == makeChordId(info.quality, info.root));
+        REQUIRE(mask[i] == (diagnostics.isConsonant(chord, 0.35f) ? 1 : 0));
+    }
+
+    REQUIRE(chordIdQuality(ids[2]) == ChordQuality::Dominant7);
+    REQUIRE(chordIdRoot(ids[2]) == 7);
+}
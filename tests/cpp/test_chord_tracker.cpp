@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/chord_tracker.h"
+#include <vector>
+
+using namespace kelly;
+
+TEST_CASE("ChordTracker follows held notes", "[chord]") {
+    ChordTracker tracker;
+    ChordDiagnostics diagnostics;
+
+    tracker.noteOn(64);
+    tracker.noteOn(67);
+    tracker.noteOn(72);
+    REQUIRE(tracker.getChord().quality == ChordQuality::Major);
+    REQUIRE(tracker.getChord().root == 0);
+    REQUIRE(tracker.getChord().inversion == 1);
+
+    std::vector<uint8_t> held{64, 67, 72};
+    REQUIRE(tracker.getDissonance() == diagnostics.calculateDissonance(Chord{held, ""}));
+
+    tracker.noteOn(60);
+    REQUIRE(tracker.getChord().inversion == 0);
+    tracker.noteOff(60);
+    tracker.noteOff(64);
+    REQUIRE(tracker.getHeldNoteCount() == 2);
+    REQUIRE(tracker.getChord().quality == ChordQuality::Unknown);
+}
+
+TEST_CASE("ChordTracker counts doubled notes and parses raw MIDI", "[chord]") {
+    ChordTracker tracker;
+    const uint8_t on[] = {0x90, 60, 100};
+    const uint8_t onOtherChannel[] = {0x91, 60, 90};
+    const uint8_t offViaVelocity[] = {0x90, 60, 0};
+    const uint8_t off[] = {0x81, 60, 0};
+    const uint8_t allNotesOff[] = {0xB0, 123, 0};
+
+    tracker.handleMidiMessage(on);
+    tracker.handleMidiMessage(onOtherChannel);
+    tracker.handleMidiMessage(offViaVelocity);
+    REQUIRE(tracker.getPitchClasses() == 0x001);
+    tracker.handleMidiMessage(off);
+    REQUIRE(tracker.getPitchClasses() == 0);
+    tracker.noteOff(60);
+    REQUIRE(tracker.getHeldNoteCount() == 0);
+
+    tracker.handleMidiMessage(on);
+    tracker.handleMidiMessage(allNotesOff);
+    REQUIRE(tracker.getHeldNoteCount() == 0);
+}
+
+TEST_CASE("ChordTracker publishes a packed snapshot", "[chord]") {
+    ChordTracker tracker;
+    for (uint8_t note : {55, 59, 62, 65}) {
+        tracker.noteOn(note);
+    }
+    ChordSnapshot snap = tracker.snapshot();
+    REQUIRE(chordIdQuality(snap.chordId) == ChordQuality::Dominant7);
+    REQUIRE(chordIdRoot(snap.chordId) == 7);
+    REQUIRE(snap.bassNote == 55);
+    REQUIRE(snap.pitchClasses == tracker.getPitchClasses());
+    REQUIRE(snap.dissonance - tracker.getDissonance() < 1e-4f);
+    REQUIRE(tracker.getDissonance() - snap.dissonance < 1e-4f);
+}
+
+TEST_CASE("ChordTracker hold counts do not wrap", "[chord]") {
+    ChordTracker tracker;
+    for (int i = 0; i < 300; ++i) {
+        tracker.noteOn(60);  // layered or echoed input doubling one note
+    }
+    REQUIRE(tracker.getHeldNoteCount() == 1);
+    for (int i = 0; i < 300; ++i) {
+        tracker.noteOff(60);
+    }
+    REQUIRE(tracker.getHeldNoteCount() == 0);
+
+    // Past the counter's range the count saturates and the note stays held
+    for (int i = 0; i < 70000; ++i) {
+        tracker.noteOn(64);
+    }
+    tracker.noteOff(64);
+    REQUIRE(tracker.getHeldNoteCount() == 1);
+    REQUIRE(tracker.getPitchClasses() == (1u << 4));
+
+    tracker.reset();
+    REQUIRE(tracker.getHeldNoteCount() == 0);
+}
@@ -1,5 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include "core/emotion_engine.h"
+#include "core/emotion_catalog.h"
+#include <algorithm>
+#include <array>
 
 using namespace kelly;
 
@@ -41,3 +44,84 @@ TEST_CASE("EmotionNode has musical attributes", "[emotion]") {
     REQUIRE(emotion != nullptr);
     REQUIRE(emotion->musicalAttributes.tempoModifier > 0.0f);
 }
+
+TEST_CASE("EmotionEngine stores nodes indexed by ID", "[emotion]") {
+    EmotionEngine engine;
+    for (int id = 0; id < static_cast<int>(engine.getEmotionCount()); ++id) {
+        const EmotionNode* emotion = engine.getEmotion(id);
+        REQUIRE(emotion != nullptr);
+        REQUIRE(emotion->id == id);
+    }
+    REQUIRE(engine.getEmotion(-1) == nullptr);
+    REQUIRE(engine.getEmotion(216) == nullptr);
+}
+
+TEST_CASE("EmotionEngine hot arrays mirror node coordinates", "[emotion]") {
+    EmotionEngine engine;
+    const EmotionNode* emotion = engine.getEmotion(31);
+    REQUIRE(emotion != nullptr);
+    REQUIRE(engine.valences()[31] == emotion->valence);
+    REQUIRE(engine.arousals()[31] == emotion->arousal);
+    REQUIRE(engine.intensities()[31] == emotion->intensity);
+    REQUIRE(engine.categories()[31] == emotion->category);
+    REQUIRE(engine.getEmotion(1)->name == "euphoria_mid");
+}
+
+TEST_CASE("EmotionEngine name lookup covers every node", "[emotion]") {
+    EmotionEngine engine;
+    for (int id = 0; id < static_cast<int>(engine.getEmotionCount()); ++id) {
+        const EmotionNode* emotion = engine.getEmotion(id);
+        REQUIRE(engine.findEmotionByName(emotion->name) == emotion);
+        REQUIRE(emotionIdFromName(emotion->name) == id);
+    }
+    REQUIRE(engine.findEmotionByName("not-an-emotion") == nullptr);
+    REQUIRE(engine.findEmotionByName(std::string("rage_low"))->intensity == 0.3f);
+}
+
+TEST_CASE("Emotion IDs resolve at compile time", "[emotion]") {
+    constexpr int griefId = emotionIdFromName("grief");
+    static_assert(griefId == 27);
+    static_assert(emotionIdFromName("euphoria_mid") == 1);
+    static_assert(emotionIdFromName("_mid") == -1);
+    EmotionEngine engine;
+    REQUIRE(engine.getEmotion(griefId)->name == "grief");
+}
+
+TEST_CASE("EmotionEngine neighbor queries are sorted and consistent", "[emotion]") {
+    EmotionEngine engine;
+    const int grief = emotionIdFromName("grief");
+
+    auto nearby = engine.getNearbyEmotions(grief, 0.5f);
+    auto ids = engine.nearbyEmotionIds(grief, 0.5f);
+    REQUIRE(nearby.size() == ids.size());
+    REQUIRE_FALSE(ids.empty());
+
+    std::array<float, EmotionEngine::kEmotionCount> distSq{};
+    const EmotionNode* source = engine.getEmotion(grief);
+    engine.squaredDistances(source->valence, source->arousal, source->intensity, distSq);
+
+    float previous = 0.0f;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        REQUIRE(ids[i] != grief);
+        REQUIRE(nearby[i]->id == ids[i]);
+        REQUIRE(distSq[ids[i]] < 0.25f);
+        REQUIRE(distSq[ids[i]] >= previous);
+        previous = distSq[ids[i]];
+    }
+    for (int id = 0; id < static_cast<int>(EmotionEngine::kEmotionCount); ++id) {
+        if (id != grief && distSq[id] < 0.25f) {
+            REQUIRE(std::find(ids.begin(), ids.end(), id) != ids.end());
+        }
+    }
+}
+
+TEST_CASE("EmotionEngine k-nearest and point queries", "[emotion]") {
+    EmotionEngine engine;
+    auto nearest = engine.nearestEmotionIds(0, 5);
+    REQUIRE(nearest.size() == 5);
+    REQUIRE(engine.nearestEmotionIds(0, 1000).size() == EmotionEngine::kEmotionCount - 1);
+    REQUIRE(engine.nearestEmotionIds(9999, 5).empty());
+
+    const EmotionNode* rage = engine.findEmotionByName("rage");
+    REQUIRE(engine.nearestEmotion(rage->valence, rage->arousal, rage->intensity) == rage->id);
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/emotion_graph.h"
+#include "core/emotion_thesaurus.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+using namespace kelly;
+
+TEST_CASE("EmotionGraph builtin image matches the engine", "[graph]") {
+    const EmotionGraph& graph = EmotionGraph::builtin();
+    REQUIRE(graph.getNodeCount() == EmotionEngine::kEmotionCount);
+    REQUIRE(&graph == &EmotionGraph::builtin());
+
+    EmotionEngine engine;
+    for (int id = 0; id < static_cast<int>(graph.getNodeCount()); ++id) {
+        REQUIRE(graph.name(id) == engine.getEmotion(id)->name);
+        REQUIRE(graph.findByName(graph.name(id)) == id);
+
+        // Related lists are exactly the engine's neighbours within the same radius
+        const auto related = graph.related(id);
+        const auto nearby = engine.nearbyEmotionIds(id, EmotionGraph::kRelatedDistance);
+        REQUIRE(related.size() == nearby.size());
+        for (size_t i = 0; i < related.size(); ++i) {
+            REQUIRE(related[i] == nearby[i]);
+        }
+    }
+    REQUIRE(graph.findByName("nonexistent") == -1);
+    REQUIRE(graph.getEdgeCount() > 0);
+}
+
+TEST_CASE("EmotionGraph rejects malformed images", "[graph]") {
+    REQUIRE(EmotionGraph::fromImage(EmotionGraph::buildImage()) != nullptr);
+
+    auto badMagic = EmotionGraph::buildImage();
+    badMagic[0] = std::byte{'X'};
+    REQUIRE(EmotionGraph::fromImage(badMagic) == nullptr);
+
+    auto badVersion = EmotionGraph::buildImage();
+    const uint16_t nextVersion = kEmotionGraphVersion + 1;
+    std::memcpy(badVersion.data() + offsetof(EmotionGraphHeader, version), &nextVersion, sizeof(nextVersion));
+    REQUIRE(EmotionGraph::fromImage(badVersion) == nullptr);
+
+    auto truncated = EmotionGraph::buildImage();
+    truncated.resize(truncated.size() / 2);
+    REQUIRE(EmotionGraph::fromImage(truncated) == nullptr);
+
+    REQUIRE(EmotionGraph::fromImage({}) == nullptr);
+    REQUIRE(EmotionGraph::open("/nonexistent/kelly.kemg") == nullptr);
+}
+
+TEST_CASE("EmotionGraph maps a written image", "[graph]") {
+    const auto path = (std::filesystem::temp_directory_path() / "kelly_test_graph.kemg").string();
+    REQUIRE(EmotionGraph::writeImage(path));
+
+    {
+        const auto graph = EmotionGraph::open(path);
+        REQUIRE(graph != nullptr);
+        REQUIRE(graph->isMapped());
+        REQUIRE(graph->getNodeCount() == EmotionEngine::kEmotionCount);
+
+        const auto builtin = EmotionGraph::builtin().bytes();
+        REQUIRE(graph->bytes().size() == builtin.size());
+        REQUIRE(std::memcmp(graph->bytes().data(), builtin.data(), builtin.size()) == 0);
+
+        EmotionEngine engine(*graph);
+        REQUIRE(engine.findEmotionByName("grief")->id == graph->findByName("grief"));
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("EmotionGraph::installed maps the generated image when present", "[graph]") {
+    const EmotionGraph& graph = EmotionGraph::installed();
+    REQUIRE(&graph == &EmotionGraph::installed());
+    REQUIRE(graph.getNodeCount() == EmotionEngine::kEmotionCount);
+
+    const auto builtin = EmotionGraph::builtin().bytes();
+    REQUIRE(graph.bytes().size() == builtin.size());
+    REQUIRE(std::memcmp(graph.bytes().data(), builtin.data(), builtin.size()) == 0);
+
+    // ctest points KELLY_EMOTION_GRAPH at the image generated by the build
+    const std::string path = EmotionGraph::installedPath();
+    if (!path.empty() && std::filesystem::exists(path)) {
+        REQUIRE(graph.isMapped());
+    } else {
+        REQUIRE(&graph == &EmotionGraph::builtin());
+    }
+}
+
+TEST_CASE("EmotionThesaurus exposes graph nodes", "[graph]") {
+    EmotionThesaurus thesaurus;
+    REQUIRE(thesaurus.getNodeCount() == 216);
+    REQUIRE(thesaurus.getNode(-1) == nullptr);
+    REQUIRE(thesaurus.getNode(216) == nullptr);
+
+    const EmotionThesaurusNode* rage = thesaurus.findNode("rage");
+    REQUIRE(rage != nullptr);
+    REQUIRE(rage->category == EmotionCategory::Anger);
+    REQUIRE(thesaurus.getNode(rage->id) == rage);
+    REQUIRE(thesaurus.findNode("rage_low")->intensity < rage->intensity);
+    for (uint16_t related : rage->relatedEmotions) {
+        REQUIRE(related != rage->id);
+        REQUIRE(related < 216);
+    }
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "core/emotion_model.h"
+#include "core/emotion_catalog.h"
+#include "core/emotion_trajectory.h"
+#include "core/realtime_generator.h"
+#include "core/intent_processor.h"
+#include <memory>
+
+using namespace kelly;
+using Catch::Approx;
+
+TEST_CASE("EmotionPathTable finds smooth paths between every pair", "[trajectory]") {
+    EmotionModel model;
+    const EmotionPathTable& paths = model.getPaths();
+    REQUIRE(&paths == &model.getPaths());
+
+    const int grief = emotionIdFromName("grief");
+    const int acceptance = emotionIdFromName("acceptance");
+    REQUIRE(acceptance >= 0);
+
+    const std::vector<int> path = paths.path(grief, acceptance);
+    REQUIRE(path.size() >= 2);
+    REQUIRE(path.front() == grief);
+    REQUIRE(path.back() == acceptance);
+    REQUIRE(paths.nextHop(grief, acceptance) == path[1]);
+    REQUIRE(paths.path(grief, grief) == std::vector<int>{grief});
+    REQUIRE(paths.cost(grief, grief) == 0.0f);
+    REQUIRE(paths.path(-1, grief).empty());
+
+    const EmotionEngine& engine = model.getEngine();
+    for (int from = 0; from < static_cast<int>(EmotionEngine::kEmotionCount); from += 7) {
+        for (int to = 0; to < static_cast<int>(EmotionEngine::kEmotionCount); to += 5) {
+            const std::vector<int> p = paths.path(from, to);
+            REQUIRE(p.back() == to);
+            // Never worse than the direct hop, and the cost is the sum of its hops
+            const EmotionNode& a = *engine.getEmotion(from);
+            const EmotionNode& b = *engine.getEmotion(to);
+            const float direct = from == to ? 0.0f
+                : (a.valence - b.valence) * (a.valence - b.valence) + (a.arousal - b.arousal) * (a.arousal - b.arousal) +
+                  (a.intensity - b.intensity) * (a.intensity - b.intensity) + EmotionPathTable::kHopPenalty;
+            REQUIRE(paths.cost(from, to) <= direct + 1e-5f);
+            float sum = 0.0f;
+            for (size_t i = 1; i < p.size(); ++i) {
+                sum += paths.cost(p[i - 1], p[i]);
+            }
+            REQUIRE(sum == Approx(paths.cost(from, to)).margin(1e-4));
+        }
+    }
+}
+
+TEST_CASE("EmotionTrajectory interpolates attributes along the path", "[trajectory]") {
+    EmotionModel model;
+    const EmotionEngine& engine = model.getEngine();
+    const int from = emotionIdFromName("grief");
+    const int to = emotionIdFromName("euphoria");
+
+    EmotionTrajectory trajectory;
+    REQUIRE_FALSE(trajectory.build(engine, model.getPaths(), from, 999));
+    REQUIRE_FALSE(trajectory.isValid());
+    REQUIRE(trajectory.build(engine, model.getPaths(), from, to));
+
+    const MusicalAttributes& start = engine.getEmotion(from)->musicalAttributes;
+    const MusicalAttributes& end = engine.getEmotion(to)->musicalAttributes;
+    const MorphFrame first = trajectory.frameAt(0.0f);
+    const MorphFrame last = trajectory.frameAt(1.0f);
+    REQUIRE(first.emotionId == from);
+    REQUIRE(first.tempoModifier == Approx(start.tempoModifier));
+    REQUIRE(first.dynamics == Approx(start.dynamics));
+    REQUIRE(first.mode() == MusicalMode::Minor);
+    REQUIRE(last.emotionId == to);
+    REQUIRE(last.tempoModifier == Approx(end.tempoModifier));
+    REQUIRE(last.mode() == MusicalMode::Major);
+    REQUIRE(trajectory.frameAt(-3.0f).tempoModifier == first.tempoModifier);
+
+    // Continuous: no jump between neighbouring points
+    for (int i = 1; i <= 1000; ++i) {
+        const MorphFrame a = trajectory.frameAt((i - 1) / 1000.0f);
+        const MorphFrame b = trajectory.frameAt(i / 1000.0f);
+        REQUIRE(std::abs(a.dynamics - b.dynamics) < 0.05f);
+        REQUIRE(std::abs(a.majorWeight - b.majorWeight) < 0.05f);
+    }
+}
+
+TEST_CASE("TrajectoryPlayer anchors at the playhead and holds the end", "[trajectory]") {
+    EmotionModel model;
+    EmotionTrajectory trajectory;
+    REQUIRE(trajectory.build(model.getEngine(), model.getPaths(), emotionIdFromName("grief"),
+                             emotionIdFromName("acceptance")));
+
+    auto player = std::make_unique<TrajectoryPlayer>();
+    REQUIRE(player->advance(0) == nullptr);
+    REQUIRE(player->getCurrentEmotion() == -1);
+
+    player->start(trajectory, 1000);
+    REQUIRE(player->getCurrentEmotion() == -1);  // not picked up yet
+    const MorphFrame* frame = player->advance(5000);
+    REQUIRE(frame != nullptr);
+    REQUIRE(frame->emotionId == emotionIdFromName("grief"));
+    REQUIRE(player->getProgress() == 0.0f);
+
+    frame = player->advance(5500);
+    REQUIRE(player->getProgress() == Approx(0.5f));
+    REQUIRE(frame->dynamics == Approx(trajectory.frameAt(0.5f).dynamics));
+
+    frame = player->advance(9000);
+    REQUIRE(player->getProgress() == 1.0f);
+    REQUIRE(player->getCurrentEmotion() == emotionIdFromName("acceptance"));
+
+    player->stop();
+    REQUIRE(player->getCurrentEmotion() == -1);
+    REQUIRE(player->advance(9100) == nullptr);
+    REQUIRE(player->getProgress() == -1.0f);
+
+    // Resuming part way through anchors the remainder at the playhead
+    player->start(trajectory, 1000, 0.25f);
+    player->advance(20000);
+    REQUIRE(player->getProgress() == Approx(0.25f));
+    player->advance(20500);
+    REQUIRE(player->getProgress() == Approx(0.75f));
+}
+
+TEST_CASE("RealtimeGenerator follows a morph frame", "[trajectory]") {
+    IntentProcessor processor;
+    RealtimeGenerator generator(processor);
+    generator.prepare(48000.0, 512);
+    generator.setEmotion(emotionIdFromName("rage"));
+
+    auto countNotes = [&](int blocks) {
+        int notes = 0;
+        for (int i = 0; i < blocks; ++i) {
+            for (const auto& e : generator.process(512, 120.0)) {
+                notes += e.velocity > 0 ? 1 : 0;
+            }
+        }
+        return notes;
+    };
+
+    MorphFrame slow;
+    slow.tempoModifier = RealtimeGenerator::kMinTempoModifier;
+    generator.setMorph(&slow);
+    const int slowNotes = countNotes(200);
+    generator.setMorph(nullptr);
+    const int normalNotes = countNotes(200);
+    REQUIRE(slowNotes * 2 < normalNotes);
+}
@@ -0,0 +1,179 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/groove_engine.h"
+#include <string>
+#include <vector>
+
+using namespace kelly;
+
+namespace {
+
+GrooveTemplate straightQuarters() {
+    return GrooveTemplate{"Quarters", 4, 4, {{0.0f, 100}, {0.25f, 50}, {0.5f, 100}, {0.75f, 50}}, 0.0f};
+}
+
+} // namespace
+
+TEST_CASE("GrooveGrid places pattern slots in ticks", "[groove]") {
+    GrooveGrid grid(straightQuarters(), 480);
+    REQUIRE(grid.getTicksPerBar() == 1920);
+    REQUIRE(std::vector<uint32_t>(grid.getSlotTicks().begin(), grid.getSlotTicks().end())
+            == std::vector<uint32_t>{0, 480, 960, 1440});
+
+    GrooveGrid waltz(GrooveTemplate{"Waltz", 3, 4, {{0.0f, 100}}, 0.0f}, 96);
+    REQUIRE(waltz.getTicksPerBar() == 288);
+}
+
+TEST_CASE("GrooveGrid swing moves off-beat eighths", "[groove]") {
+    GrooveTemplate eighths{"Eighths", 4, 4, {{0.0f, 100}, {0.125f, 80}}, 0.0f};
+    REQUIRE(GrooveGrid(eighths, 480).getSlotTicks()[1] == 240);
+
+    eighths.swing = 0.66f;
+    GrooveGrid swung(eighths, 480);
+    REQUIRE(swung.getSlotTicks()[0] == 0);
+    REQUIRE(swung.getSlotTicks()[1] == 317);
+}
+
+TEST_CASE("GrooveGrid quantizes and shapes velocity", "[groove]") {
+    GrooveGrid grid(straightQuarters(), 480);
+    std::vector<MidiNote> notes{
+        {60, 100, 10, 100},    // early in beat 1
+        {62, 100, 500, 100},   // just after beat 2 (weak slot)
+        {64, 100, 1900, 100},  // wraps to the next downbeat
+        {65, 100, 1920 + 950, 100},
+    };
+
+    grid.apply(notes);
+    REQUIRE(notes[0].time == 0);
+    REQUIRE(notes[0].velocity == 100);
+    REQUIRE(notes[1].time == 480);
+    REQUIRE(notes[1].velocity == 50);
+    REQUIRE(notes[2].time == 1920);
+    REQUIRE(notes[3].time == 1920 + 960);
+}
+
+TEST_CASE("GrooveGrid strength and velocity amount blend", "[groove]") {
+    GrooveGrid grid(straightQuarters(), 480);
+    std::vector<MidiNote> notes{{60, 100, 500, 100}};
+
+    GrooveSettings settings;
+    settings.strength = 0.5f;
+    settings.velocityAmount = 0.0f;
+    grid.apply(notes, settings);
+    REQUIRE(notes[0].time == 490);
+    REQUIRE(notes[0].velocity == 100);
+}
+
+TEST_CASE("GrooveGrid humanize is bounded and seeded", "[groove]") {
+    GrooveGrid grid(straightQuarters(), 480);
+    GrooveSettings settings;
+    settings.strength = 0.0f;
+    settings.velocityAmount = 0.0f;
+    settings.humanizeMs = 10.0f;  // 9.6 -> 10 ticks at 120 bpm
+    settings.humanizeVelocity = 5;
+
+    std::vector<MidiNote> a(64, MidiNote{60, 100, 960, 100});
+    std::vector<MidiNote> b = a;
+    grid.apply(a, settings);
+    grid.apply(b, settings);
+
+    bool moved = false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        REQUIRE(a[i].time == b[i].time);
+        REQUIRE(a[i].time >= 950);
+        REQUIRE(a[i].time <= 970);
+        REQUIRE(a[i].velocity >= 95);
+        REQUIRE(a[i].velocity <= 105);
+        moved = moved || a[i].time != 960;
+    }
+    REQUIRE(moved);
+}
+
+TEST_CASE("GrooveEngine caches grids and keeps pipeline order", "[groove]") {
+    GrooveTemplates templates;
+    const int straight = templates.findTemplateId("straight");
+    REQUIRE(straight >= 0);
+
+    GrooveEngine engine;
+    REQUIRE(engine.getGrid(templates, straight) != nullptr);
+    REQUIRE(engine.getGrid(templates, straight) == engine.getGrid(templates, straight));
+    REQUIRE(engine.getGrid(templates, straight, 960) != engine.getGrid(templates, straight));
+    REQUIRE(engine.getGrid(templates, 99) == nullptr);
+
+    MidiPipeline pipeline;
+    pipeline.addNote(MidiNote{60, 100, 470, 100});
+    pipeline.addNote(MidiNote{62, 100, 475, 100});
+    pipeline.addNote(MidiNote{64, 100, 485, 100});
+    REQUIRE(engine.apply(pipeline, templates, straight));
+
+    const auto& notes = pipeline.getNotes();
+    REQUIRE(notes.size() == 3);
+    for (const MidiNote& note : notes) {
+        REQUIRE(note.time == 480);
+    }
+    REQUIRE(notes[0].note == 60);
+    REQUIRE(notes[2].note == 64);
+}
+
+TEST_CASE("GrooveEngine rebuilds the grid of a replaced template", "[groove]") {
+    GrooveTemplates templates;
+    const int id = templates.addTemplate("user", straightQuarters());
+    const uint64_t revision = templates.getRevision(id);
+
+    GrooveEngine engine;
+    REQUIRE(engine.getGrid(templates, id)->getSlotTicks().size() == 4);
+
+    // Same key, same ID and same address, new contents
+    REQUIRE(templates.addTemplate("user", GrooveTemplate{"Halves", 4, 4, {{0.0f, 100}, {0.5f, 100}}, 0.0f}) == id);
+    REQUIRE(templates.getRevision(id) != revision);
+    REQUIRE(std::vector<uint32_t>(engine.getGrid(templates, id)->getSlotTicks().begin(),
+                                  engine.getGrid(templates, id)->getSlotTicks().end())
+            == std::vector<uint32_t>{0, 960});
+
+    // Another library's template under the same ID gets its own grid
+    GrooveTemplates other;
+    const int otherId = other.addTemplate("user", straightQuarters());
+    REQUIRE(otherId == id);
+    REQUIRE(engine.getGrid(other, otherId)->getSlotTicks().size() == 4);
+}
+
+TEST_CASE("The built-in swing template is swung once", "[groove]") {
+    GrooveTemplates templates;
+    GrooveGrid swing(*templates.getTemplate("swing"), 480);
+    // 0.33 and 0.83 of a 1920-tick bar, as in the Python groove
+    REQUIRE(std::vector<uint32_t>(swing.getSlotTicks().begin(), swing.getSlotTicks().end())
+            == std::vector<uint32_t>{0, 634, 960, 1594});
+}
+
+TEST_CASE("GrooveTemplates resolves keys to stable IDs", "[groove]") {
+    GrooveTemplates templates;
+    REQUIRE(templates.getTemplateCount() == 3);
+
+    const int swing = templates.findTemplateId(std::string_view("swing"));
+    REQUIRE(swing >= 0);
+    REQUIRE(templates.getTemplate(swing) == templates.getTemplate("swing"));
+    REQUIRE(templates.getTemplate(swing)->name == "Swing");
+    REQUIRE(templates.getTemplateKey(swing) == "swing");
+    REQUIRE(templates.findTemplateId("missing") == -1);
+    REQUIRE(templates.getTemplate(99) == nullptr);
+
+    const GrooveTemplate* before = templates.getTemplate(swing);
+    for (int i = 0; i < 300; ++i) {
+        templates.addTemplate("user_" + std::to_string(i), GrooveTemplate{"User", 4, 4, {{0.0f, 100}}, 0.0f});
+    }
+    REQUIRE(templates.getTemplate(swing) == before);
+    REQUIRE(templates.findTemplateId("user_299") == 302);
+
+    REQUIRE(templates.addTemplate("swing", GrooveTemplate{"Shuffle", 12, 8, {{0.0f, 100}}, 0.0f}) == swing);
+    REQUIRE(templates.getTemplate(swing)->name == "Shuffle");
+    REQUIRE(templates.getTemplateCount() == 303);
+}
+
+TEST_CASE("GrooveTemplates lists keys in sorted order", "[groove]") {
+    GrooveTemplates templates;
+    templates.addTemplate("ballad", GrooveTemplate{"Ballad", 4, 4, {{0.0f, 100}}, 0.0f});
+
+    const auto keys = templates.getTemplateKeys();
+    REQUIRE(std::vector<std::string_view>(keys.begin(), keys.end())
+            == std::vector<std::string_view>{"ballad", "straight", "swing", "syncopated"});
+    REQUIRE(templates.getTemplateNames().front() == "ballad");
+}
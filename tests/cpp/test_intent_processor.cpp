@@ -0,0 +1,233 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "core/intent_processor.h"
+#include <memory>
+#include <string>
+
+using namespace kelly;
+using Catch::Approx;
+
+TEST_CASE("IntentProcessor maps wounds to emotions", "[intent]") {
+    IntentProcessor processor;
+    const EmotionNode* emotion = processor.processWound(Wound{"A deep LOSS", 0.9f, "internal"});
+    REQUIRE(emotion != nullptr);
+    REQUIRE(emotion->name == "grief");
+
+    emotion = processor.processWound(Wound{"nothing specific", 0.2f, "external"});
+    REQUIRE(emotion != nullptr);
+    REQUIRE(emotion->name == "melancholy");
+}
+
+TEST_CASE("IntentProcessor compiles typed musical params", "[intent]") {
+    IntentProcessor processor;
+    IntentResult result = processor.processIntent(Wound{"blind rage", 1.0f, "external"});
+    REQUIRE(result.emotion != nullptr);
+    REQUIRE(result.ruleBreaks.size() == 3);
+
+    const MusicalParams& params = result.musicalParams;
+    REQUIRE(params.tempoModifier == result.emotion->musicalAttributes.tempoModifier);
+    REQUIRE(params.mode == MusicalMode::Minor);
+    REQUIRE(params.velocityMin == 10);
+    REQUIRE(params.velocityMax == 127);
+    REQUIRE(params.clusterProbability == -result.emotion->valence);
+    REQUIRE(params.syncopationLevel == result.emotion->arousal);
+    REQUIRE(params.hasFlag(MusicalFlag::SuddenChanges));
+    REQUIRE(params.hasFlag(MusicalFlag::AllowDissonance));
+    REQUIRE(params.hasFlag(MusicalFlag::IrregularMeters));
+    REQUIRE(params.get(MusicalParamId::SyncopationLevel) == params.syncopationLevel);
+    REQUIRE(result.extensionParams.empty());
+}
+
+TEST_CASE("IntentProcessor shares compiled rule breaks per node", "[intent]") {
+    IntentProcessor first;
+    IntentProcessor second(IntentProcessor::kDefaultHistoryDepth, first.getModel());
+
+    const IntentResult a = first.processIntent(Wound{"blind rage", 1.0f, "external"});
+    const IntentResult b = second.processIntent(Wound{"so much rage", 0.5f, "internal"});
+    REQUIRE(a.emotion == b.emotion);
+    REQUIRE(a.ruleBreaks.data() == b.ruleBreaks.data());
+    REQUIRE(a.ruleBreaks.data() == first.getCompiled(*a.emotion)->ruleBreaks.data());
+    REQUIRE(first.getModel()->getCompiled(-1) == nullptr);
+
+    // Same result as compiling from scratch
+    const CompiledEmotion fresh = compileEmotion(*a.emotion);
+    REQUIRE(fresh.ruleBreaks.size() == a.ruleBreaks.size());
+    for (size_t i = 0; i < fresh.ruleBreaks.size(); ++i) {
+        REQUIRE(fresh.ruleBreaks[i].description == a.ruleBreaks[i].description);
+        REQUIRE(fresh.ruleBreaks[i].severity == a.ruleBreaks[i].severity);
+    }
+    REQUIRE(fresh.musicalParams.velocityMin == a.musicalParams.velocityMin);
+    REQUIRE(fresh.musicalParams.flags == a.musicalParams.flags);
+
+    // Nodes from elsewhere are compiled per call rather than cached
+    EmotionNode copy = *a.emotion;
+    copy.arousal = 0.0f;
+    REQUIRE(first.getCompiled(copy) == nullptr);
+    REQUIRE(first.deriveRuleBreaks(copy).size() == 2);
+}
+
+TEST_CASE("MusicalImpact only overrides the params it sets", "[intent]") {
+    MusicalParams params;
+    MusicalImpact impact;
+    impact.set(MusicalParamId::Dynamics, 0.9f).raise(MusicalFlag::AllowDissonance);
+    impact.applyTo(params);
+
+    REQUIRE(params.dynamics == 0.9f);
+    REQUIRE(params.tempoModifier == 1.0f);
+    REQUIRE(params.velocityMax == 110);
+    REQUIRE(params.hasFlag(MusicalFlag::AllowDissonance));
+    REQUIRE_FALSE(params.hasFlag(MusicalFlag::SuddenChanges));
+}
+
+TEST_CASE("IntentProcessor batch matches sequential processing", "[intent]") {
+    const char* descriptions[] = {"loss of a friend", "road rage", "fear of heights", "a quiet evening"};
+    std::vector<Wound> wounds;
+    for (int i = 0; i < 1000; ++i) {
+        wounds.push_back(Wound{descriptions[i % 4], 0.5f, "internal"});
+    }
+
+    IntentProcessor batchProcessor;
+    IntentProcessor serialProcessor;
+    std::vector<IntentResult> batch = batchProcessor.processIntents(wounds);
+    REQUIRE(batch.size() == wounds.size());
+
+    for (size_t i = 0; i < wounds.size(); ++i) {
+        IntentResult expected = serialProcessor.processIntent(wounds[i]);
+        REQUIRE(batch[i].wound.description == wounds[i].description);
+        REQUIRE(batch[i].emotion->id == expected.emotion->id);
+        REQUIRE(batch[i].ruleBreaks.size() == expected.ruleBreaks.size());
+        REQUIRE(batch[i].musicalParams.flags == expected.musicalParams.flags);
+    }
+
+    REQUIRE(batchProcessor.processIntents({}).empty());
+}
+
+TEST_CASE("IntentProcessor history is bounded", "[intent]") {
+    IntentProcessor processor(4);
+    for (int i = 0; i < 10; ++i) {
+        processor.processIntent(Wound{i % 2 ? "rage" : "grief", 1.0f, std::to_string(i)});
+    }
+
+    const auto& history = processor.getHistory();
+    REQUIRE(history.size() == 4);
+    REQUIRE(history.capacity() == 4);
+    REQUIRE(history.front().wound.source == "6");
+    REQUIRE(history.back().wound.source == "9");
+    REQUIRE(processor.getRuleBreakHistory().size() <= 12);
+    REQUIRE(processor.getSummary().totalWounds == 10);
+}
+
+TEST_CASE("IntentProcessor summary tracks the retained window", "[intent]") {
+    IntentProcessor processor(2);
+    const EmotionEngine& engine = processor.getEngine();
+    const EmotionNode* rage = engine.findEmotionByName("rage");
+    const EmotionNode* melancholy = engine.findEmotionByName("melancholy");
+
+    processor.processIntent(Wound{"grief", 1.0f, ""});
+    processor.processIntent(Wound{"rage", 1.0f, ""});
+    processor.processIntent(Wound{"calm", 1.0f, ""});
+
+    const IntentSummary& summary = processor.getSummary();
+    REQUIRE(summary.meanValence == Approx((rage->valence + melancholy->valence) / 2.0f));
+    REQUIRE(summary.meanArousal == Approx((rage->arousal + melancholy->arousal) / 2.0f));
+
+    size_t dynamics = 0;
+    for (const RuleBreak& rb : processor.getRuleBreakHistory()) {
+        dynamics += rb.type == RuleBreakType::Dynamics;
+    }
+    REQUIRE(summary.ruleBreakCounts[static_cast<size_t>(RuleBreakType::Dynamics)] == dynamics);
+
+    processor.clearHistory();
+    REQUIRE(processor.getHistory().empty());
+    REQUIRE(processor.getSummary().totalWounds == 0);
+}
+
+TEST_CASE("RingBuffer overwrites oldest entries", "[intent]") {
+    RingBuffer<int> buffer(3);
+    for (int i = 1; i <= 5; ++i) {
+        buffer.push(i);
+    }
+    REQUIRE(buffer.full());
+    std::vector<int> values(buffer.begin(), buffer.end());
+    REQUIRE(values == std::vector<int>{3, 4, 5});
+}
+
+TEST_CASE("KeywordMatcher finds overlapping keywords at word starts", "[intent]") {
+    KeywordMatcher matcher;
+    matcher.addKeyword("he", 1);
+    matcher.addKeyword("she", 2);
+    matcher.addKeyword("hers", 3, 2.0f);
+    matcher.addKeyword("rage", 4);
+    matcher.build();
+
+    std::vector<KeywordMatch> matches;
+    matcher.forEachMatch("SHE said hers, with courage and RAGE", [&](const KeywordMatch& m) {
+        matches.push_back(m);
+    });
+
+    REQUIRE(matches.size() == 4);
+    REQUIRE(matches[0].emotionId == 2);
+    REQUIRE(matches[1].emotionId == 1);
+    REQUIRE(matches[1].begin == 9);
+    REQUIRE(matches[2].emotionId == 3);
+    REQUIRE(matches[2].weight == 2.0f);
+    REQUIRE(matches[3].emotionId == 4);
+    REQUIRE(matches[3].begin == 32);
+}
+
+TEST_CASE("KeywordMatcher whole-word keywords end at a separator", "[intent]") {
+    KeywordMatcher matcher;
+    matcher.addKeyword("hope", 1, 1.0f, true);
+    matcher.addKeyword("fear", 2);
+    matcher.build();
+
+    std::vector<int> found;
+    matcher.forEachMatch("hope, hopes, hopeless, fearful, FEARLESS, fear", [&](const KeywordMatch& m) {
+        found.push_back(m.emotionId);
+    });
+    REQUIRE(found == std::vector<int>{1, 2, 2});
+}
+
+TEST_CASE("IntentProcessor classifies wounds with the full vocabulary", "[intent]") {
+    IntentProcessor processor;
+    REQUIRE(processor.classifyWound(Wound{"Overwhelming NOSTALGIA", 0.5f, ""})->name == "nostalgia");
+    REQUIRE(processor.classifyWound(Wound{"fearful and anxious", 0.5f, ""})->name == "anxiety");
+    REQUIRE(processor.classifyWound(Wound{"it took courage", 0.5f, ""})->name == "melancholy");
+    REQUIRE(processor.classifyWound(Wound{"anger, then fear", 0.5f, ""})->name == "rage");
+    REQUIRE(processor.classifyWound(Wound{"fear, fear and anger", 0.5f, ""})->name == "anxiety");
+
+    // Negated words must not classify as the emotion they negate
+    REQUIRE(processor.classifyWound(Wound{"I feel hopeless", 0.5f, ""})->name != "hope");
+    REQUIRE(processor.classifyWound(Wound{"I feel hopeless", 0.5f, ""})->name == "melancholy");
+    REQUIRE(processor.classifyWound(Wound{"fearless", 0.5f, ""})->name != "anxiety");
+    REQUIRE(processor.classifyWound(Wound{"joyless and loveless", 0.5f, ""})->name == "melancholy");
+    REQUIRE(processor.classifyWound(Wound{"so hopeful", 0.5f, ""})->name == "hope");
+
+    auto scores = processor.scoreCategories("grief and terror and panic");
+    REQUIRE(scores[static_cast<size_t>(EmotionCategory::Sadness)] == 1.0f);
+    REQUIRE(scores[static_cast<size_t>(EmotionCategory::Fear)] == 2.0f);
+}
+
+TEST_CASE("IntentProcessors share one emotion model", "[intent]") {
+    IntentProcessor first;
+    IntentProcessor second;
+    REQUIRE(first.getModel() == second.getModel());
+    REQUIRE(&first.getEngine() == &second.getEngine());
+    REQUIRE(first.getModel() == EmotionModel::shared());
+
+    auto custom = std::make_shared<const EmotionModel>();
+    IntentProcessor isolated(16, custom);
+    REQUIRE(&isolated.getEngine() == &custom->getEngine());
+    REQUIRE(isolated.processWound(Wound{"rage", 1.0f, "test"})
+            == custom->getEngine().findEmotionByName("rage"));
+}
+
+TEST_CASE("Shared emotion model is released with its last handle", "[intent]") {
+    std::weak_ptr<const EmotionModel> weak;
+    {
+        IntentProcessor processor;
+        weak = processor.getModel();
+        REQUIRE(!weak.expired());
+    }
+    REQUIRE(weak.expired());
+}
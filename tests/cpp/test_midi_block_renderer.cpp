@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "core/midi_block_renderer.h"
+#include <vector>
+
+using namespace kelly;
+
+namespace {
+
+struct TimedEvent {
+    int64_t sample;
+    uint8_t note;
+    uint8_t velocity;
+};
+
+// Runs the renderer free against the pipeline's tempo map, collecting absolute sample times
+std::vector<TimedEvent> renderFree(MidiBlockRenderer& renderer, const MidiPipeline& pipeline,
+                                   int blockSize, int blocks) {
+    std::vector<TimedEvent> out;
+    for (int block = 0; block < blocks; ++block) {
+        for (const auto& e : renderer.process(blockSize, pipeline.getTempoMap(), 480)) {
+            out.push_back({int64_t{block} * blockSize + e.sampleOffset, e.note, e.velocity});
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("TempoMap converts ticks and seconds across changes", "[midi_render]") {
+    TempoMap tempo(120);
+    REQUIRE(tempo.tickToSeconds(480, 480) == Catch::Approx(0.5));
+
+    tempo.setTempoAt(960, 60);
+    REQUIRE(tempo.getTempo() == 120);
+    REQUIRE(tempo.getTempoAt(959) == 120);
+    REQUIRE(tempo.getTempoAt(960) == 60);
+    REQUIRE(tempo.tickToSeconds(960, 480) == Catch::Approx(1.0));
+    REQUIRE(tempo.tickToSeconds(1440, 480) == Catch::Approx(2.0));
+    REQUIRE(tempo.secondsToTick(2.0, 480) == Catch::Approx(1440.0));
+    REQUIRE(tempo.secondsToTick(0.25, 480) == Catch::Approx(240.0));
+
+    tempo.setTempoAt(960, 240);  // replaces, does not duplicate
+    REQUIRE(tempo.getChanges().size() == 2);
+    REQUIRE(tempo.secondsToTick(tempo.tickToSeconds(1500.0, 480), 480) == Catch::Approx(1500.0));
+
+    tempo.setTempo(0);
+    REQUIRE(tempo.getChanges().size() == 1);
+    REQUIRE(tempo.getTempo() == TempoMap::kMinBpm);
+}
+
+TEST_CASE("MidiBlockRenderer places events on exact samples across blocks", "[midi_render]") {
+    MidiPipeline pipeline;  // 120 bpm: one tick = 50 samples at 48 kHz
+    pipeline.addNote({60, 100, 0, 480});
+    pipeline.addNote({64, 90, 480, 240});
+    pipeline.addNote({67, 0, 500, 10});
+
+    MidiBlockRenderer renderer;
+    renderer.prepare(48000.0, 128);
+    renderer.setSequence(pipeline);
+    const auto events = renderFree(renderer, pipeline, 128, 400);
+
+    REQUIRE(events.size() == 6);
+    REQUIRE(events[0].sample == 0);
+    REQUIRE(events[0].note == 60);
+    // 60 ends exactly where 64 starts: the off comes first
+    REQUIRE(events[1].sample == 24000);
+    REQUIRE(events[1].velocity == 0);
+    REQUIRE(events[2].sample == 24000);
+    REQUIRE(events[2].note == 64);
+    REQUIRE(events[3].sample == 25000);
+    REQUIRE(events[3].velocity == 1);  // zero velocity would read as a note-off
+    REQUIRE(events[4].sample == 25500);
+    REQUIRE(events[5].sample == 36000);
+    REQUIRE(renderer.getActiveNoteCount() == 0);
+}
+
+TEST_CASE("MidiBlockRenderer keeps sounding notes when the tempo changes", "[midi_render]") {
+    MidiPipeline pipeline;
+    pipeline.addNote({60, 100, 0, 960});
+    pipeline.addNote({62, 100, 960, 480});
+
+    MidiBlockRenderer renderer;
+    renderer.prepare(48000.0, 100);
+    renderer.setSequence(pipeline);
+
+    // Half a beat at 120, then halve the tempo for the rest
+    std::vector<TimedEvent> events = renderFree(renderer, pipeline, 100, 120);
+    REQUIRE(renderer.getPosition() == Catch::Approx(240.0));
+    pipeline.setTempo(60);
+    for (int block = 120; block < 1400; ++block) {
+        for (const auto& e : renderer.process(100, pipeline.getTempoMap(), 480)) {
+            events.push_back({int64_t{block} * 100 + e.sampleOffset, e.note, e.velocity});
+        }
+    }
+
+    // Tick 960 is 720 ticks after the change at 100 samples per tick
+    REQUIRE(events.size() == 4);
+    REQUIRE(events[1].sample == 12000 + 72000);
+    REQUIRE(events[2].note == 62);
+    REQUIRE(events[3].sample == 84000 + 48000);
+}
+
+TEST_CASE("MidiBlockRenderer follows a tempo map change inside a block", "[midi_render]") {
+    MidiPipeline pipeline;
+    pipeline.setTempoAt(480, 60);
+    pipeline.addNote({60, 100, 700, 10});
+
+    MidiBlockRenderer renderer;
+    renderer.prepare(48000.0, 48000);
+    renderer.setSequence(pipeline);
+    const auto events = renderer.process(48000, pipeline.getTempoMap(), 480);
+    REQUIRE(events.size() == 2);
+    // 0.5 s to the change, then 220 ticks at 100 samples per tick
+    REQUIRE(events[0].sampleOffset == 24000 + 22000);
+    REQUIRE(events[1].sampleOffset == 47000);
+}
+
+TEST_CASE("MidiBlockRenderer follows the host and treats jumps as seeks", "[midi_render]") {
+    const std::vector<MidiNote> notes = {{60, 100, 0, 100}, {62, 100, 960, 2000}, {64, 100, 1920, 100}};
+    MidiBlockRenderer renderer;
+    renderer.prepare(48000.0, 1024);
+
+    const double ticksPerSample = 120.0 / 60.0 * 480.0 / 48000.0;
+    renderer.setSequence(notes, 1000);  // phrase starts at absolute tick 1000
+    auto events = renderer.process(1024, 990.0, ticksPerSample);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].note == 60);
+    REQUIRE(events[0].sampleOffset == 500);
+
+    double tick = 990.0 + 1024 * ticksPerSample;
+    int noteOns = 0;
+    while (tick < 1000.0 + 1000.0) {
+        for (const auto& e : renderer.process(1024, tick, ticksPerSample)) {
+            noteOns += e.velocity > 0 ? 1 : 0;
+        }
+        tick += 1024 * ticksPerSample;
+    }
+    REQUIRE(noteOns == 1);
+    REQUIRE(renderer.getActiveNoteCount() == 1);  // 62 is still sounding
+
+    // Host loops back: the held note is released at once, and nothing before the new position replays
+    events = renderer.process(1024, 1500.0, ticksPerSample);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].note == 62);
+    REQUIRE(events[0].velocity == 0);
+    REQUIRE(events[0].sampleOffset == 0);
+    REQUIRE(renderer.getActiveNoteCount() == 0);
+
+    renderer.process(1024, 1500.0 + 1024 * ticksPerSample, ticksPerSample);
+    renderer.setSequence(notes, 0);
+    REQUIRE(renderer.allNotesOff().empty());
+}
+
+TEST_CASE("MidiBlockRenderer drops notes past its polyphony", "[midi_render]") {
+    std::vector<MidiNote> notes;
+    for (size_t i = 0; i < MidiBlockRenderer::kMaxActiveNotes + 8; ++i) {
+        notes.push_back({static_cast<uint8_t>(i % 128), 100, static_cast<uint32_t>(i), 100000});
+    }
+    MidiBlockRenderer renderer;
+    renderer.prepare(48000.0, 64);
+    renderer.setSequence(notes);
+    for (int block = 0; block < 200; ++block) {
+        renderer.process(64, TempoMap{}, 480);
+    }
+    REQUIRE(renderer.getActiveNoteCount() == MidiBlockRenderer::kMaxActiveNotes);
+    REQUIRE(renderer.getDroppedNoteCount() == 8);
+    REQUIRE(renderer.allNotesOff().size() == MidiBlockRenderer::kMaxActiveNotes);
+}
@@ -0,0 +1,187 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/midi_file.h"
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+using namespace kelly;
+
+namespace {
+
+std::vector<MidiNote> readAll(std::span<const uint8_t> bytes) {
+    MidiFileReader reader;
+    std::vector<MidiNote> notes;
+    if (reader.open(bytes)) {
+        MidiNote note{};
+        while (reader.nextNote(note)) {
+            notes.push_back(note);
+        }
+    }
+    return notes;
+}
+
+void appendChunk(std::vector<uint8_t>& file, const char (&tag)[5], std::vector<uint8_t> body) {
+    file.insert(file.end(), tag, tag + 4);
+    const auto length = static_cast<uint32_t>(body.size());
+    file.insert(file.end(), {static_cast<uint8_t>(length >> 24), static_cast<uint8_t>(length >> 16),
+                             static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)});
+    file.insert(file.end(), body.begin(), body.end());
+}
+
+} // namespace
+
+TEST_CASE("MidiFileWriter encodes a format 0 file with running status", "[midifile]") {
+    const std::vector<MidiNote> notes{{60, 100, 0, 480}, {64, 90, 0, 480}};
+    MidiFileWriter writer;
+    const auto bytes = writer.write(notes, 120);
+
+    const std::vector<uint8_t> expected{
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xE0,
+        'M', 'T', 'r', 'k', 0, 0, 0, 25,
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,  // 500000 us per quarter
+        0x00, 0x90, 60, 100,
+        0x00, 64, 90,                              // running status
+        0x83, 0x60, 60, 0,                         // delta 480 as a two-byte VLQ
+        0x00, 64, 0,
+        0x00, 0xFF, 0x2F, 0x00,
+    };
+    REQUIRE(std::vector<uint8_t>(bytes.begin(), bytes.end()) == expected);
+    REQUIRE(bytes.size() <= MidiFileWriter::maxEncodedSize(notes.size()));
+
+    const std::vector<MidiNote> unsorted{{60, 100, 480, 10}, {62, 100, 0, 10}};
+    REQUIRE(writer.write(unsorted, 120).empty());
+}
+
+TEST_CASE("MIDI files round-trip through MidiPipeline", "[midifile]") {
+    MidiPipeline source;
+    source.setTempo(93);
+    source.addNote(MidiNote{60, 100, 0, 960});
+    source.addNote(MidiNote{62, 80, 240, 120});
+    source.addNote(MidiNote{60, 70, 960, 480});  // same pitch, starts as the first ends
+    source.addNote(MidiNote{67, 127, 200000, 1});
+
+    const auto path = (std::filesystem::temp_directory_path() / "kelly_roundtrip.mid").string();
+    MidiFileWriter writer;
+    REQUIRE(writer.save(source, path));
+
+    MidiPipeline loaded;
+    MidiFileInfo info;
+    REQUIRE(MidiFileReader::load(path, loaded, &info));
+    std::remove(path.c_str());
+
+    REQUIRE(info.format == 0);
+    REQUIRE(info.trackCount == 1);
+    REQUIRE(info.ppq == 480);
+    REQUIRE(loaded.getTempo() == 93);
+
+    const auto& expected = source.getNotes();
+    const auto& actual = loaded.getNotes();
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(actual[i].note == expected[i].note);
+        REQUIRE(actual[i].velocity == expected[i].velocity);
+        REQUIRE(actual[i].time == expected[i].time);
+        REQUIRE(actual[i].duration == expected[i].duration);
+    }
+}
+
+TEST_CASE("MIDI files round-trip tempo changes", "[midifile]") {
+    MidiPipeline source;
+    source.setTempo(100);
+    source.setTempoAt(960, 140);
+    source.setTempoAt(1920, 72);
+    source.setTempoAt(50000, 90);  // after the last note
+    source.addNote(MidiNote{60, 100, 0, 480});
+    source.addNote(MidiNote{64, 90, 960, 480});  // starts with a tempo change
+    source.addNote(MidiNote{67, 80, 1500, 480});
+
+    MidiFileWriter writer;
+    const std::vector<uint8_t> bytes = [&] {
+        const auto view = writer.write(source);
+        return std::vector<uint8_t>(view.begin(), view.end());
+    }();
+    REQUIRE(!bytes.empty());
+    REQUIRE(bytes.size() <= MidiFileWriter::maxEncodedSize(3, 4));
+
+    MidiFileReader reader;
+    REQUIRE(reader.open(bytes));
+    MidiNote note{};
+    while (reader.nextNote(note)) {
+    }
+    REQUIRE_FALSE(reader.hasError());
+    REQUIRE(reader.getTempoChanges().size() == 4);
+    REQUIRE(reader.getInfo().tempo == 100);
+
+    MidiPipeline loaded;
+    REQUIRE(MidiFileReader::read(bytes, loaded));
+    const auto expected = source.getTempoMap().getChanges();
+    const auto actual = loaded.getTempoMap().getChanges();
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(actual[i].tick == expected[i].tick);
+        REQUIRE(actual[i].bpm == expected[i].bpm);
+    }
+    REQUIRE(loaded.getNotes().size() == 3);
+    REQUIRE(loaded.getNotes()[1].time == 960);
+
+    // A file whose first tempo event is late plays 120 bpm until then
+    MidiPipeline late;
+    late.setTempo(120);
+    late.setTempoAt(480, 60);
+    late.addNote(MidiNote{60, 100, 0, 960});
+    MidiPipeline lateLoaded;
+    REQUIRE(MidiFileReader::read(writer.write(late), lateLoaded));
+    REQUIRE(lateLoaded.getTempoAt(0) == 120);
+    REQUIRE(lateLoaded.getTempoAt(480) == 60);
+}
+
+TEST_CASE("MidiFileReader handles explicit note-offs, other events and dangling notes", "[midifile]") {
+    std::vector<uint8_t> file{'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 96};
+    appendChunk(file, "JUNK", {0xAA, 0xBB});  // unknown chunks are skipped
+    appendChunk(file, "MTrk", {
+        0x00, 0xB1, 7, 100,  // controller
+        0x00, 0x91, 48, 64,  // note on, channel 2
+        0x10, 0x81, 48, 0,   // explicit note off
+        0x00, 0xC1, 5,       // program change, one data byte
+        0x08, 0x91, 50, 30,  // never released
+    });
+    appendChunk(file, "MTrk", {
+        0x00, 0x90, 72, 10,
+        0x60, 72, 0,         // running status, velocity-0 off
+        0x00, 0xFF, 0x2F, 0x00,
+    });
+
+    const auto notes = readAll(file);
+    REQUIRE(notes.size() == 3);
+    REQUIRE(notes[0].note == 48);
+    REQUIRE(notes[0].duration == 16);
+    REQUIRE(notes[1].note == 50);  // closed at its track's end
+    REQUIRE(notes[1].time == 16 + 8);
+    REQUIRE(notes[1].duration == 0);
+    REQUIRE(notes[2].note == 72);
+    REQUIRE(notes[2].duration == 96);
+}
+
+TEST_CASE("MidiFileReader rejects malformed data", "[midifile]") {
+    MidiFileReader reader;
+    REQUIRE_FALSE(reader.open({}));
+
+    const std::vector<uint8_t> smpte{'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0xE7, 0x28};
+    REQUIRE_FALSE(reader.open(smpte));
+
+    MidiPipeline pipeline;
+    pipeline.addNote(MidiNote{60, 100, 0, 480});
+    MidiFileWriter writer;
+    const auto bytes = writer.write(pipeline);
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 6);
+    MidiPipeline loaded;
+    REQUIRE_FALSE(MidiFileReader::read(truncated, loaded));
+
+    // Data byte with no running status established
+    std::vector<uint8_t> noStatus{'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96};
+    appendChunk(noStatus, "MTrk", {0x00, 60, 100});
+    REQUIRE(reader.open(noStatus));
+    MidiNote note{};
+    REQUIRE_FALSE(reader.nextNote(note));
+    REQUIRE(reader.hasError());
+}
@@ -1,5 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include "core/midi_pipeline.h"
+#include <array>
+#include <memory_resource>
 
 using namespace kelly;
 
@@ -28,3 +30,98 @@ TEST_CASE("MidiPipeline can clear notes", "[midi]") {
     pipeline.clear();
     REQUIRE(pipeline.getNotes().empty());
 }
+
+TEST_CASE("MidiPipeline keeps notes sorted by time", "[midi]") {
+    MidiPipeline pipeline;
+    pipeline.addNote(MidiNote{60, 100, 960, 240});
+    pipeline.addNote(MidiNote{62, 100, 0, 240});
+    pipeline.addNote(MidiNote{64, 100, 480, 240});
+    pipeline.addNote(MidiNote{65, 100, 480, 240});
+
+    const auto& notes = pipeline.getNotes();
+    REQUIRE(notes.size() == 4);
+    REQUIRE(notes[0].note == 62);
+    REQUIRE(notes[1].note == 64);
+    REQUIRE(notes[2].note == 65);
+    REQUIRE(notes[3].note == 60);
+}
+
+TEST_CASE("MidiPipeline returns notes starting in a tick range", "[midi]") {
+    MidiPipeline pipeline;
+    for (uint32_t tick = 0; tick < 4800; tick += 120) {
+        pipeline.addNote(MidiNote{60, 100, tick, 60});
+    }
+
+    auto block = pipeline.notesInRange(480, 960);
+    REQUIRE(block.size() == 4);
+    REQUIRE(block.front().time == 480);
+    REQUIRE(block.back().time == 840);
+
+    REQUIRE(pipeline.notesInRange(481, 601).size() == 1);
+    REQUIRE(pipeline.notesInRange(960, 960).empty());
+    REQUIRE(pipeline.notesInRange(10000, 20000).empty());
+}
+
+TEST_CASE("MidiPipeline reserves and bulk-inserts notes", "[midi]") {
+    MidiPipeline pipeline;
+    pipeline.reserve(1024);
+    REQUIRE(pipeline.capacity() >= 1024);
+
+    pipeline.addNote(MidiNote{60, 100, 100, 10});
+    pipeline.addNote(MidiNote{61, 100, 300, 10});
+
+    std::vector<MidiNote> sorted{{70, 90, 0, 10}, {71, 90, 100, 10}, {72, 90, 400, 10}};
+    pipeline.addNotes(sorted);
+    std::vector<MidiNote> unsorted{{80, 80, 350, 10}, {81, 80, 50, 10}};
+    pipeline.addNotes(unsorted);
+
+    const auto& notes = pipeline.getNotes();
+    std::vector<uint8_t> pitches;
+    for (const auto& n : notes) {
+        pitches.push_back(n.note);
+    }
+    REQUIRE(pitches == std::vector<uint8_t>{70, 81, 60, 71, 61, 80, 72});
+    REQUIRE(pipeline.capacity() >= 1024);
+}
+
+TEST_CASE("MidiPipeline grows geometrically across small batches and self-appends", "[midi]") {
+    MidiPipeline pipeline;
+    size_t reallocations = 0;
+    size_t capacity = pipeline.capacity();
+    for (uint32_t i = 0; i < 1000; ++i) {
+        const MidiNote batch[2] = {{60, 90, 2 * i, 1}, {62, 90, 2 * i + 1, 1}};
+        pipeline.addNotes(batch);
+        if (pipeline.capacity() != capacity) {
+            capacity = pipeline.capacity();
+            ++reallocations;
+        }
+    }
+    REQUIRE(pipeline.getNotes().size() == 2000);
+    REQUIRE(reallocations < 20);
+
+    // Appending the pipeline's own notes, with the tail reallocating underneath
+    MidiPipeline small;
+    small.addNote(MidiNote{60, 90, 0, 1});
+    small.addNote(MidiNote{64, 90, 10, 1});
+    small.addNotes(small.getNotes());
+    const auto& notes = small.getNotes();
+    REQUIRE(notes.size() == 4);
+    REQUIRE(notes[0].time == 0);
+    REQUIRE(notes[1].time == 0);
+    REQUIRE(notes[2].time == 10);
+    REQUIRE(notes[3].time == 10);
+    REQUIRE(notes[3].note == 64);
+}
+
+TEST_CASE("MidiPipeline allocates from a caller-supplied resource", "[midi]") {
+    std::array<std::byte, 4096> arena;
+    std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(), std::pmr::null_memory_resource());
+
+    MidiPipeline pipeline(&resource);
+    REQUIRE(pipeline.getMemoryResource() == &resource);
+    pipeline.reserve(128);
+    for (uint32_t i = 0; i < 128; ++i) {
+        pipeline.addNote(MidiNote{60, 100, i * 10, 10});
+    }
+    REQUIRE(pipeline.getNotes().size() == 128);
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/music_database.h"
+#include "core/json_reader.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace kelly;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void writeText(const fs::path& path, std::string_view text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+}
+
+// Minimal versions of the three data/json files
+fs::path makeJsonDirectory(std::string_view name) {
+    const fs::path dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    writeText(dir / MusicDatabase::kProgressionsFile, R"({
+        "progressions_by_emotion": {
+            "melancholy": [{"name": "Sad Loop", "numerals": ["vi", "IV", "I", "V"]}],
+            "epic": [{"name": "Rising", "numerals": ["I", "bVI", "bVII", "I"]}]
+        }
+    })");
+    writeText(dir / MusicDatabase::kFamiliesFile, R"({
+        "_version": "1.0",
+        "universal_progressions": {
+            "I-IV-V-I": {"degrees": [0, 5, 7, 0], "roman": "I - IV - V - I", "name": "Three Chord Song"}
+        },
+        "cadence_types": {"half": {"degrees": ["any", 7]}}
+    })");
+    writeText(dir / MusicDatabase::kScalesFile, R"json({
+        "scales": [
+            {"scale_type": "Aeolian (Natural Minor)", "category": "Major Modes",
+             "intervals_semitones": [0, 2, 3, 5, 7, 8, 10], "emotional_quality": ["sad", "melancholy"]}
+        ]
+    })json");
+    return dir;
+}
+
+} // namespace
+
+TEST_CASE("parseJson handles the JSON grammar", "[musicdata]") {
+    const auto doc = parseJson(R"({"a": [1, -2.5e1, true, null], "s": "café \"q\""})");
+    REQUIRE(doc.has_value());
+    REQUIRE(doc->find("a")->items().size() == 4);
+    REQUIRE(doc->find("a")->items()[1].asNumber() == -25.0);
+    REQUIRE(doc->find("s")->asString() == "caf\xC3\xA9 \"q\"");
+    REQUIRE(doc->find("missing") == nullptr);
+
+    REQUIRE_FALSE(parseJson(R"({"a": 1,})").has_value());
+    REQUIRE_FALSE(parseJson(R"({"orphan value"})").has_value());
+    REQUIRE_FALSE(parseJson("[01]").has_value());
+}
+
+TEST_CASE("MusicDatabase compiles progressions, scales and emotion tags", "[musicdata]") {
+    const fs::path dir = makeJsonDirectory("kelly_music_compile");
+    auto image = MusicDatabase::compile(dir.string());
+    REQUIRE(image.has_value());
+    auto db = MusicDatabase::fromImage(std::move(*image));
+    REQUIRE(db != nullptr);
+
+    REQUIRE(db->getProgressionCount() == 3);  // the cadence table entry is skipped
+    const MusicProgression family = db->getProgression(0);
+    REQUIRE(family.name == "Three Chord Song");
+    REQUIRE(family.source == ProgressionSource::Family);
+    REQUIRE(std::vector<uint8_t>(family.degrees.begin(), family.degrees.end()) == std::vector<uint8_t>{0, 5, 7, 0});
+
+    const auto epic = db->progressionsForEmotion("epic");
+    REQUIRE(epic.size() == 1);
+    const MusicProgression rising = db->getProgression(epic[0]);
+    REQUIRE(rising.numerals == "I - bVI - bVII - I");
+    REQUIRE(std::vector<uint8_t>(rising.degrees.begin(), rising.degrees.end()) == std::vector<uint8_t>{0, 8, 10, 0});
+
+    const int aeolian = db->findScale("Aeolian (Natural Minor)");
+    REQUIRE(aeolian == 0);
+    REQUIRE(db->getScale(0).intervalMask == 0b010110101101);
+    REQUIRE(db->scalesForEmotion("melancholy").size() == 1);
+    REQUIRE(db->progressionsForEmotion("melancholy").size() == 1);
+    REQUIRE(db->scalesForEmotion("joyful").empty());
+    REQUIRE(db->getEmotionTag(0) == "epic");  // sorted
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("MusicDatabase cache is reused until the JSON changes", "[musicdata]") {
+    const fs::path dir = makeJsonDirectory("kelly_music_cache");
+    const std::string cache = (dir / "music.kmdc").string();
+
+    auto first = MusicDatabase::load(dir.string(), cache);
+    REQUIRE(first != nullptr);
+    REQUIRE(first->wasCompiled());
+    REQUIRE(first->isMapped());
+    REQUIRE(first->getFingerprint() == MusicDatabase::fingerprint(dir.string()));
+
+    auto second = MusicDatabase::load(dir.string(), cache);
+    REQUIRE(second != nullptr);
+    REQUIRE_FALSE(second->wasCompiled());
+    REQUIRE(second->getProgressionCount() == first->getProgressionCount());
+
+    // Touching a source file invalidates the cache
+    const fs::path scales = dir / MusicDatabase::kScalesFile;
+    fs::last_write_time(scales, fs::last_write_time(scales) + std::chrono::seconds(5));
+    auto third = MusicDatabase::load(dir.string(), cache);
+    REQUIRE(third != nullptr);
+    REQUIRE(third->wasCompiled());
+
+    // Without JSON the cache alone is enough
+    fs::remove(scales);
+    REQUIRE(MusicDatabase::fingerprint(dir.string()) == 0);
+    auto cacheOnly = MusicDatabase::load(dir.string(), cache);
+    REQUIRE(cacheOnly != nullptr);
+    REQUIRE_FALSE(cacheOnly->wasCompiled());
+
+    first.reset();
+    second.reset();
+    third.reset();
+    cacheOnly.reset();
+    fs::remove_all(dir);
+    REQUIRE(MusicDatabase::load(dir.string(), cache) == nullptr);
+}
+
+TEST_CASE("MusicDatabase refuses more records than its uint16_t IDs can name", "[musicdata]") {
+    const fs::path dir = makeJsonDirectory("kelly_music_overflow");
+    std::string scales = R"({"scales": [)";
+    for (size_t i = 0; i <= MusicDatabase::kMaxRecords; ++i) {
+        scales += i == 0 ? "" : ",";
+        scales += R"({"scale_type": "s", "intervals_semitones": [0], "emotional_quality": ["sad"]})";
+    }
+    scales += "]}";
+    writeText(dir / MusicDatabase::kScalesFile, scales);
+
+    REQUIRE_FALSE(MusicDatabase::compile(dir.string()).has_value());
+    fs::remove_all(dir);
+}
+
+#ifdef KELLY_DATA_DIR
+TEST_CASE("MusicDatabase compiles the shipped data files", "[musicdata]") {
+    auto image = MusicDatabase::compile(KELLY_DATA_DIR);
+    REQUIRE(image.has_value());
+    auto db = MusicDatabase::fromImage(std::move(*image));
+    REQUIRE(db != nullptr);
+
+    REQUIRE(db->getScaleCount() > 50);
+    REQUIRE(db->getProgressionCount() > 50);
+    REQUIRE(db->findScale("Ionian (Major)") >= 0);
+    REQUIRE(db->getScale(db->findScale("Ionian (Major)")).intervalMask == 0b101010110101);
+    REQUIRE_FALSE(db->progressionsForEmotion("melancholy").empty());
+    REQUIRE_FALSE(db->scalesForEmotion("mysterious").empty());
+}
+#endif
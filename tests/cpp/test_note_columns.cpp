@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/note_columns.h"
+#include <array>
+#include <memory_resource>
+#include <vector>
+
+using namespace kelly;
+
+namespace {
+
+std::vector<MidiNote> sampleNotes() {
+    return {{60, 100, 0, 480}, {2, 40, 480, 240}, {125, 127, 960, 960}, {64, 1, 1920, 120}};
+}
+
+} // namespace
+
+TEST_CASE("NoteColumns round-trips MidiNote", "[note_columns]") {
+    const std::vector<MidiNote> notes = sampleNotes();
+    NoteColumns columns;
+    columns.assign(notes);
+    REQUIRE(columns.size() == 4);
+    REQUIRE(columns.pitches()[2] == 125);
+    REQUIRE(columns.times()[3] == 1920);
+
+    columns.append(MidiNote{70, 80, 3000, 10});
+    const std::vector<MidiNote> back = columns.toNotes();
+    REQUIRE(back.size() == 5);
+    for (size_t i = 0; i < notes.size(); ++i) {
+        REQUIRE(back[i].note == notes[i].note);
+        REQUIRE(back[i].velocity == notes[i].velocity);
+        REQUIRE(back[i].time == notes[i].time);
+        REQUIRE(back[i].duration == notes[i].duration);
+    }
+    REQUIRE(columns[4].time == 3000);
+
+    columns.clear();
+    REQUIRE(columns.empty());
+}
+
+TEST_CASE("NoteColumns uses the given memory resource", "[note_columns]") {
+    std::array<std::byte, 4096> arena{};
+    std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(), std::pmr::null_memory_resource());
+    NoteColumns columns(&resource);
+    columns.reserve(64);
+    columns.assign(sampleNotes());
+    REQUIRE(columns.getMemoryResource() == &resource);
+    REQUIRE(columns.size() == 4);
+}
+
+TEST_CASE("NoteColumns transforms saturate instead of wrapping", "[note_columns]") {
+    NoteColumns columns;
+    columns.assign(sampleNotes());
+
+    columns.transpose(5);
+    REQUIRE(columns.pitches()[0] == 65);
+    REQUIRE(columns.pitches()[2] == 127);
+    columns.transpose(-10);
+    REQUIRE(columns.pitches()[1] == 0);
+
+    columns.clampPitches(72, 36);
+    REQUIRE(columns.pitches()[0] == 55);
+    REQUIRE(columns.pitches()[1] == 36);
+    REQUIRE(columns.pitches()[2] == 72);
+
+    columns.shiftTime(-500);
+    REQUIRE(columns.times()[0] == 0);
+    REQUIRE(columns.times()[1] == 0);
+    REQUIRE(columns.times()[2] == 460);
+    columns.shiftTime(500);
+    REQUIRE(columns.times()[3] == 1920);
+
+    columns.scaleTime(0.5);
+    REQUIRE(columns.times()[3] == 960);
+    REQUIRE(columns.durations()[2] == 480);
+    columns.scaleTime(1e12);
+    REQUIRE(columns.times()[3] == UINT32_MAX);
+}
+
+TEST_CASE("NoteColumns velocity curves follow dynamics", "[note_columns]") {
+    const VelocityCurve linear = makeVelocityCurve(0.5f);
+    REQUIRE(linear[0] == 0);
+    REQUIRE(linear[64] == 64);
+    REQUIRE(linear[127] == 127);
+
+    const VelocityCurve loud = makeVelocityCurve(0.9f, 40, 110);
+    const VelocityCurve soft = makeVelocityCurve(0.1f, 40, 110);
+    REQUIRE(loud[1] >= 40);
+    REQUIRE(loud[127] == 110);
+    REQUIRE(loud[64] > linear[64]);
+    REQUIRE(soft[64] < loud[64]);
+    for (size_t v = 2; v < 128; ++v) {
+        REQUIRE(loud[v] >= loud[v - 1]);
+    }
+
+    NoteColumns columns;
+    columns.assign(sampleNotes());
+    columns.applyVelocityCurve(loud);
+    REQUIRE(columns.velocities()[2] == 110);
+    REQUIRE(columns.velocities()[3] >= 40);
+}
+
+TEST_CASE("NoteColumns::clipToRange keeps notes starting in range", "[note_columns]") {
+    NoteColumns columns;
+    columns.assign(sampleNotes());
+    columns.clipToRange(400, 1500);
+    REQUIRE(columns.size() == 2);
+    REQUIRE(columns.times()[0] == 480);
+    REQUIRE(columns.times()[1] == 960);
+    REQUIRE(columns.durations()[1] == 540);
+    REQUIRE(columns.pitches()[1] == 125);
+
+    MidiPipeline pipeline;
+    pipeline.addNotes(columns.toNotes());
+    REQUIRE(pipeline.getNotes().size() == 2);
+}
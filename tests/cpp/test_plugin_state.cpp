@@ -0,0 +1,237 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/plugin_state.h"
+#include "core/emotion_model.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace kelly;
+
+namespace {
+
+PluginState makeState() {
+    const EmotionModelHandle model = EmotionModel::shared();
+    PluginState state;
+    state.emotionId = 5;
+    state.request.emotionId = 5;
+    state.request.grooveId = 2;
+    state.request.params.mode = MusicalMode::Major;
+    state.request.params.dynamics = 0.8f;
+    state.request.bars = 2;
+    state.request.seed = 77;
+    state.hasTrajectory = state.trajectory.build(model->getEngine(), model->getPaths(), 5, 40);
+    state.trajectoryLengthTicks = 8 * 4 * 480;
+    state.trajectoryProgress = 0.25f;
+    state.phrase.emotionId = 5;
+    state.phrase.barTicks = 1920;
+    state.phrase.lengthTicks = 3840;
+    state.phrase.notes = {{60, 90, 0, 240}, {64, 80, 480, 240}, {67, 70, 960, 480}};
+    return state;
+}
+
+constexpr size_t kGrooveCount = 4;
+
+// Overwrites a field of a saved blob in place
+template <typename T>
+std::vector<std::byte> patched(std::vector<std::byte> bytes, size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    return bytes;
+}
+
+constexpr size_t requestField(size_t offset) {
+    return offsetof(PluginStateHeader, request) + offset;
+}
+
+bool sameNotes(const std::vector<MidiNote>& a, const std::vector<MidiNote>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(MidiNote)) == 0;
+}
+
+} // namespace
+
+TEST_CASE("Plugin state round-trips emotion, trajectory and phrase", "[plugin_state]") {
+    const PluginState state = makeState();
+    REQUIRE(state.hasTrajectory);
+    const std::vector<std::byte> bytes = savePluginState(state);
+    REQUIRE(bytes.size() == sizeof(PluginStateHeader) + EmotionTrajectory::kImageSize + 3 * sizeof(MidiNote));
+
+    PluginState loaded;
+    REQUIRE(loadPluginState(bytes, loaded, kGrooveCount));
+    CHECK(loaded.emotionId == 5);
+    CHECK(loaded.request.grooveId == 2);
+    CHECK(loaded.request.seed == 77);
+    CHECK(loaded.request.params.mode == MusicalMode::Major);
+    CHECK(loaded.request.params.dynamics == 0.8f);
+    CHECK(loaded.hasTrajectory);
+    CHECK(loaded.trajectory.getFrom() == 5);
+    CHECK(loaded.trajectory.getTo() == 40);
+    CHECK(loaded.trajectory.frameAt(0.6f).emotionId == state.trajectory.frameAt(0.6f).emotionId);
+    CHECK(loaded.trajectoryLengthTicks == state.trajectoryLengthTicks);
+    CHECK(loaded.trajectoryProgress == 0.25f);
+    CHECK(loaded.phrase.barTicks == 1920);
+    CHECK(loaded.phrase.lengthTicks == 3840);
+    CHECK(sameNotes(loaded.phrase.notes, state.phrase.notes));
+
+    // Without a trajectory or notes the blob is just the header
+    PluginState bare;
+    bare.emotionId = -1;
+    const std::vector<std::byte> header = savePluginState(bare);
+    CHECK(header.size() == sizeof(PluginStateHeader));
+    REQUIRE(loadPluginState(header, loaded, kGrooveCount));
+    CHECK(loaded.emotionId == -1);
+    CHECK_FALSE(loaded.hasTrajectory);
+    CHECK(loaded.phrase.notes.empty());
+}
+
+TEST_CASE("A fresh instance's state restores without phrase playback", "[plugin_state]") {
+    // What getStateInformation saves before any wound: no emotion, the
+    // renderer's default request and no rendered notes
+    PluginState fresh;
+    REQUIRE_FALSE(fresh.restoresPhrases());
+
+    PluginState loaded;
+    REQUIRE(loadPluginState(savePluginState(fresh), loaded, kGrooveCount));
+    CHECK(loaded.emotionId == -1);
+    CHECK_FALSE(loaded.restoresPhrases());
+    CHECK_FALSE(loaded.hasTrajectory);
+    CHECK(loaded.phrase.notes.empty());
+
+    fresh.emotionId = 0;  // emotion 0 once a wound or trajectory set it
+    REQUIRE(loadPluginState(savePluginState(fresh), loaded, kGrooveCount));
+    CHECK(loaded.restoresPhrases());
+}
+
+TEST_CASE("Plugin state rejects foreign, stale and truncated data", "[plugin_state]") {
+    const std::vector<std::byte> bytes = savePluginState(makeState());
+    PluginState out;
+    out.emotionId = 99;
+
+    std::vector<std::byte> badMagic = bytes;
+    badMagic[0] = std::byte{'X'};
+    CHECK_FALSE(loadPluginState(badMagic, out, kGrooveCount));
+
+    const uint16_t version = kPluginStateVersion + 1;
+    CHECK_FALSE(loadPluginState(patched(bytes, offsetof(PluginStateHeader, version), version), out, kGrooveCount));
+
+    CHECK_FALSE(loadPluginState(std::span(bytes).first(bytes.size() - 1), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(std::span(bytes).first(sizeof(PluginStateHeader) - 1), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState({}, out, kGrooveCount));
+    CHECK(out.emotionId == 99);
+}
+
+TEST_CASE("Plugin state rejects out-of-range fields", "[plugin_state]") {
+    const std::vector<std::byte> bytes = savePluginState(makeState());
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const size_t params = requestField(offsetof(PhraseRequest, params));
+    const size_t trajectory = sizeof(PluginStateHeader);
+    const size_t notes = trajectory + EmotionTrajectory::kImageSize;
+    PluginState out;
+    REQUIRE(loadPluginState(bytes, out, kGrooveCount));
+    out.emotionId = 99;
+
+    CHECK_FALSE(loadPluginState(patched(bytes, requestField(offsetof(PhraseRequest, ppq)), uint32_t{1u << 30}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, requestField(offsetof(PhraseRequest, ppq)), uint32_t{0}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, requestField(offsetof(PhraseRequest, bars)), uint32_t{0}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, requestField(offsetof(PhraseRequest, bars)), PhraseGenerator::kMaxBars + 1), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, requestField(offsetof(PhraseRequest, grooveId)), int{kGrooveCount}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, requestField(offsetof(PhraseRequest, emotionId)), int{216}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, requestField(offsetof(PhraseRequest, bpm)), int{0}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, offsetof(PluginStateHeader, emotionId), int{-2}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, params + offsetof(MusicalParams, dynamics), nan), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, params + offsetof(MusicalParams, tempoModifier), nan), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, params + offsetof(MusicalParams, mode), uint8_t{7}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, params + offsetof(MusicalParams, velocityMax), uint8_t{200}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, offsetof(PluginStateHeader, trajectoryProgress), nan), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, offsetof(PluginStateHeader, trajectoryLengthTicks), uint64_t{0}), out, kGrooveCount));
+
+    // Trajectory image: a frame's emotion, a frame's attributes and the end IDs
+    CHECK_FALSE(loadPluginState(patched(bytes, trajectory + offsetof(MorphFrame, emotionId), int16_t{-1}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, trajectory + 9 * sizeof(MorphFrame) + offsetof(MorphFrame, majorWeight), nan), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, notes - 2, int16_t{500}), out, kGrooveCount));
+
+    // Notes: out of order, a zero velocity, a pitch above 127
+    CHECK_FALSE(loadPluginState(patched(bytes, notes + sizeof(MidiNote) + offsetof(MidiNote, time), uint32_t{5000}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, notes + offsetof(MidiNote, velocity), uint8_t{0}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, notes + offsetof(MidiNote, note), uint8_t{128}), out, kGrooveCount));
+    CHECK_FALSE(loadPluginState(patched(bytes, offsetof(PluginStateHeader, phraseBarTicks), uint32_t{0}), out, kGrooveCount));
+
+    CHECK(out.emotionId == 99);
+}
+
+TEST_CASE("Plugin state survives random corruption", "[plugin_state]") {
+    const std::vector<std::byte> bytes = savePluginState(makeState());
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> position(0, bytes.size() - 1);
+    std::uniform_int_distribution<int> value(0, 255);
+
+    for (int round = 0; round < 2000; ++round) {
+        std::vector<std::byte> corrupt = bytes;
+        // Mostly header hits, where the fields are densest
+        for (int hit = 0; hit < 1 + round % 4; ++hit) {
+            const size_t at = round % 2 == 0 ? position(rng) % sizeof(PluginStateHeader) : position(rng);
+            corrupt[at] = static_cast<std::byte>(value(rng));
+        }
+
+        PluginState state;
+        if (!loadPluginState(corrupt, state, kGrooveCount)) {
+            continue;
+        }
+        // Anything accepted is safe to hand to the renderer and the trajectory player
+        REQUIRE(state.request.ppq >= 1);
+        REQUIRE(state.request.ppq <= kPluginStateMaxPpq);
+        REQUIRE(state.request.bars >= 1);
+        REQUIRE(state.request.bars <= PhraseGenerator::kMaxBars);
+        REQUIRE(static_cast<size_t>(state.request.grooveId) < kGrooveCount);
+        REQUIRE(std::isfinite(state.request.params.dynamics));
+        REQUIRE(std::is_sorted(state.phrase.notes.begin(), state.phrase.notes.end(),
+                               [](const MidiNote& a, const MidiNote& b) { return a.time < b.time; }));
+        if (state.hasTrajectory) {
+            REQUIRE(state.trajectory.isValid());
+            const MorphFrame frame = state.trajectory.frameAt(state.trajectoryProgress);
+            REQUIRE(frame.emotionId >= 0);
+            REQUIRE(frame.emotionId < 216);
+            REQUIRE(std::isfinite(frame.tempoModifier));
+        }
+    }
+}
+
+TEST_CASE("GrooveTemplates::shared is one library while held", "[plugin_state]") {
+    const GrooveTemplatesHandle a = GrooveTemplates::shared();
+    const GrooveTemplatesHandle b = GrooveTemplates::shared();
+    CHECK(a == b);
+    CHECK(a->findTemplateId("straight") >= 0);
+}
+
+TEST_CASE("LookaheadRenderer restores a saved phrase without rendering", "[plugin_state]") {
+    PhraseRequest request;
+    request.emotionId = 7;
+    request.bars = 2;
+    RenderedPhrase saved;
+    {
+        LookaheadRenderer renderer(std::make_shared<TaskPool>(1));
+        CHECK_FALSE(renderer.snapshot(saved));
+        renderer.setRequest(request);
+        renderer.service();
+        REQUIRE(renderer.snapshot(saved));
+    }
+    REQUIRE_FALSE(saved.notes.empty());
+    CHECK(saved.emotionId == 7);
+
+    // A null pool is only acquired at the first render, which restore() skips
+    LookaheadRenderer restored;
+    RenderedPhrase copy = saved;
+    restored.restore(request, std::move(copy));
+    REQUIRE(restored.isNextReady());
+    restored.service();  // the restored phrase is current: nothing to submit
+
+    const RenderedPhrase* phrase = restored.advance(0);
+    REQUIRE(phrase != nullptr);
+    CHECK(phrase->emotionId == 7);
+    CHECK(phrase->lengthTicks == saved.lengthTicks);
+    CHECK(sameNotes(phrase->notes, saved.notes));
+
+    RenderedPhrase again;
+    REQUIRE(restored.snapshot(again));
+    CHECK(sameNotes(again.notes, saved.notes));
+}
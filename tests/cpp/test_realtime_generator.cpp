@@ -0,0 +1,164 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/realtime_generator.h"
+#include "core/intent_processor.h"
+#include "core/emotion_catalog.h"
+#include "core/triple_buffer.h"
+#include <map>
+#include <thread>
+
+using namespace kelly;
+
+TEST_CASE("RealtimeGenerator precomputes params from rule breaks", "[realtime]") {
+    IntentProcessor processor;
+    RealtimeGenerator generator(processor);
+
+    const MusicalParams& rage = generator.getParams(emotionIdFromName("rage"));
+    REQUIRE(rage.velocityMin == 10);
+    REQUIRE(rage.velocityMax == 127);
+    REQUIRE(rage.syncopationLevel > 0.7f);
+    REQUIRE(rage.clusterProbability > 0.5f);
+    REQUIRE(rage.mode == MusicalMode::Minor);
+
+    const MusicalParams& joy = generator.getParams(emotionIdFromName("euphoria"));
+    REQUIRE(joy.mode == MusicalMode::Major);
+}
+
+TEST_CASE("RealtimeGenerator emits ordered, balanced events", "[realtime]") {
+    IntentProcessor processor;
+    RealtimeGenerator generator(processor);
+    generator.prepare(48000.0, 128);
+    generator.setEmotion(emotionIdFromName("rage"));
+
+    std::map<uint8_t, int> sounding;
+    int noteOns = 0;
+    for (int block = 0; block < 2000; ++block) {
+        auto events = generator.process(128, 140.0);
+        int previousOffset = 0;
+        for (const auto& e : events) {
+            REQUIRE(e.sampleOffset >= previousOffset);
+            REQUIRE(e.sampleOffset < 128);
+            previousOffset = e.sampleOffset;
+            if (e.velocity > 0) {
+                REQUIRE(sounding[e.note] == 0);
+                ++sounding[e.note];
+                ++noteOns;
+            } else {
+                REQUIRE(sounding[e.note] == 1);
+                --sounding[e.note];
+            }
+        }
+    }
+    REQUIRE(noteOns > 0);
+
+    for (const auto& e : generator.allNotesOff()) {
+        REQUIRE(e.velocity == 0);
+        --sounding[e.note];
+    }
+    for (const auto& [note, count] : sounding) {
+        REQUIRE(count == 0);
+    }
+}
+
+TEST_CASE("RealtimeGenerator keeps note-offs pending when the event buffer is full", "[realtime]") {
+    IntentProcessor processor;
+    RealtimeGenerator generator(processor);
+    generator.prepare(48000.0, 16);  // host then sends blocks far larger than announced
+    generator.setEmotion(emotionIdFromName("rage"));
+
+    std::map<uint8_t, int> sounding;
+    for (int block = 0; block < 200; ++block) {
+        const int numSamples = block % 2 == 0 ? 48000 : 16;
+        for (const auto& e : generator.process(numSamples, 300.0)) {
+            if (e.velocity > 0) {
+                REQUIRE(sounding[e.note] == 0);
+                ++sounding[e.note];
+            } else {
+                REQUIRE(sounding[e.note] == 1);
+                --sounding[e.note];
+            }
+        }
+    }
+
+    for (const auto& e : generator.allNotesOff()) {
+        --sounding[e.note];
+    }
+    for (const auto& [note, count] : sounding) {
+        REQUIRE(count == 0);
+    }
+}
+
+TEST_CASE("RealtimeGenerator ignores invalid emotion IDs", "[realtime]") {
+    IntentProcessor processor;
+    RealtimeGenerator generator(processor);
+    generator.setEmotion(5);
+    generator.setEmotion(9999);
+    REQUIRE(generator.getEmotion() == 5);
+}
+
+TEST_CASE("TripleBuffer hands over only the newest complete value", "[realtime]") {
+    struct Pair {
+        uint32_t a;
+        uint32_t b;
+    };
+    TripleBuffer<Pair> buffer(Pair{0, 0});
+    REQUIRE_FALSE(buffer.update());
+
+    buffer.write(Pair{1, 1});
+    buffer.write(Pair{2, 2});
+    REQUIRE(buffer.update());
+    REQUIRE(buffer.front().a == 2);
+    REQUIRE_FALSE(buffer.update());
+
+    constexpr uint32_t kWrites = 200000;
+    std::thread producer([&] {
+        for (uint32_t i = 3; i <= kWrites; ++i) {
+            buffer.write(Pair{i, ~i});
+        }
+    });
+    bool consistent = true;
+    bool monotonic = true;
+    uint32_t last = 2;
+    while (last < kWrites) {
+        if (buffer.update()) {
+            const Pair& value = buffer.front();
+            consistent = consistent && value.b == ~value.a;
+            monotonic = monotonic && value.a > last;
+            last = value.a;
+        }
+    }
+    producer.join();
+    REQUIRE(consistent);
+    REQUIRE(monotonic);
+}
+
+TEST_CASE("RealtimeGenerator adopts published intents at the next block", "[realtime]") {
+    IntentProcessor processor;
+    RealtimeGenerator generator(processor);
+    generator.prepare(48000.0, 256);
+
+    const IntentResult result = processor.processIntent(Wound{"rage at the injustice", 0.9f, "test"});
+    MusicalParams params = result.musicalParams;
+    params.tempoModifier = 10.0f;
+    params.velocityMin = 100;
+    params.velocityMax = 101;
+    params.clusterProbability = 0.0f;
+    generator.publishIntent(result.emotion->id, params);
+    REQUIRE(generator.getEmotion() == result.emotion->id);
+    REQUIRE(generator.getActiveIntent().emotionId != result.emotion->id);
+
+    bool sawNoteOn = false;
+    for (int block = 0; block < 100; ++block) {
+        for (const auto& e : generator.process(256, 120.0)) {
+            if (e.velocity > 0) {
+                sawNoteOn = true;
+                REQUIRE((e.velocity == 100 || e.velocity == 101));
+            }
+        }
+    }
+    REQUIRE(sawNoteOn);
+    REQUIRE(generator.getActiveIntent().emotionId == result.emotion->id);
+    REQUIRE(generator.getActiveIntent().params.tempoModifier == RealtimeGenerator::kMaxTempoModifier);
+
+    generator.publishIntent(-1, params);
+    REQUIRE(generator.getEmotion() == result.emotion->id);
+}
@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/task_pool.h"
+#include "core/lookahead_renderer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace kelly;
+
+namespace {
+
+void waitFor(const std::atomic<int>& counter, int expected) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (counter.load() < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+PhraseRequest makeRequest(MusicalMode mode) {
+    PhraseRequest request;
+    request.emotionId = 3;
+    request.params.mode = mode;
+    request.params.velocityMin = 60;
+    request.params.velocityMax = 90;
+    request.bars = 4;
+    return request;
+}
+
+} // namespace
+
+TEST_CASE("TaskPool runs every task, including ones submitted by tasks", "[task_pool]") {
+    TaskPool pool(3);
+    REQUIRE(pool.getThreadCount() == 3);
+
+    std::atomic<int> done{0};
+    for (int i = 0; i < 500; ++i) {
+        pool.submit([&] {
+            pool.submit([&] { done.fetch_add(1); });
+            done.fetch_add(1);
+        });
+    }
+    waitFor(done, 1000);
+    REQUIRE(done.load() == 1000);
+}
+
+TEST_CASE("TaskPool finishes queued work before joining", "[task_pool]") {
+    std::atomic<int> done{0};
+    {
+        TaskPool pool(2);
+        for (int i = 0; i < 64; ++i) {
+            pool.submit([&] {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                done.fetch_add(1);
+            });
+        }
+    }
+    REQUIRE(done.load() == 64);
+}
+
+TEST_CASE("TaskPool::shared is one pool while held", "[task_pool]") {
+    const TaskPoolHandle a = TaskPool::shared();
+    const TaskPoolHandle b = TaskPool::shared();
+    REQUIRE(a == b);
+    REQUIRE(a->getThreadCount() >= 1);
+}
+
+TEST_CASE("PhraseGenerator renders bars of sorted notes within the params", "[task_pool]") {
+    GrooveTemplates grooves;
+    PhraseGenerator generator(grooves);
+    MidiPipeline pipeline;
+
+    PhraseRequest request = makeRequest(MusicalMode::Major);
+    request.grooveId = grooves.findTemplateId("straight");
+    const uint32_t length = generator.render(request, pipeline);
+    REQUIRE(length == 4 * 4 * 480);
+
+    const auto& notes = pipeline.getNotes();
+    REQUIRE(notes.size() == 4 * (1 + grooves.getTemplate(request.grooveId)->pattern.size()));
+    REQUIRE(std::is_sorted(notes.begin(), notes.end(),
+                           [](const MidiNote& a, const MidiNote& b) { return a.time < b.time; }));
+    for (const MidiNote& note : notes) {
+        REQUIRE(note.velocity >= 1);
+        REQUIRE(note.velocity <= 127);
+        REQUIRE(note.time < length);
+    }
+    // Bar one is the tonic: bass C2 under C major
+    REQUIRE(notes.front().note == PhraseGenerator::kTonic - 12);
+}
+
+TEST_CASE("LookaheadRenderer swaps rendered phrases in at phrase boundaries", "[task_pool]") {
+    LookaheadRenderer renderer(std::make_shared<TaskPool>(2));
+    REQUIRE(renderer.advance(0) == nullptr);
+
+    renderer.service();  // no request yet
+    REQUIRE_FALSE(renderer.isNextReady());
+
+    renderer.setRequest(makeRequest(MusicalMode::Minor));
+    renderer.service();
+    renderer.waitForRender();
+    REQUIRE(renderer.isNextReady());
+
+    const RenderedPhrase* first = renderer.advance(100);
+    REQUIRE(first != nullptr);
+    REQUIRE(first->lengthTicks == 4 * 1920);
+    REQUIRE(first->barTicks == 1920);
+    REQUIRE_FALSE(first->notes.empty());
+    REQUIRE(renderer.getPhraseStart() == 0);
+
+    // Nothing queued: the phrase repeats
+    REQUIRE(renderer.advance(first->lengthTicks + 10) == first);
+    REQUIRE(renderer.getPhraseStart() == first->lengthTicks);
+
+    renderer.service();
+    renderer.waitForRender();
+    const RenderedPhrase* second = renderer.advance(2 * first->lengthTicks);
+    REQUIRE(second != nullptr);
+    REQUIRE(second != first);
+    REQUIRE(renderer.getPhraseStart() == 2 * 4 * 1920);
+
+    // A new request replaces the queued phrase and is heard from the next boundary
+    renderer.service();
+    renderer.waitForRender();
+    PhraseRequest changed = makeRequest(MusicalMode::Major);
+    changed.emotionId = 7;
+    renderer.setRequest(changed);
+    renderer.service();
+    renderer.waitForRender();
+    REQUIRE(renderer.advance(2 * 4 * 1920 + 5) == second);
+    const RenderedPhrase* third = renderer.advance(3 * 4 * 1920);
+    REQUIRE(third->emotionId == 7);
+    REQUIRE(third->generation == 2);
+
+    // Host jumped backwards: realigned to the bar
+    renderer.advance(1920 + 50);
+    REQUIRE(renderer.getPhraseStart() == 1920);
+
+    renderer.service();  // frees the retired phrases
+}
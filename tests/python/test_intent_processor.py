@@ -54,3 +54,64 @@ def test_wound_history():
     processor.process_wound(wound2)
     
     assert len(processor.wound_history) == 2
+
+
+def test_process_intents_batch():
+    """Test batch processing returns one result per wound, in order."""
+    processor = IntentProcessor()
+    wounds = [
+        Wound(description="grief and loss", intensity=0.9, source="user"),
+        Wound(description="rage", intensity=0.7, source="user"),
+    ]
+    results = processor.process_intents(wounds)
+
+    assert len(results) == 2
+    assert [r["wound"] for r in results] == wounds
+    assert results[0]["emotion"].name == "grief"
+    assert len(processor.wound_history) == 2
+
+
+def test_native_process_wounds():
+    """Test the native batch call returns a structured array."""
+    native = pytest.importorskip("kelly._native")
+    processor = native.IntentProcessor()
+    rows = processor.process_wounds(["grief and loss", "rage"], [0.9, 0.7])
+
+    assert rows.dtype == native.WOUND_RESULT_DTYPE
+    assert len(rows) == 2
+    assert native.emotion_names()[rows["emotion_id"][0]] == "grief"
+
+
+def test_process_intents_uses_native_columns():
+    """Test batch results come from the native rows when the module is built."""
+    native = pytest.importorskip("kelly._native")
+    processor = IntentProcessor()
+    results = processor.process_intents([Wound(description="rage", intensity=0.7, source="user")])
+    rows = native.IntentProcessor().process_wounds(["rage"], [0.7])
+
+    params = results[0]["musical_params"]
+    assert results[0]["emotion"].id == rows["emotion_id"][0]
+    assert params["tempo_modifier"] == pytest.approx(float(rows["tempo_modifier"][0]))
+    assert params["mode"] == ("major" if rows["mode"][0] == 1 else "minor")
+    assert len(results[0]["rule_breaks"]) == bin(int(rows["flags"][0])).count("1")
+
+
+def test_single_and_batch_paths_agree():
+    """Test process_wound maps every wound as process_intents does."""
+    descriptions = ["I am sad", "a glossy magazine", "grief and loss", "rage", "I feel hopeless"]
+    wounds = [Wound(description=d, intensity=0.7, source="user") for d in descriptions]
+    processor = IntentProcessor()
+
+    single = [processor.process_wound(wound).id for wound in wounds]
+    batch = [result["emotion"].id for result in processor.process_intents(wounds)]
+    assert single == batch
+
+
+def test_process_wound_uses_native_classifier():
+    """Test single wounds are classified by the native matcher when built."""
+    native = pytest.importorskip("kelly._native")
+    classifier = native.IntentProcessor()
+    processor = IntentProcessor()
+    for description in ["I am sad", "a glossy magazine", "fearful"]:
+        wound = Wound(description=description, intensity=0.5, source="user")
+        assert processor.process_wound(wound).id == classifier.classify(description)
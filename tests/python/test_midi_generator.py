@@ -1,4 +1,7 @@
 """Tests for MIDI generator."""
+import io
+
+import mido
 import pytest
 from kelly.core.midi_generator import MidiGenerator, GrooveTemplate
 
@@ -51,3 +54,17 @@ def test_create_midi_file():
     midi_file = generator.create_midi_file(progression, groove="straight")
     assert midi_file is not None
     assert len(midi_file.tracks) > 0
+
+
+def test_midi_bytes_round_trip():
+    """Test exported bytes parse back with one note-on per generated note."""
+    generator = MidiGenerator(tempo=100)
+    progression = generator.generate_chord_progression(mode="major", length=2)
+    data = generator.midi_bytes(progression, groove="swing")
+
+    midi_file = mido.MidiFile(file=io.BytesIO(data))
+    note_ons = [
+        message for track in midi_file.tracks for message in track
+        if message.type == "note_on" and message.velocity > 0
+    ]
+    assert len(note_ons) == len(generator.chord_notes(progression, groove="swing"))